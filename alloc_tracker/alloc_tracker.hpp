@@ -0,0 +1,520 @@
+/**
+ * @file alloc_tracker.hpp
+ * @author Richard Wang
+ * @brief 可选的堆分配跟踪：替换全局 operator new / delete，按线程统计次数和字节数
+ *  1. 启用方式
+ *      只在一个翻译单元里先 #define LEARNING_ALLOC_TRACKER_IMPLEMENTATION 再包含本头文件，
+ *      该文件就会定义替换用的全局 operator new / delete(测试和基准程序中使用，正式程序不包含即可)。
+ *      其它翻译单元直接包含头文件使用查询接口；没有安装替换函数时 installed() 为 false，统计值都是 0。
+ *  2. 统计
+ *      每个线程第一次分配时从一张静态槽位表中领取一个槽位，之后只改写自己的槽位(relaxed 原子变量，无争用)；
+ *      每块内存前面有 16 字节的头部记录大小，所以不带大小的 delete 也能统计释放的字节数。
+ *      记录器自身不做任何堆分配。
+ *  3. 作用域与断言
+ *      alloc_scope 记录构造时本线程的计数，delta() 给出之后的增量；
+ *      count_allocations(f) 返回 f 期间的分配情况；expect_no_allocations("hot path", f) 在 f 分配了内存时抛出 std::logic_error，
+ *      用于在测试中强制 "热路径不分配"。
+ *  4. 调用栈采样
+ *      set_sample_every(n) 后每个线程每 n 次分配记录一次调用栈(固定大小的环形缓冲区)，write_samples() 按调用栈汇总输出；
+ *      链接时加 -rdynamic 才能看到函数名。
+ *  5. alloc_probe 接入 benchmark_runner::add_probe()，报告中给出每次操作的 allocs / alloc_bytes。
+ *
+ *  #define LEARNING_ALLOC_TRACKER_IMPLEMENTATION
+ *  #include "alloc_tracker.hpp"
+ *  learning::alloc_stats s = learning::count_allocations([&]() { list.emplace_back(11, "Jim"); });
+ *  // s.allocations == 1 (链表节点)
+ * @version : 1.0
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c), Richard Wang.
+ *
+ */
+#ifndef ALLOC_TRACKER_HPP
+#define ALLOC_TRACKER_HPP
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <map>
+#include <new>
+#include <ostream>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+#if defined(__GLIBC__) || defined(__APPLE__)
+#include <execinfo.h>
+#define LEARNING_ALLOC_TRACKER_BACKTRACE 1
+#endif
+
+#include "../benchmark/benchmark.hpp"
+
+namespace learning
+{
+
+/**
+ * @brief 分配统计
+ */
+struct alloc_stats
+{
+    uint64_t allocations = 0;
+    uint64_t deallocations = 0;
+    uint64_t bytes_allocated = 0;
+    uint64_t bytes_freed = 0;
+
+    /* 仍未释放的字节数(只对同一线程分配、同一线程释放的场景有意义) */
+    int64_t live_bytes() const
+    {
+        return static_cast<int64_t>(bytes_allocated) - static_cast<int64_t>(bytes_freed);
+    }
+
+    alloc_stats operator-(const alloc_stats &other) const
+    {
+        alloc_stats d;
+        d.allocations = allocations - other.allocations;
+        d.deallocations = deallocations - other.deallocations;
+        d.bytes_allocated = bytes_allocated - other.bytes_allocated;
+        d.bytes_freed = bytes_freed - other.bytes_freed;
+        return d;
+    }
+
+    alloc_stats &operator+=(const alloc_stats &other)
+    {
+        allocations += other.allocations;
+        deallocations += other.deallocations;
+        bytes_allocated += other.bytes_allocated;
+        bytes_freed += other.bytes_freed;
+        return *this;
+    }
+};
+
+inline std::ostream &operator<<(std::ostream &os, const alloc_stats &s)
+{
+    return os << s.allocations << " allocs / " << s.bytes_allocated << " bytes, " << s.deallocations << " frees / " << s.bytes_freed << " bytes";
+}
+
+namespace detail
+{
+
+static const std::size_t kAllocSlots = 256;  // 超出的线程共用最后一个槽位
+static const std::size_t kAllocSamples = 256;
+static const int kAllocSampleDepth = 16;
+
+struct alignas(64) alloc_slot
+{
+    std::atomic<uint64_t> allocations;
+    std::atomic<uint64_t> deallocations;
+    std::atomic<uint64_t> bytes_allocated;
+    std::atomic<uint64_t> bytes_freed;
+};
+
+struct alloc_sample
+{
+    std::atomic<bool> ready;
+    std::size_t size;
+    int depth;
+    void *frames[kAllocSampleDepth];
+};
+
+/* 以下静态数据都是零初始化的平凡类型，在 operator new 中使用不会引发分配或初始化顺序问题 */
+inline alloc_slot *alloc_slots()
+{
+    static alloc_slot slots[kAllocSlots];
+    return slots;
+}
+
+inline std::atomic<std::size_t> &alloc_slots_used()
+{
+    static std::atomic<std::size_t> used;
+    return used;
+}
+
+inline std::atomic<bool> &alloc_hooks_installed()
+{
+    static std::atomic<bool> installed;
+    return installed;
+}
+
+inline std::atomic<uint32_t> &alloc_sample_every()
+{
+    static std::atomic<uint32_t> every;
+    return every;
+}
+
+inline alloc_sample *alloc_samples()
+{
+    static alloc_sample samples[kAllocSamples];
+    return samples;
+}
+
+inline std::atomic<std::size_t> &alloc_sample_cursor()
+{
+    static std::atomic<std::size_t> cursor;
+    return cursor;
+}
+
+inline alloc_slot &this_thread_slot()
+{
+    static thread_local alloc_slot *slot = nullptr;
+    if (slot == nullptr)
+    {
+        const std::size_t index = alloc_slots_used().fetch_add(1, std::memory_order_relaxed);
+        slot = &alloc_slots()[std::min(index, kAllocSlots - 1)];
+    }
+    return *slot;
+}
+
+/* 槽位只由所属线程写入时用 load + store，溢出槽位被多个线程共用时才需要 fetch_add */
+inline void bump(std::atomic<uint64_t> &counter, uint64_t delta, bool shared)
+{
+    if (shared)
+    {
+        counter.fetch_add(delta, std::memory_order_relaxed);
+    }
+    else
+    {
+        counter.store(counter.load(std::memory_order_relaxed) + delta, std::memory_order_relaxed);
+    }
+}
+
+inline void maybe_sample(std::size_t size)
+{
+#if defined(LEARNING_ALLOC_TRACKER_BACKTRACE)
+    const uint32_t every = alloc_sample_every().load(std::memory_order_relaxed);
+    if (every == 0)
+    {
+        return;
+    }
+    static thread_local uint32_t countdown = 0;
+    static thread_local bool sampling = false; // backtrace() 内部可能再次分配
+    if (sampling || ++countdown < every)
+    {
+        return;
+    }
+    countdown = 0;
+    sampling = true;
+    alloc_sample &s = alloc_samples()[alloc_sample_cursor().fetch_add(1, std::memory_order_relaxed) % kAllocSamples];
+    s.ready.store(false, std::memory_order_relaxed);
+    s.size = size;
+    s.depth = ::backtrace(s.frames, kAllocSampleDepth);
+    s.ready.store(true, std::memory_order_release);
+    sampling = false;
+#else
+    (void)size;
+#endif
+}
+
+inline void record_allocation(std::size_t size)
+{
+    alloc_slot &slot = this_thread_slot();
+    const bool shared = &slot == &alloc_slots()[kAllocSlots - 1];
+    bump(slot.allocations, 1, shared);
+    bump(slot.bytes_allocated, size, shared);
+    maybe_sample(size);
+}
+
+inline void record_deallocation(std::size_t size)
+{
+    alloc_slot &slot = this_thread_slot();
+    const bool shared = &slot == &alloc_slots()[kAllocSlots - 1];
+    bump(slot.deallocations, 1, shared);
+    bump(slot.bytes_freed, size, shared);
+}
+
+inline alloc_stats read_slot(const alloc_slot &slot)
+{
+    alloc_stats s;
+    s.allocations = slot.allocations.load(std::memory_order_relaxed);
+    s.deallocations = slot.deallocations.load(std::memory_order_relaxed);
+    s.bytes_allocated = slot.bytes_allocated.load(std::memory_order_relaxed);
+    s.bytes_freed = slot.bytes_freed.load(std::memory_order_relaxed);
+    return s;
+}
+
+/* 每块内存前的头部：用户大小与头部起点到用户指针的偏移 */
+static const std::size_t kAllocHeader = 16;
+
+inline void *tracked_allocate(std::size_t size, std::size_t alignment)
+{
+    const std::size_t offset = std::max(kAllocHeader, alignment);
+    /* size + offset 溢出时按分配失败处理，由 tracked_new 抛出 bad_alloc */
+    if (size > static_cast<std::size_t>(-1) - offset)
+    {
+        return nullptr;
+    }
+    void *base = nullptr;
+    if (alignment <= alignof(std::max_align_t))
+    {
+        base = std::malloc(size + offset);
+    }
+    else if (::posix_memalign(&base, alignment, size + offset) != 0)
+    {
+        base = nullptr;
+    }
+    if (base == nullptr)
+    {
+        return nullptr;
+    }
+    char *user = static_cast<char *>(base) + offset;
+    reinterpret_cast<std::size_t *>(user)[-1] = size;
+    reinterpret_cast<std::size_t *>(user)[-2] = offset;
+    record_allocation(size);
+    return user;
+}
+
+inline void tracked_free(void *p)
+{
+    if (p == nullptr)
+    {
+        return;
+    }
+    char *user = static_cast<char *>(p);
+    const std::size_t size = reinterpret_cast<std::size_t *>(user)[-1];
+    const std::size_t offset = reinterpret_cast<std::size_t *>(user)[-2];
+    record_deallocation(size);
+    std::free(user - offset);
+}
+
+inline void *tracked_new(std::size_t size, std::size_t alignment)
+{
+    for (;;)
+    {
+        if (void *p = tracked_allocate(size == 0 ? 1 : size, alignment))
+        {
+            return p;
+        }
+        std::new_handler handler = std::get_new_handler();
+        if (handler == nullptr)
+        {
+            throw std::bad_alloc();
+        }
+        handler();
+    }
+}
+
+} // namespace detail
+
+/**
+ * @brief 查询与采样控制
+ */
+struct alloc_tracker
+{
+    /* 是否有翻译单元安装了替换的 operator new / delete */
+    static bool installed()
+    {
+        return detail::alloc_hooks_installed().load(std::memory_order_relaxed);
+    }
+
+    /* 当前线程的累计值 */
+    static alloc_stats thread_stats()
+    {
+        return detail::read_slot(detail::this_thread_slot());
+    }
+
+    /* 所有线程(包括已经退出的线程)的累计值之和 */
+    static alloc_stats global_stats()
+    {
+        alloc_stats total;
+        const std::size_t used = std::min(detail::alloc_slots_used().load(std::memory_order_relaxed), detail::kAllocSlots);
+        for (std::size_t i = 0; i < used; ++i)
+        {
+            total += detail::read_slot(detail::alloc_slots()[i]);
+        }
+        return total;
+    }
+
+    /* 每个线程每 n 次分配采样一次调用栈；0 表示关闭 */
+    static void set_sample_every(uint32_t n)
+    {
+        detail::alloc_sample_every().store(n, std::memory_order_relaxed);
+    }
+
+    static void clear_samples()
+    {
+        for (std::size_t i = 0; i < detail::kAllocSamples; ++i)
+        {
+            detail::alloc_samples()[i].ready.store(false, std::memory_order_relaxed);
+        }
+    }
+
+    /* 按调用栈汇总采样结果，输出次数最多的 max_stacks 个；开头属于记录器和 operator new 的栈帧不输出 */
+    static void write_samples(std::ostream &os, std::size_t max_stacks = 5)
+    {
+#if defined(LEARNING_ALLOC_TRACKER_BACKTRACE)
+        struct stack_summary
+        {
+            std::size_t count = 0;
+            std::size_t bytes = 0;
+        };
+        std::map<std::vector<void *>, stack_summary> stacks;
+        for (std::size_t i = 0; i < detail::kAllocSamples; ++i)
+        {
+            const detail::alloc_sample &s = detail::alloc_samples()[i];
+            if (!s.ready.load(std::memory_order_acquire))
+            {
+                continue;
+            }
+            stack_summary &summary = stacks[std::vector<void *>(s.frames, s.frames + s.depth)];
+            ++summary.count;
+            summary.bytes += s.size;
+        }
+
+        std::vector<std::pair<std::vector<void *>, stack_summary>> sorted(stacks.begin(), stacks.end());
+        std::sort(sorted.begin(), sorted.end(), [](const std::pair<std::vector<void *>, stack_summary> &a,
+                                                   const std::pair<std::vector<void *>, stack_summary> &b)
+                  { return a.second.count > b.second.count; });
+        for (std::size_t i = 0; i < sorted.size() && i < max_stacks; ++i)
+        {
+            const std::vector<void *> &frames = sorted[i].first;
+            os << "#" << i << ": " << sorted[i].second.count << " samples, " << sorted[i].second.bytes << " bytes" << std::endl;
+            char **symbols = ::backtrace_symbols(frames.data(), static_cast<int>(frames.size()));
+            std::size_t first = 0;
+            while (symbols != nullptr && first + 1 < frames.size() && is_tracker_frame(symbols[first]))
+            {
+                ++first;
+            }
+            for (std::size_t f = first; f < frames.size(); ++f)
+            {
+                os << "    " << (symbols != nullptr ? symbols[f] : "?") << std::endl;
+            }
+            std::free(symbols);
+        }
+#else
+        (void)max_stacks;
+        os << "stack sampling is not supported on this platform" << std::endl;
+#endif
+    }
+
+private:
+    /* 记录器内部函数(learning::detail)与 operator new(_Znwm / _Znam) 的栈帧 */
+    static bool is_tracker_frame(const std::string &symbol)
+    {
+        return symbol.find("learning6detail") != std::string::npos || symbol.find("_Znwm") != std::string::npos ||
+               symbol.find("_Znam") != std::string::npos || symbol.find("_Znwj") != std::string::npos;
+    }
+};
+
+/**
+ * @brief 当前线程在作用域内的分配增量
+ */
+class alloc_scope
+{
+public:
+    alloc_scope() : start_(alloc_tracker::thread_stats()) {}
+
+    alloc_stats delta() const
+    {
+        return alloc_tracker::thread_stats() - start_;
+    }
+
+private:
+    alloc_stats start_;
+};
+
+/**
+ * @brief 执行 f，返回当前线程在 f 期间的分配情况
+ */
+template <class F>
+alloc_stats count_allocations(F &&f)
+{
+    alloc_scope scope;
+    f();
+    return scope.delta();
+}
+
+/**
+ * @brief 要求 f 不做任何堆分配，否则抛出 std::logic_error；跟踪器未安装时同样抛出，避免测试悄悄失效
+ */
+template <class F>
+void expect_no_allocations(const std::string &what, F &&f)
+{
+    if (!alloc_tracker::installed())
+    {
+        throw std::logic_error("expect_no_allocations: alloc tracker is not installed (define LEARNING_ALLOC_TRACKER_IMPLEMENTATION in one file)");
+    }
+    const alloc_stats s = count_allocations(std::forward<F>(f));
+    if (s.allocations != 0)
+    {
+        throw std::logic_error(what + ": expected no allocations, got " + std::to_string(s.allocations) + " (" +
+                               std::to_string(s.bytes_allocated) + " bytes)");
+    }
+}
+
+/**
+ * @brief benchmark_runner 的采样扩展：统计计时期间当前线程的分配
+ */
+class alloc_probe : public benchmark_probe
+{
+public:
+    void start() override
+    {
+        begin_ = alloc_tracker::thread_stats();
+    }
+
+    void stop() override
+    {
+        total_ += alloc_tracker::thread_stats() - begin_;
+    }
+
+    void collect(std::map<std::string, double> &counters) override
+    {
+        counters["allocs"] += static_cast<double>(total_.allocations);
+        counters["alloc_bytes"] += static_cast<double>(total_.bytes_allocated);
+        total_ = alloc_stats();
+    }
+
+private:
+    alloc_stats begin_;
+    alloc_stats total_;
+};
+
+} // namespace learning
+
+#if defined(LEARNING_ALLOC_TRACKER_IMPLEMENTATION)
+
+namespace learning
+{
+namespace detail
+{
+static const bool alloc_hooks_registered = (alloc_hooks_installed().store(true), true);
+} // namespace detail
+} // namespace learning
+
+/* 数组版本与 nothrow 版本的默认实现都会转调下面这些函数 */
+void *operator new(std::size_t size)
+{
+    return learning::detail::tracked_new(size, alignof(std::max_align_t));
+}
+
+void operator delete(void *p) noexcept
+{
+    learning::detail::tracked_free(p);
+}
+
+void operator delete(void *p, std::size_t) noexcept
+{
+    learning::detail::tracked_free(p);
+}
+
+#if defined(__cpp_aligned_new)
+void *operator new(std::size_t size, std::align_val_t alignment)
+{
+    return learning::detail::tracked_new(size, static_cast<std::size_t>(alignment));
+}
+
+void operator delete(void *p, std::align_val_t) noexcept
+{
+    learning::detail::tracked_free(p);
+}
+
+void operator delete(void *p, std::size_t, std::align_val_t) noexcept
+{
+    learning::detail::tracked_free(p);
+}
+#endif
+
+#endif // LEARNING_ALLOC_TRACKER_IMPLEMENTATION
+
+#endif // ALLOC_TRACKER_HPP
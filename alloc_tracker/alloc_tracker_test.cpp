@@ -0,0 +1,238 @@
+/**
+ * @file alloc_tracker_test.cpp
+ * @author Richard Wang
+ * @brief 分配跟踪示例
+ *  1. 各种写法的分配成本：std::make_pair(11, "Jim")、短 / 长字符串、std::list 节点、捕获大小不同的 std::function；
+ *  2. 多个线程分别分配，按线程与全局统计；
+ *  3. expect_no_allocations 检查 for_each 热路径不分配，违反时给出异常信息；
+ *  4. 调用栈采样：找出 list 插入中分配最多的调用栈；
+ *  5. 基准报告每次操作的分配次数(alloc_probe)。
+ *
+ * 编译: g++ -std=c++14 -O2 -pthread -rdynamic alloc_tracker_test.cpp -o alloc_tracker_test
+ * @version : 1.0
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c), Richard Wang.
+ *
+ */
+
+#define LEARNING_ALLOC_TRACKER_IMPLEMENTATION
+
+#include <iostream>
+#include <algorithm>
+#include <functional>
+#include <list>
+#include <string>
+#include <thread>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#include "alloc_tracker.hpp"
+
+typedef std::tuple<int, std::string, int> user_t; // (年龄, 姓名, 身高)
+
+/**
+ * @brief 常见写法的分配成本
+ */
+void cost_test()
+{
+    std::cout << "------------- test allocation cost ------------------" << std::endl;
+    std::list<std::pair<int, std::string>> info_list;
+    const char *long_name = "Jim Morrison-Whitaker the Third";
+
+    std::cout << "installed: " << std::boolalpha << learning::alloc_tracker::installed() << std::endl;
+    std::cout << "std::make_pair(11, \"Jim\")              : " << learning::count_allocations([]()
+                                                                                           {
+                                                                                               auto p = std::make_pair(11, "Jim");
+                                                                                               learning::do_not_optimize(p);
+                                                                                           })
+              << std::endl;
+    std::cout << "pair<int, string>(11, \"Jim\")           : " << learning::count_allocations([]()
+                                                                                           {
+                                                                                               std::pair<int, std::string> p(11, "Jim");
+                                                                                               learning::do_not_optimize(p);
+                                                                                           })
+              << std::endl;
+    std::cout << "pair<int, string>(11, long name)       : " << learning::count_allocations([long_name]()
+                                                                                           {
+                                                                                               std::pair<int, std::string> p(11, long_name);
+                                                                                               learning::do_not_optimize(p);
+                                                                                           })
+              << std::endl;
+    std::cout << "list.emplace_back(11, \"Jim\")           : " << learning::count_allocations([&info_list]()
+                                                                                           { info_list.emplace_back(11, "Jim"); })
+              << std::endl;
+
+    int small_capture = 1;
+    std::string a(40, 'a'), b(40, 'b');
+    std::cout << "std::function, captures one int       : " << learning::count_allocations([small_capture]()
+                                                                                           {
+                                                                                               std::function<int()> f = [small_capture]()
+                                                                                               { return small_capture; };
+                                                                                               learning::do_not_optimize(f);
+                                                                                           })
+              << std::endl;
+    std::cout << "std::function, captures two strings   : " << learning::count_allocations([&a, &b]()
+                                                                                           {
+                                                                                               std::function<std::size_t()> f = [a, b]()
+                                                                                               { return a.size() + b.size(); };
+                                                                                               learning::do_not_optimize(f);
+                                                                                           })
+              << std::endl;
+}
+
+/**
+ * @brief 按线程统计
+ */
+void thread_test()
+{
+    std::cout << "------------- test per thread ------------------" << std::endl;
+    const learning::alloc_stats before = learning::alloc_tracker::global_stats();
+    std::vector<learning::alloc_stats> per_thread(4);
+    std::vector<std::thread> workers;
+    for (int t = 0; t < 4; ++t)
+    {
+        workers.emplace_back([t, &per_thread]()
+                             {
+                                 learning::alloc_scope scope;
+                                 std::list<user_t> users;
+                                 for (int i = 0; i < (t + 1) * 1000; ++i)
+                                 {
+                                     users.emplace_back(i % 60, "Richard", 178);
+                                 }
+                                 per_thread[t] = scope.delta();
+                             });
+    }
+    for (std::thread &w : workers)
+    {
+        w.join();
+    }
+    for (int t = 0; t < 4; ++t)
+    {
+        std::cout << "thread " << t << ": " << per_thread[t] << std::endl;
+    }
+    std::cout << "global delta: " << learning::alloc_tracker::global_stats() - before << std::endl;
+}
+
+/**
+ * @brief 热路径断言
+ */
+void hot_path_test()
+{
+    std::cout << "------------- test expect_no_allocations ------------------" << std::endl;
+    std::vector<user_t> users;
+    for (int i = 0; i < 1000; ++i)
+    {
+        users.emplace_back(i % 60, "Richard", 178);
+    }
+
+    long long ages = 0;
+    learning::expect_no_allocations("for_each sum", [&]()
+                                    { for_each(users.begin(), users.end(), [&ages](const user_t &u)
+                                               { ages += std::get<0>(u); }); });
+    std::cout << "for_each sum: no allocations (sum " << ages << ")" << std::endl;
+
+    try
+    {
+        learning::expect_no_allocations("for_each with tie copy", [&]()
+                                        { for_each(users.begin(), users.end(), [&ages](const user_t &u)
+                                                   {
+                                                       int age, height;
+                                                       std::string name;
+                                                       std::tie(age, name, height) = u;
+                                                       name += " (copied into a long buffer)";
+                                                       ages += age;
+                                                   }); });
+    }
+    catch (const std::logic_error &e)
+    {
+        std::cout << "caught: " << e.what() << std::endl;
+    }
+}
+
+/**
+ * @brief 调用栈采样
+ */
+void sampling_test()
+{
+    std::cout << "------------- test stack sampling ------------------" << std::endl;
+    learning::alloc_tracker::clear_samples();
+    learning::alloc_tracker::set_sample_every(16);
+    std::list<user_t> users;
+    std::vector<std::string> names;
+    for (int i = 0; i < 2000; ++i)
+    {
+        users.emplace_back(i % 60, "Richard", 178);
+        if (i % 4 == 0)
+        {
+            names.push_back(std::string(32, 'x'));
+        }
+    }
+    learning::alloc_tracker::set_sample_every(0);
+    learning::alloc_tracker::write_samples(std::cout, 2);
+}
+
+/**
+ * @brief 基准中的每次操作分配数
+ */
+void benchmark_test()
+{
+    std::cout << "------------- test alloc_probe ------------------" << std::endl;
+    learning::benchmark_options options;
+    options.max_time_ms = 300;
+    learning::benchmark_runner runner(options);
+    learning::alloc_probe probe;
+    runner.add_probe(probe);
+    runner.add("build/vector<tuple>/reserve", [](learning::benchmark_state &state)
+               {
+                   while (state.keep_running())
+                   {
+                       std::vector<user_t> users;
+                       users.reserve(100);
+                       for (int i = 0; i < 100; ++i)
+                       {
+                           users.emplace_back(i % 60, "Richard", 178);
+                       }
+                       learning::do_not_optimize(users);
+                   }
+               });
+    runner.add("build/list<tuple>", [](learning::benchmark_state &state)
+               {
+                   while (state.keep_running())
+                   {
+                       std::list<user_t> users;
+                       for (int i = 0; i < 100; ++i)
+                       {
+                           users.emplace_back(i % 60, "Richard", 178);
+                       }
+                       learning::do_not_optimize(users);
+                   }
+               });
+    runner.run(std::cout);
+}
+
+int main()
+{
+    /*********************** cost_test() ************/
+    cost_test();
+    /************************************************/
+
+    /********************* thread_test() ************/
+    thread_test();
+    /************************************************/
+
+    /******************* hot_path_test() ************/
+    hot_path_test();
+    /************************************************/
+
+    /******************* sampling_test() ************/
+    sampling_test();
+    /************************************************/
+
+    /****************** benchmark_test() ************/
+    benchmark_test();
+    /************************************************/
+
+    return 0;
+}
@@ -0,0 +1,106 @@
+/**
+ * @file bench_compare.cpp
+ * @author Richard Wang
+ * @brief 回归比较工具：读取两份 benchmark --json 写出的结果，统计检验后报告变化
+ *  存在显著且超过阈值的变慢时退出码为 1，可以直接放进 CI；参数错误或文件无法读取时退出码为 2。
+ *
+ * 编译: g++ -std=c++14 -O2 bench_compare.cpp -o bench_compare
+ * 用法: bench_compare old.json new.json [--threshold=0.05] [--alpha=0.01] [--method=mann-whitney|bootstrap]
+ *  例如: benchmark_test --json=old.json; (修改代码后) benchmark_test --json=new.json; bench_compare old.json new.json
+ * @version : 1.0
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c), Richard Wang.
+ *
+ */
+
+#include <iostream>
+#include <cstdlib>
+#include <exception>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include "compare.hpp"
+
+static std::vector<learning::benchmark_result> load(const std::string &path)
+{
+    std::ifstream in(path.c_str());
+    if (!in)
+    {
+        throw std::runtime_error("cannot open " + path);
+    }
+    return learning::read_benchmark_json(in);
+}
+
+static double to_fraction(const std::string &key, const std::string &value)
+{
+    char *end = nullptr;
+    const double v = std::strtod(value.c_str(), &end);
+    if (value.empty() || *end != '\0' || v < 0 || v >= 1)
+    {
+        throw std::invalid_argument("bad value for " + key + ": '" + value + "' (expected a fraction in [0, 1))");
+    }
+    return v;
+}
+
+int main(int argc, char *argv[])
+{
+    std::vector<std::string> files;
+    learning::compare_options options;
+    try
+    {
+        for (int i = 1; i < argc; ++i)
+        {
+            const std::string arg = argv[i];
+            const std::string::size_type eq = arg.find('=');
+            const std::string key = arg.substr(0, eq);
+            const std::string value = eq == std::string::npos ? std::string() : arg.substr(eq + 1);
+            if (key == "--threshold")
+            {
+                options.threshold = to_fraction(key, value);
+            }
+            else if (key == "--alpha")
+            {
+                options.alpha = to_fraction(key, value);
+            }
+            else if (key == "--method" && (value == "mann-whitney" || value == "bootstrap"))
+            {
+                options.method = value == "bootstrap" ? learning::compare_method::bootstrap : learning::compare_method::mann_whitney;
+            }
+            else if (arg.compare(0, 2, "--") != 0)
+            {
+                files.push_back(arg);
+            }
+            else
+            {
+                throw std::invalid_argument("unknown option " + arg);
+            }
+        }
+        if (files.size() != 2)
+        {
+            throw std::invalid_argument("expected exactly two result files");
+        }
+    }
+    catch (const std::exception &e)
+    {
+        std::cerr << "error: " << e.what() << "\nusage: " << argv[0]
+                  << " old.json new.json [--threshold=0.05] [--alpha=0.01] [--method=mann-whitney|bootstrap]" << std::endl;
+        return 2;
+    }
+
+    try
+    {
+        const std::vector<learning::benchmark_comparison> comparisons =
+            learning::compare_benchmarks(load(files[0]), load(files[1]), options);
+        learning::write_comparison(comparisons, std::cout);
+        const std::size_t regressions = learning::count_regressions(comparisons);
+        std::cout << regressions << " regression(s) above " << options.threshold * 100 << "% at alpha " << options.alpha << std::endl;
+        return regressions > 0 ? 1 : 0;
+    }
+    catch (const std::exception &e)
+    {
+        std::cerr << "error: " << e.what() << std::endl;
+        return 2;
+    }
+}
@@ -0,0 +1,872 @@
+/**
+ * @file benchmark.hpp
+ * @author Richard Wang
+ * @brief 微基准测试框架
+ *  1. 测量方式
+ *      每个基准是一个 void(benchmark_state &) 函数，在 while (state.keep_running()) 循环里执行一次被测操作；
+ *      不想计时的准备工作(例如每次排序前复制一份乱序数据)放在 pause_timing() / resume_timing() 之间。
+ *      框架先自动确定每个样本的迭代次数，使单个样本至少耗时 sample_ms，然后预热 warmup_ms。
+ *  2. 稳定性
+ *      反复采样，直到 MAD(中位数绝对偏差) / 中位数 不超过 max_rel_mad，或者样本数、总耗时达到上限；
+ *      报告中位数和 MAD 而不是均值和标准差，偶尔被调度打断的样本不会拉偏结果。
+ *  3. 输出
+ *      run() 打印一张表；设置了 json_path 时同时写出 JSON，其中保留全部原始样本，供回归比较工具使用。
+ *      read_benchmark_json() 可以把写出的文件读回来。
+ *  4. 扩展
+ *      add_probe() 注册 benchmark_probe(例如 perf_counters/perf_counters.hpp 中的 perf_probe)，
+ *      它只在计时期间工作，结果作为每次操作的计数出现在报告中。
+ *
+ *  learning::benchmark_runner runner(learning::benchmark_options::parse(argc, argv));
+ *  runner.add("sort/lambda", [](learning::benchmark_state &state)
+ *  {
+ *      while (state.keep_running())
+ *      {
+ *          state.pause_timing();
+ *          std::vector<int> v = input;
+ *          state.resume_timing();
+ *          std::sort(v.begin(), v.end(), [](int a, int b) { return a < b; });
+ *          learning::do_not_optimize(v.data());
+ *      }
+ *  });
+ *  runner.run(std::cout);
+ * @version : 1.0
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c), Richard Wang.
+ *
+ */
+#ifndef BENCHMARK_HPP
+#define BENCHMARK_HPP
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <istream>
+#include <map>
+#include <ostream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace learning
+{
+
+/**
+ * @brief 阻止编译器把 value 的计算当作无用代码删掉
+ */
+template <class T>
+inline void do_not_optimize(const T &value)
+{
+#if defined(__GNUC__)
+    asm volatile(""
+                 :
+                 : "r,m"(value)
+                 : "memory");
+#else
+    static volatile const void *sink;
+    sink = &value;
+#endif
+}
+
+/**
+ * @brief 让编译器认为所有内存都可能被读写
+ */
+inline void clobber_memory()
+{
+#if defined(__GNUC__)
+    asm volatile(""
+                 :
+                 :
+                 : "memory");
+#else
+    std::atomic_signal_fence(std::memory_order_acq_rel);
+#endif
+}
+
+/**
+ * @brief 中位数；values 为空时返回 0
+ */
+inline double sample_median(std::vector<double> values)
+{
+    if (values.empty())
+    {
+        return 0.0;
+    }
+    const std::size_t mid = values.size() / 2;
+    std::nth_element(values.begin(), values.begin() + mid, values.end());
+    const double upper = values[mid];
+    if (values.size() % 2 == 1)
+    {
+        return upper;
+    }
+    return (upper + *std::max_element(values.begin(), values.begin() + mid)) / 2.0;
+}
+
+/**
+ * @brief 中位数绝对偏差 median(|x - median(x)|)，未乘正态一致性系数 1.4826
+ */
+inline double sample_mad(const std::vector<double> &values)
+{
+    const double m = sample_median(values);
+    std::vector<double> deviations;
+    deviations.reserve(values.size());
+    for (double v : values)
+    {
+        deviations.push_back(std::fabs(v - m));
+    }
+    return sample_median(std::move(deviations));
+}
+
+/**
+ * @brief 运行参数；parse() 从命令行读取 --name=value 形式的参数
+ */
+struct benchmark_options
+{
+    double warmup_ms = 50;       // 正式采样前的预热时间
+    double sample_ms = 5;        // 单个样本的最短耗时
+    std::size_t min_samples = 10; // 判断稳定之前至少采集的样本数
+    std::size_t max_samples = 100;
+    double max_rel_mad = 0.02;   // MAD / 中位数 不超过该值即认为稳定
+    double max_time_ms = 3000;   // 单个基准采样的总时间上限
+    std::string filter;          // 只运行名字包含该子串的基准
+    std::string json_path;       // 非空时写出 JSON 结果
+
+    static benchmark_options parse(int argc, char *argv[])
+    {
+        benchmark_options options;
+        for (int i = 1; i < argc; ++i)
+        {
+            const std::string arg = argv[i];
+            const std::string::size_type eq = arg.find('=');
+            const std::string key = arg.substr(0, eq);
+            const std::string value = eq == std::string::npos ? std::string() : arg.substr(eq + 1);
+            if (key == "--warmup-ms")
+            {
+                options.warmup_ms = to_number(key, value);
+            }
+            else if (key == "--sample-ms")
+            {
+                options.sample_ms = to_number(key, value);
+            }
+            else if (key == "--min-samples")
+            {
+                options.min_samples = static_cast<std::size_t>(to_number(key, value));
+            }
+            else if (key == "--max-samples")
+            {
+                options.max_samples = static_cast<std::size_t>(to_number(key, value));
+            }
+            else if (key == "--max-rel-mad")
+            {
+                options.max_rel_mad = to_number(key, value);
+            }
+            else if (key == "--max-time-ms")
+            {
+                options.max_time_ms = to_number(key, value);
+            }
+            else if (key == "--filter")
+            {
+                options.filter = value;
+            }
+            else if (key == "--json")
+            {
+                options.json_path = value;
+            }
+            else
+            {
+                throw std::invalid_argument("benchmark: unknown option " + arg +
+                                            " (known: --warmup-ms --sample-ms --min-samples --max-samples"
+                                            " --max-rel-mad --max-time-ms --filter --json)");
+            }
+        }
+        if (options.min_samples == 0 || options.max_samples < options.min_samples)
+        {
+            throw std::invalid_argument("benchmark: need 0 < min-samples <= max-samples");
+        }
+        return options;
+    }
+
+private:
+    static double to_number(const std::string &key, const std::string &value)
+    {
+        char *end = nullptr;
+        const double v = std::strtod(value.c_str(), &end);
+        if (value.empty() || *end != '\0' || v < 0)
+        {
+            throw std::invalid_argument("benchmark: bad value for " + key + ": '" + value + "'");
+        }
+        return v;
+    }
+};
+
+struct benchmark_result;
+
+/**
+ * @brief 采样扩展点(例如硬件计数器)：只在计时期间工作，每个样本结束时交出自己的计数
+ */
+class benchmark_probe
+{
+public:
+    virtual ~benchmark_probe() {}
+
+    /* resume_timing() / pause_timing() 时调用 */
+    virtual void start() = 0;
+    virtual void stop() = 0;
+
+    /* 样本结束时把本样本的累计值加到 counters 中并清零 */
+    virtual void collect(std::map<std::string, double> &counters) = 0;
+
+    /* 汇总结束后可以追加派生指标(counters 已是每次操作的平均值) */
+    virtual void finish(benchmark_result &) {}
+};
+
+/**
+ * @brief 单个样本的执行状态
+ */
+class benchmark_state
+{
+public:
+    typedef std::chrono::steady_clock clock;
+
+    explicit benchmark_state(std::size_t iterations, const std::vector<benchmark_probe *> *probes = nullptr)
+        : iterations_(iterations), remaining_(iterations), started_(false), running_(false), elapsed_(0), probes_(probes) {}
+
+    /* 第一次调用时开始计时，执行完 iterations() 次后停止计时并返回 false */
+    bool keep_running()
+    {
+        if (!started_)
+        {
+            started_ = true;
+            resume_timing();
+        }
+        if (remaining_ == 0)
+        {
+            pause_timing();
+            return false;
+        }
+        --remaining_;
+        return true;
+    }
+
+    void pause_timing()
+    {
+        if (running_)
+        {
+            elapsed_ += clock::now() - start_;
+            running_ = false;
+            if (probes_ != nullptr)
+            {
+                for (benchmark_probe *probe : *probes_)
+                {
+                    probe->stop();
+                }
+            }
+        }
+    }
+
+    void resume_timing()
+    {
+        if (!running_)
+        {
+            running_ = true;
+            if (probes_ != nullptr)
+            {
+                for (benchmark_probe *probe : *probes_)
+                {
+                    probe->start();
+                }
+            }
+            start_ = clock::now();
+        }
+    }
+
+    std::size_t iterations() const
+    {
+        return iterations_;
+    }
+
+    /* 累加一个自定义计数(例如处理的记录数)，报告中按每次操作的平均值给出 */
+    void add_counter(const std::string &name, double value)
+    {
+        counters_[name] += value;
+    }
+
+    double elapsed_ns() const
+    {
+        return std::chrono::duration<double, std::nano>(elapsed_).count();
+    }
+
+    const std::map<std::string, double> &counters() const
+    {
+        return counters_;
+    }
+
+private:
+    std::size_t iterations_;
+    std::size_t remaining_;
+    bool started_;
+    bool running_;
+    clock::time_point start_;
+    clock::duration elapsed_;
+    const std::vector<benchmark_probe *> *probes_;
+    std::map<std::string, double> counters_;
+};
+
+/**
+ * @brief 单个基准的结果；时间单位均为每次操作的纳秒数
+ */
+struct benchmark_result
+{
+    std::string name;
+    std::size_t iterations = 0;        // 每个样本的迭代次数
+    std::vector<double> samples_ns;    // 原始样本
+    double median_ns = 0;
+    double mad_ns = 0;
+    double min_ns = 0;
+    double mean_ns = 0;
+    bool stable = false;
+    std::map<std::string, double> counters; // 每次操作的平均值
+
+    double rel_mad() const
+    {
+        return median_ns > 0 ? mad_ns / median_ns : 0.0;
+    }
+
+    /* 由 samples_ns 重新计算汇总值 */
+    void summarize()
+    {
+        median_ns = sample_median(samples_ns);
+        mad_ns = sample_mad(samples_ns);
+        min_ns = samples_ns.empty() ? 0.0 : *std::min_element(samples_ns.begin(), samples_ns.end());
+        double sum = 0;
+        for (double s : samples_ns)
+        {
+            sum += s;
+        }
+        mean_ns = samples_ns.empty() ? 0.0 : sum / static_cast<double>(samples_ns.size());
+    }
+};
+
+namespace detail
+{
+
+/* JSON 字符串转义(trace.hpp 有自己的版本，名字不同以免两个头文件一起包含时重复定义) */
+inline void write_bench_json_string(std::ostream &out, const std::string &s)
+{
+    out << '"';
+    for (char c : s)
+    {
+        if (c == '"' || c == '\\')
+        {
+            out << '\\' << c;
+        }
+        else if (static_cast<unsigned char>(c) < 0x20)
+        {
+            static const char hex[] = "0123456789abcdef";
+            out << "\\u00" << hex[(c >> 4) & 0xf] << hex[c & 0xf];
+        }
+        else
+        {
+            out << c;
+        }
+    }
+    out << '"';
+}
+
+/**
+ * @brief 只支持 write_benchmark_json() 用到的 JSON 子集：对象、数组、字符串、数字、true/false/null
+ */
+struct json_value
+{
+    enum kind_t
+    {
+        null_value,
+        bool_value,
+        number_value,
+        string_value,
+        array_value,
+        object_value
+    };
+
+    kind_t kind = null_value;
+    bool boolean = false;
+    double number = 0;
+    std::string text;
+    std::vector<json_value> items;
+    std::vector<std::pair<std::string, json_value>> members;
+
+    const json_value *find(const std::string &key) const
+    {
+        for (const std::pair<std::string, json_value> &m : members)
+        {
+            if (m.first == key)
+            {
+                return &m.second;
+            }
+        }
+        return nullptr;
+    }
+};
+
+class json_parser
+{
+public:
+    explicit json_parser(const std::string &text) : text_(text), pos_(0) {}
+
+    json_value parse()
+    {
+        json_value v = value();
+        skip_space();
+        if (pos_ != text_.size())
+        {
+            fail("trailing characters");
+        }
+        return v;
+    }
+
+private:
+    void fail(const std::string &what) const
+    {
+        throw std::runtime_error("benchmark json: " + what + " at offset " + std::to_string(pos_));
+    }
+
+    void skip_space()
+    {
+        while (pos_ < text_.size() && (text_[pos_] == ' ' || text_[pos_] == '\n' || text_[pos_] == '\r' || text_[pos_] == '\t'))
+        {
+            ++pos_;
+        }
+    }
+
+    bool consume(char c)
+    {
+        skip_space();
+        if (pos_ < text_.size() && text_[pos_] == c)
+        {
+            ++pos_;
+            return true;
+        }
+        return false;
+    }
+
+    void expect(char c)
+    {
+        if (!consume(c))
+        {
+            fail(std::string("expected '") + c + "'");
+        }
+    }
+
+    bool literal(const char *word)
+    {
+        const std::size_t len = std::char_traits<char>::length(word);
+        if (text_.compare(pos_, len, word) == 0)
+        {
+            pos_ += len;
+            return true;
+        }
+        return false;
+    }
+
+    json_value value()
+    {
+        skip_space();
+        json_value v;
+        if (pos_ >= text_.size())
+        {
+            fail("unexpected end");
+        }
+        const char c = text_[pos_];
+        if (c == '{')
+        {
+            ++pos_;
+            v.kind = json_value::object_value;
+            if (!consume('}'))
+            {
+                do
+                {
+                    skip_space();
+                    std::string key = string();
+                    expect(':');
+                    v.members.emplace_back(std::move(key), value());
+                } while (consume(','));
+                expect('}');
+            }
+        }
+        else if (c == '[')
+        {
+            ++pos_;
+            v.kind = json_value::array_value;
+            if (!consume(']'))
+            {
+                do
+                {
+                    v.items.push_back(value());
+                } while (consume(','));
+                expect(']');
+            }
+        }
+        else if (c == '"')
+        {
+            v.kind = json_value::string_value;
+            v.text = string();
+        }
+        else if (literal("true"))
+        {
+            v.kind = json_value::bool_value;
+            v.boolean = true;
+        }
+        else if (literal("false"))
+        {
+            v.kind = json_value::bool_value;
+        }
+        else if (literal("null"))
+        {
+            v.kind = json_value::null_value;
+        }
+        else
+        {
+            const char *begin = text_.c_str() + pos_;
+            char *end = nullptr;
+            v.number = std::strtod(begin, &end);
+            if (end == begin)
+            {
+                fail("unexpected character");
+            }
+            v.kind = json_value::number_value;
+            pos_ += static_cast<std::size_t>(end - begin);
+        }
+        return v;
+    }
+
+    std::string string()
+    {
+        if (pos_ >= text_.size() || text_[pos_] != '"')
+        {
+            fail("expected string");
+        }
+        ++pos_;
+        std::string out;
+        while (pos_ < text_.size() && text_[pos_] != '"')
+        {
+            char c = text_[pos_++];
+            if (c == '\\')
+            {
+                if (pos_ >= text_.size())
+                {
+                    break;
+                }
+                c = text_[pos_++];
+                if (c == 'n')
+                {
+                    c = '\n';
+                }
+                else if (c == 't')
+                {
+                    c = '\t';
+                }
+                else if (c == 'u')
+                {
+                    if (pos_ + 4 > text_.size())
+                    {
+                        fail("bad escape");
+                    }
+                    c = static_cast<char>(std::strtol(text_.substr(pos_, 4).c_str(), nullptr, 16));
+                    pos_ += 4;
+                }
+            }
+            out += c;
+        }
+        if (pos_ >= text_.size())
+        {
+            fail("unterminated string");
+        }
+        ++pos_;
+        return out;
+    }
+
+    const std::string &text_;
+    std::size_t pos_;
+};
+
+} // namespace detail
+
+/**
+ * @brief 写出 JSON 结果，包含全部原始样本
+ */
+inline void write_benchmark_json(const std::vector<benchmark_result> &results, std::ostream &out)
+{
+    const std::streamsize old_precision = out.precision(10);
+    out << "{\n  \"context\": {\"hardware_concurrency\": " << std::thread::hardware_concurrency();
+#if defined(__VERSION__)
+    out << ", \"compiler\": ";
+    detail::write_bench_json_string(out, __VERSION__);
+#endif
+    out << ", \"optimized\": "
+#if defined(__OPTIMIZE__)
+        << "true"
+#else
+        << "false"
+#endif
+        << "},\n  \"benchmarks\": [";
+    for (std::size_t i = 0; i < results.size(); ++i)
+    {
+        const benchmark_result &r = results[i];
+        out << (i == 0 ? "\n" : ",\n") << "    {\"name\": ";
+        detail::write_bench_json_string(out, r.name);
+        out << ", \"iterations\": " << r.iterations << ", \"median_ns\": " << r.median_ns << ", \"mad_ns\": " << r.mad_ns
+            << ", \"min_ns\": " << r.min_ns << ", \"mean_ns\": " << r.mean_ns << ", \"stable\": " << (r.stable ? "true" : "false")
+            << ",\n     \"counters\": {";
+        bool first = true;
+        for (const std::pair<const std::string, double> &c : r.counters)
+        {
+            out << (first ? "" : ", ");
+            detail::write_bench_json_string(out, c.first);
+            out << ": " << c.second;
+            first = false;
+        }
+        out << "},\n     \"samples_ns\": [";
+        for (std::size_t s = 0; s < r.samples_ns.size(); ++s)
+        {
+            out << (s == 0 ? "" : ", ") << r.samples_ns[s];
+        }
+        out << "]}";
+    }
+    out << "\n  ]\n}\n";
+    out.precision(old_precision);
+}
+
+/**
+ * @brief 读回 write_benchmark_json() 写出的结果；汇总值按原始样本重新计算
+ */
+inline std::vector<benchmark_result> read_benchmark_json(std::istream &in)
+{
+    std::ostringstream buffer;
+    buffer << in.rdbuf();
+    const std::string text = buffer.str();
+    const detail::json_value root = detail::json_parser(text).parse();
+    const detail::json_value *list = root.find("benchmarks");
+    if (list == nullptr || list->kind != detail::json_value::array_value)
+    {
+        throw std::runtime_error("benchmark json: missing \"benchmarks\" array");
+    }
+
+    std::vector<benchmark_result> results;
+    for (const detail::json_value &item : list->items)
+    {
+        const detail::json_value *name = item.find("name");
+        const detail::json_value *samples = item.find("samples_ns");
+        if (name == nullptr || samples == nullptr)
+        {
+            throw std::runtime_error("benchmark json: entry without name or samples_ns");
+        }
+        benchmark_result r;
+        r.name = name->text;
+        for (const detail::json_value &s : samples->items)
+        {
+            r.samples_ns.push_back(s.number);
+        }
+        if (const detail::json_value *iterations = item.find("iterations"))
+        {
+            r.iterations = static_cast<std::size_t>(iterations->number);
+        }
+        if (const detail::json_value *stable = item.find("stable"))
+        {
+            r.stable = stable->boolean;
+        }
+        if (const detail::json_value *counters = item.find("counters"))
+        {
+            for (const std::pair<std::string, detail::json_value> &c : counters->members)
+            {
+                r.counters[c.first] = c.second.number;
+            }
+        }
+        r.summarize();
+        results.push_back(std::move(r));
+    }
+    return results;
+}
+
+/**
+ * @brief 注册并运行一组基准
+ */
+class benchmark_runner
+{
+public:
+    typedef std::function<void(benchmark_state &)> body_t;
+
+    explicit benchmark_runner(const benchmark_options &options = benchmark_options()) : options_(options) {}
+
+    benchmark_runner &add(const std::string &name, body_t body)
+    {
+        if (!body)
+        {
+            throw std::invalid_argument("benchmark: empty body for " + name);
+        }
+        benchmarks_.emplace_back(name, std::move(body));
+        return *this;
+    }
+
+    /* probe 由调用者持有，必须比 runner 活得久 */
+    benchmark_runner &add_probe(benchmark_probe &probe)
+    {
+        probes_.push_back(&probe);
+        return *this;
+    }
+
+    /* 依次运行所有匹配 filter 的基准，边运行边打印；设置了 json_path 时最后写出 JSON */
+    const std::vector<benchmark_result> &run(std::ostream &log)
+    {
+        results_.clear();
+        log << std::left << std::setw(36) << "benchmark" << std::right << std::setw(12) << "iters" << std::setw(9)
+            << "samples" << std::setw(14) << "median(ns)" << std::setw(12) << "mad(ns)" << std::setw(8) << "mad%"
+            << "  counters/op" << std::endl;
+        for (const std::pair<std::string, body_t> &b : benchmarks_)
+        {
+            if (!options_.filter.empty() && b.first.find(options_.filter) == std::string::npos)
+            {
+                continue;
+            }
+            results_.push_back(measure(b.first, b.second));
+            print_row(log, results_.back());
+        }
+        if (!options_.json_path.empty())
+        {
+            std::ofstream out(options_.json_path.c_str());
+            write_benchmark_json(results_, out);
+            if (!out)
+            {
+                throw std::runtime_error("benchmark: cannot write " + options_.json_path);
+            }
+            log << "results written to " << options_.json_path << std::endl;
+        }
+        return results_;
+    }
+
+    const std::vector<benchmark_result> &results() const
+    {
+        return results_;
+    }
+
+    const benchmark_options &options() const
+    {
+        return options_;
+    }
+
+private:
+    /* 运行一个样本，返回计时部分的纳秒数；counters 为 nullptr 时丢弃计数(标定和预热阶段) */
+    double run_sample(const body_t &body, std::size_t iterations, std::map<std::string, double> *counters) const
+    {
+        benchmark_state state(iterations, probes_.empty() ? nullptr : &probes_);
+        body(state);
+        if (iterations > 0 && state.keep_running())
+        {
+            throw std::logic_error("benchmark: body returned before keep_running() finished");
+        }
+        std::map<std::string, double> discarded;
+        std::map<std::string, double> &out = counters != nullptr ? *counters : discarded;
+        for (const std::pair<const std::string, double> &c : state.counters())
+        {
+            out[c.first] += c.second;
+        }
+        for (benchmark_probe *probe : probes_)
+        {
+            probe->collect(out);
+        }
+        return state.elapsed_ns();
+    }
+
+    benchmark_result measure(const std::string &name, const body_t &body) const
+    {
+        typedef std::chrono::steady_clock clock;
+        const double sample_ns = options_.sample_ms * 1e6;
+
+        /* 1. 迭代次数翻倍增长，直到单个样本足够长；这段时间同时算作预热 */
+        const clock::time_point warmup_begin = clock::now();
+        std::size_t iterations = 1;
+        for (;;)
+        {
+            const double elapsed = run_sample(body, iterations, nullptr);
+            if (elapsed >= sample_ns || iterations >= (std::size_t(1) << 40))
+            {
+                break;
+            }
+            const double factor = elapsed > 0 ? sample_ns * 1.2 / elapsed : 10.0;
+            iterations = static_cast<std::size_t>(iterations * std::min(10.0, std::max(2.0, factor)));
+        }
+
+        /* 2. 预热 */
+        while (std::chrono::duration<double, std::milli>(clock::now() - warmup_begin).count() < options_.warmup_ms)
+        {
+            run_sample(body, iterations, nullptr);
+        }
+
+        /* 3. 采样直到稳定 */
+        benchmark_result result;
+        result.name = name;
+        result.iterations = iterations;
+        std::map<std::string, double> counter_totals;
+        const clock::time_point sample_begin = clock::now();
+        for (;;)
+        {
+            result.samples_ns.push_back(run_sample(body, iterations, &counter_totals) / static_cast<double>(iterations));
+
+            const std::size_t n = result.samples_ns.size();
+            if (n < options_.min_samples)
+            {
+                continue;
+            }
+            const double median = sample_median(result.samples_ns);
+            result.stable = median > 0 && sample_mad(result.samples_ns) / median <= options_.max_rel_mad;
+            if (result.stable || n >= options_.max_samples ||
+                std::chrono::duration<double, std::milli>(clock::now() - sample_begin).count() >= options_.max_time_ms)
+            {
+                break;
+            }
+        }
+
+        result.summarize();
+        const double ops = static_cast<double>(iterations) * static_cast<double>(result.samples_ns.size());
+        for (const std::pair<const std::string, double> &c : counter_totals)
+        {
+            result.counters[c.first] = c.second / ops;
+        }
+        for (benchmark_probe *probe : probes_)
+        {
+            probe->finish(result);
+        }
+        return result;
+    }
+
+    static void print_row(std::ostream &log, const benchmark_result &r)
+    {
+        std::ostringstream counters;
+        for (const std::pair<const std::string, double> &c : r.counters)
+        {
+            counters << " " << c.first << "=" << c.second;
+        }
+        log << std::left << std::setw(36) << r.name << std::right << std::setw(12) << r.iterations << std::setw(9)
+            << r.samples_ns.size() << std::setw(14) << std::fixed << std::setprecision(1) << r.median_ns << std::setw(12)
+            << r.mad_ns << std::setw(7) << std::setprecision(2) << r.rel_mad() * 100 << "%" << (r.stable ? " " : "?")
+            << counters.str() << std::defaultfloat << std::setprecision(6) << std::endl;
+    }
+
+    benchmark_options options_;
+    std::vector<std::pair<std::string, body_t>> benchmarks_;
+    std::vector<benchmark_probe *> probes_;
+    std::vector<benchmark_result> results_;
+};
+
+} // namespace learning
+
+#endif // BENCHMARK_HPP
@@ -0,0 +1,250 @@
+/**
+ * @file benchmark_test.cpp
+ * @author Richard Wang
+ * @brief 把 lamba_test / tie_tuple_pair_test 中演示的写法做成基准
+ *  1. sort：cmp 函数指针、lambda、std::function 三种比较器排序同一份 10000 个随机整数；
+ *  2. build：用 vector / list 存 pair<int, string> 与 tuple<int, string, int>，emplace_back 与 push_back 各建 1000 条；
+ *  3. tie：for_each 中用 std::tie 把 tuple 解包到局部变量，对比直接 std::get 引用；
+ *  4. for_each：遍历 vector 与 list 中的 tuple 累加年龄。
+ *
+ * 编译: g++ -std=c++14 -O2 -pthread benchmark_test.cpp -o benchmark_test
+ * 用法: benchmark_test [--filter=sort] [--json=result.json] [--max-rel-mad=0.02] ...
+ * @version : 1.0
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c), Richard Wang.
+ *
+ */
+
+#include <iostream>
+#include <algorithm>
+#include <exception>
+#include <functional>
+#include <list>
+#include <random>
+#include <string>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#include "benchmark.hpp"
+
+typedef std::pair<int, std::string> pair_t;                          // (年龄, 姓名)
+typedef std::tuple<int, std::string, int> user_t;                    // (年龄, 姓名, 身高)
+typedef std::tuple<int, std::string, std::string> info_t;            // (日期, 月份, 国家)
+
+static const std::size_t kSortSize = 10000;
+static const std::size_t kRecords = 1000;
+static const char *kNames[] = {"Richard", "Jack", "Simth", "Mark", "Rose", "Jim", "Amy", "Lucy"};
+
+bool cmp(int a, int b)
+{
+    return a < b;
+}
+
+/**
+ * @brief 三种比较器；每次迭代在暂停计时的情况下复制一份乱序数据
+ */
+void add_sort_benchmarks(learning::benchmark_runner &runner)
+{
+    std::mt19937 rng(42);
+    std::vector<int> input(kSortSize);
+    for (int &v : input)
+    {
+        v = static_cast<int>(rng());
+    }
+
+    auto sort_with = [input](learning::benchmark_state &state, auto compare)
+    {
+        std::vector<int> values;
+        while (state.keep_running())
+        {
+            state.pause_timing();
+            values = input;
+            state.resume_timing();
+            std::sort(values.begin(), values.end(), compare);
+            learning::do_not_optimize(values.data());
+        }
+        state.add_counter("items", static_cast<double>(state.iterations() * input.size()));
+    };
+
+    runner.add("sort/cmp_function", [sort_with](learning::benchmark_state &state)
+               { sort_with(state, cmp); });
+    runner.add("sort/lambda", [sort_with](learning::benchmark_state &state)
+               { sort_with(state, [](int a, int b) -> bool
+                           { return a < b; }); });
+    runner.add("sort/std_function", [sort_with](learning::benchmark_state &state)
+               {
+                   std::function<bool(int, int)> compare = [](int a, int b) -> bool
+                   { return a < b; };
+                   sort_with(state, compare);
+               });
+}
+
+/* 让 add_build_benchmarks 可以用同一个模板参数生成 pair / tuple 两种容器 */
+struct vector_family
+{
+    template <class T>
+    struct rebind
+    {
+        typedef std::vector<T> type;
+    };
+};
+
+struct list_family
+{
+    template <class T>
+    struct rebind
+    {
+        typedef std::list<T> type;
+    };
+};
+
+/**
+ * @brief 容器构建：emplace_back(参数) 原地构造，push_back(make_xxx(...)) 先构造临时对象再移动
+ */
+template <class Family>
+void add_build_benchmarks(learning::benchmark_runner &runner, const std::string &container)
+{
+    runner.add("build/" + container + "<pair>/emplace_back", [](learning::benchmark_state &state)
+               {
+                   while (state.keep_running())
+                   {
+                       typename Family::template rebind<pair_t>::type records;
+                       for (std::size_t i = 0; i < kRecords; ++i)
+                       {
+                           records.emplace_back(static_cast<int>(i % 60), kNames[i % 8]);
+                       }
+                       learning::do_not_optimize(records);
+                   }
+               });
+    runner.add("build/" + container + "<pair>/push_back", [](learning::benchmark_state &state)
+               {
+                   while (state.keep_running())
+                   {
+                       typename Family::template rebind<pair_t>::type records;
+                       for (std::size_t i = 0; i < kRecords; ++i)
+                       {
+                           records.push_back(std::make_pair(static_cast<int>(i % 60), std::string(kNames[i % 8])));
+                       }
+                       learning::do_not_optimize(records);
+                   }
+               });
+    runner.add("build/" + container + "<tuple>/emplace_back", [](learning::benchmark_state &state)
+               {
+                   while (state.keep_running())
+                   {
+                       typename Family::template rebind<user_t>::type records;
+                       for (std::size_t i = 0; i < kRecords; ++i)
+                       {
+                           records.emplace_back(static_cast<int>(i % 60), kNames[i % 8], 160 + static_cast<int>(i % 40));
+                       }
+                       learning::do_not_optimize(records);
+                   }
+               });
+    runner.add("build/" + container + "<tuple>/push_back", [](learning::benchmark_state &state)
+               {
+                   while (state.keep_running())
+                   {
+                       typename Family::template rebind<user_t>::type records;
+                       for (std::size_t i = 0; i < kRecords; ++i)
+                       {
+                           records.push_back(std::make_tuple(static_cast<int>(i % 60), std::string(kNames[i % 8]), 160 + static_cast<int>(i % 40)));
+                       }
+                       learning::do_not_optimize(records);
+                   }
+               });
+}
+
+/**
+ * @brief tie 解包与 for_each 遍历
+ */
+void add_iteration_benchmarks(learning::benchmark_runner &runner)
+{
+    std::list<info_t> info_list;
+    std::vector<user_t> user_vector;
+    const char *months[] = {"Feb", "Jun", "March", "Dec"};
+    const char *countries[] = {"China", "America", "English", "France"};
+    for (std::size_t i = 0; i < kRecords; ++i)
+    {
+        info_list.emplace_back(static_cast<int>(i % 31) + 1, months[i % 4], countries[i % 4]);
+        user_vector.emplace_back(static_cast<int>(i % 60), kNames[i % 8], 160 + static_cast<int>(i % 40));
+    }
+    std::list<user_t> user_list(user_vector.begin(), user_vector.end());
+
+    runner.add("tie/unpack_copy", [info_list](learning::benchmark_state &state)
+               {
+                   while (state.keep_running())
+                   {
+                       std::size_t total = 0;
+                       for_each(info_list.begin(), info_list.end(), [&total](const info_t &info)
+                                {
+                                    int i_date;
+                                    std::string str_month;
+                                    std::string str_country;
+                                    std::tie(i_date, str_month, str_country) = info;
+                                    total += i_date + str_month.size() + str_country.size();
+                                });
+                       learning::do_not_optimize(total);
+                   }
+               });
+    runner.add("tie/get_reference", [info_list](learning::benchmark_state &state)
+               {
+                   while (state.keep_running())
+                   {
+                       std::size_t total = 0;
+                       for_each(info_list.begin(), info_list.end(), [&total](const info_t &info)
+                                { total += std::get<0>(info) + std::get<1>(info).size() + std::get<2>(info).size(); });
+                       learning::do_not_optimize(total);
+                   }
+               });
+    runner.add("for_each/vector<tuple>", [user_vector](learning::benchmark_state &state)
+               {
+                   while (state.keep_running())
+                   {
+                       long long ages = 0;
+                       for_each(user_vector.begin(), user_vector.end(), [&ages](const user_t &user)
+                                { ages += std::get<0>(user); });
+                       learning::do_not_optimize(ages);
+                   }
+               });
+    runner.add("for_each/list<tuple>", [user_list](learning::benchmark_state &state)
+               {
+                   while (state.keep_running())
+                   {
+                       long long ages = 0;
+                       for_each(user_list.begin(), user_list.end(), [&ages](const user_t &user)
+                                { ages += std::get<0>(user); });
+                       learning::do_not_optimize(ages);
+                   }
+               });
+}
+
+int main(int argc, char *argv[])
+{
+    try
+    {
+        learning::benchmark_runner runner(learning::benchmark_options::parse(argc, argv));
+
+        /*************** add_sort_benchmarks() **********/
+        add_sort_benchmarks(runner);
+        /************************************************/
+
+        /************** add_build_benchmarks() **********/
+        add_build_benchmarks<vector_family>(runner, "vector");
+        add_build_benchmarks<list_family>(runner, "list");
+        /************************************************/
+
+        /*********** add_iteration_benchmarks() *********/
+        add_iteration_benchmarks(runner);
+        /************************************************/
+
+        runner.run(std::cout);
+    }
+    catch (const std::exception &e)
+    {
+        std::cerr << "error: " << e.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,356 @@
+/**
+ * @file comparator_study.cpp
+ * @author Richard Wang
+ * @brief 比较器表示方式的专题测试：lamba_test 中 test_no_capture_list() 把 cmp 函数指针和 lambda 放在一起，这里实际测一测
+ *  1. 五种比较器排序同一份随机整数：
+ *      function_pointer : std::sort(first, last, cmp)，与 lamba_test 中的写法相同；
+ *      lambda           : 无捕获 lambda，每个 lambda 是独立的类型，operator() 对编译器完全可见；
+ *      functor          : 带状态的函数对象(按 key >> shift 比较)，状态随比较器一起被 sort 复制；
+ *      std_function     : std::function<bool(int, int)>，每次比较经过一次间接调用；
+ *      small_function   : learning::small_function(SBO 类型擦除，只能移动)，用 std::ref 传给要求可复制比较器的 std::sort。
+ *  2. 规模
+ *      默认 16 到 1M 个元素(每级 x16)；--max-size=100000000 可以一直测到 1 亿(约 800MB 内存，建议同时加 --min-samples=3)。
+ *      小规模时每次迭代排序多组数据，使一次操作至少覆盖 64K 个元素；结果表按 "每个元素纳秒数" 汇总。
+ *  3. 汇编层面的内联验证
+ *      每种写法都放在一个不内联的 study_sort_xxx() 里。--disassemble 时程序用 objdump 反汇编自身，
+ *      从 study_sort_xxx() 出发沿着直接调用进入 std::__introsort_loop 等排序内部函数，统计其中的间接调用(call *)
+ *      和对 cmp 的直接调用；两者都为 0 说明比较器被完全内联。
+ *      也可以手动检查：
+ *          g++ -std=c++14 -O2 -S comparator_study.cpp -o - | c++filt | less     (搜索 study_sort_ 和 __introsort_loop)
+ *          objdump -d -C --no-show-raw-insn comparator_study | grep -A40 '<study_sort_std_function'
+ *      以 GCC -O2 为例：lambda 和 functor 被完全内联；function_pointer 的 sort 内部函数只拿到一个指针参数，
+ *      每次比较都是 call *%reg(个别地方直接 call cmp)；std_function / small_function 每次比较都要经过函数表间接调用。
+ *
+ * 编译: g++ -std=c++14 -O2 comparator_study.cpp -o comparator_study
+ * 用法: comparator_study [--max-size=1048576] [--disassemble] [--json=study.json] [其它 benchmark 参数]
+ * @version : 1.0
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c), Richard Wang.
+ *
+ */
+
+#include <iostream>
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <exception>
+#include <functional>
+#include <iomanip>
+#include <map>
+#include <memory>
+#include <random>
+#include <set>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <unistd.h>
+
+#include "../future/small_function.hpp"
+#include "benchmark.hpp"
+
+#if defined(__GNUC__)
+#define STUDY_NOINLINE __attribute__((noinline))
+#else
+#define STUDY_NOINLINE
+#endif
+
+bool cmp(int a, int b)
+{
+    return a < b;
+}
+
+/* 带状态的比较器：按 key >> shift 比较，shift = 0 时与 cmp 等价 */
+struct shifted_less
+{
+    int shift;
+
+    bool operator()(int a, int b) const
+    {
+        return (a >> shift) < (b >> shift);
+    }
+};
+
+typedef learning::small_function<bool(int, int)> small_compare_t;
+
+STUDY_NOINLINE void study_sort_function_pointer(int *first, int *last)
+{
+    std::sort(first, last, cmp);
+}
+
+STUDY_NOINLINE void study_sort_lambda(int *first, int *last)
+{
+    std::sort(first, last, [](int a, int b) -> bool
+              { return a < b; });
+}
+
+STUDY_NOINLINE void study_sort_functor(int *first, int *last, int shift)
+{
+    std::sort(first, last, shifted_less{shift});
+}
+
+STUDY_NOINLINE void study_sort_std_function(int *first, int *last, const std::function<bool(int, int)> &compare)
+{
+    std::sort(first, last, compare);
+}
+
+STUDY_NOINLINE void study_sort_small_function(int *first, int *last, small_compare_t &compare)
+{
+    std::sort(first, last, std::ref(compare));
+}
+
+static const char *kStudies[] = {"function_pointer", "lambda", "functor", "std_function", "small_function"};
+static const std::size_t kMinElementsPerOp = 1 << 16;
+
+/**
+ * @brief 每个规模注册五个基准；每次迭代在暂停计时的情况下从随机数据池复制 batch 组待排数据
+ */
+static void add_size(learning::benchmark_runner &runner, std::size_t n, std::map<std::string, double> &elements_per_op)
+{
+    const std::size_t batch = std::max<std::size_t>(1, kMinElementsPerOp / n);
+    std::shared_ptr<std::vector<int>> pool = std::make_shared<std::vector<int>>(n * batch);
+    std::mt19937 rng(static_cast<uint32_t>(n));
+    for (int &v : *pool)
+    {
+        v = static_cast<int>(rng());
+    }
+    std::shared_ptr<std::vector<int>> work = std::make_shared<std::vector<int>>(pool->size());
+
+    for (std::size_t study = 0; study < sizeof(kStudies) / sizeof(kStudies[0]); ++study)
+    {
+        const std::string name = std::string("sort/") + kStudies[study] + "/" + std::to_string(n);
+        elements_per_op[name] = static_cast<double>(n * batch);
+        runner.add(name, [pool, work, n, batch, study](learning::benchmark_state &state)
+                   {
+                       std::function<bool(int, int)> std_compare = [](int a, int b) -> bool
+                       { return a < b; };
+                       small_compare_t small_compare([](int a, int b) -> bool
+                                                     { return a < b; });
+                       volatile int shift = 0; // 不让编译器把状态当作常量
+                       while (state.keep_running())
+                       {
+                           state.pause_timing();
+                           std::memcpy(work->data(), pool->data(), pool->size() * sizeof(int));
+                           state.resume_timing();
+                           for (std::size_t b = 0; b < batch; ++b)
+                           {
+                               int *first = work->data() + b * n;
+                               switch (study)
+                               {
+                               case 0:
+                                   study_sort_function_pointer(first, first + n);
+                                   break;
+                               case 1:
+                                   study_sort_lambda(first, first + n);
+                                   break;
+                               case 2:
+                                   study_sort_functor(first, first + n, shift);
+                                   break;
+                               case 3:
+                                   study_sort_std_function(first, first + n, std_compare);
+                                   break;
+                               default:
+                                   study_sort_small_function(first, first + n, small_compare);
+                                   break;
+                               }
+                           }
+                           learning::do_not_optimize(work->data());
+                       }
+                   });
+    }
+}
+
+/**
+ * @brief 汇总表：行为规模，列为比较器，单位为每个元素的纳秒数
+ */
+static void print_summary(const std::vector<learning::benchmark_result> &results, const std::map<std::string, double> &elements_per_op,
+                          const std::vector<std::size_t> &sizes)
+{
+    std::cout << "------------- summary (ns per element, median) ------------------" << std::endl;
+    std::cout << std::setw(12) << "size";
+    for (const char *study : kStudies)
+    {
+        std::cout << std::setw(18) << study;
+    }
+    std::cout << std::endl;
+    for (std::size_t n : sizes)
+    {
+        std::cout << std::setw(12) << n;
+        for (const char *study : kStudies)
+        {
+            const std::string name = std::string("sort/") + study + "/" + std::to_string(n);
+            std::vector<learning::benchmark_result>::const_iterator it =
+                std::find_if(results.begin(), results.end(), [&name](const learning::benchmark_result &r)
+                             { return r.name == name; });
+            std::ostringstream cell;
+            if (it != results.end())
+            {
+                cell << std::fixed << std::setprecision(2) << it->median_ns / elements_per_op.at(name);
+            }
+            else
+            {
+                cell << "-";
+            }
+            std::cout << std::setw(18) << cell.str();
+        }
+        std::cout << std::endl;
+    }
+}
+
+/**
+ * @brief 反汇编自身，检查每个 study_sort_xxx() 及其调用的排序内部函数中是否还有对比较器的调用
+ */
+static void disassemble_study()
+{
+    std::cout << "------------- inlining check (objdump) ------------------" << std::endl;
+    char exe[4096];
+    const ssize_t len = ::readlink("/proc/self/exe", exe, sizeof(exe) - 1);
+    if (len <= 0)
+    {
+        std::cout << "cannot locate the executable, see the header comment for the manual commands" << std::endl;
+        return;
+    }
+    exe[len] = '\0';
+    const std::string command = std::string("objdump -d -C --no-show-raw-insn '") + exe + "' 2>/dev/null";
+    FILE *pipe = ::popen(command.c_str(), "r");
+    if (pipe == nullptr)
+    {
+        std::cout << "objdump not available, see the header comment for the manual commands" << std::endl;
+        return;
+    }
+
+    /* 函数名 -> 该函数中的 call / jmp 目标("*" 表示间接调用) */
+    std::map<std::string, std::vector<std::string>> calls;
+    std::string current;
+    char line[8192];
+    while (std::fgets(line, sizeof(line), pipe) != nullptr)
+    {
+        std::string text(line);
+        if (!text.empty() && text.back() == '\n')
+        {
+            text.pop_back();
+        }
+        if (text.size() > 2 && text.compare(text.size() - 2, 2, ">:") == 0 && text.find(" <") != std::string::npos)
+        {
+            current = text.substr(text.find(" <") + 2, text.size() - text.find(" <") - 4);
+            calls[current];
+            continue;
+        }
+        const std::string::size_type call = text.find("\tcall");
+        const std::string::size_type jmp = text.find("\tjmp");
+        if (current.empty() || (call == std::string::npos && jmp == std::string::npos))
+        {
+            continue;
+        }
+        /* 操作数以 '*' 开头的是间接调用，例如 call *%rax、call *0x8(%rbx) */
+        const std::string::size_type operand = text.find_first_not_of("callqjmp \t", std::min(call, jmp) + 1);
+        const std::string::size_type open = text.find('<');
+        if (call != std::string::npos && operand != std::string::npos && text[operand] == '*')
+        {
+            calls[current].push_back("*");
+        }
+        else if (open != std::string::npos && text.back() == '>')
+        {
+            const std::string target = text.substr(open + 1, text.size() - open - 2);
+            if (target.find('+') == std::string::npos) // 排除函数内部跳转
+            {
+                calls[current].push_back(target);
+            }
+        }
+    }
+    ::pclose(pipe);
+
+    std::cout << std::left << std::setw(30) << "function" << std::right << std::setw(12) << "functions" << std::setw(16)
+              << "indirect calls" << std::setw(12) << "cmp calls" << "  comparator" << std::endl;
+    for (const std::pair<const std::string, std::vector<std::string>> &entry : calls)
+    {
+        if (entry.first.compare(0, 11, "study_sort_") != 0 || entry.first.find("[clone") != std::string::npos)
+        {
+            continue;
+        }
+        /* 沿直接调用进入 std:: 内部的排序实现(introsort / insertion sort / heap) */
+        std::set<std::string> visited;
+        std::vector<std::string> pending(1, entry.first);
+        std::size_t indirect = 0;
+        std::size_t direct_cmp = 0;
+        while (!pending.empty())
+        {
+            const std::string fn = pending.back();
+            pending.pop_back();
+            if (!visited.insert(fn).second || calls.find(fn) == calls.end())
+            {
+                continue;
+            }
+            for (const std::string &target : calls[fn])
+            {
+                if (target == "*")
+                {
+                    ++indirect;
+                }
+                else if (target.compare(0, 4, "cmp(") == 0)
+                {
+                    ++direct_cmp;
+                }
+                else if (target.find("std::__") != std::string::npos)
+                {
+                    pending.push_back(target);
+                }
+            }
+        }
+        const std::string name = entry.first.substr(0, entry.first.find('('));
+        std::cout << std::left << std::setw(30) << name << std::right << std::setw(12) << visited.size() << std::setw(16)
+                  << indirect << std::setw(12) << direct_cmp << "  " << (indirect == 0 && direct_cmp == 0 ? "inlined" : "called") << std::endl;
+    }
+}
+
+int main(int argc, char *argv[])
+{
+    std::size_t max_size = 1 << 20;
+    bool disassemble = false;
+    std::vector<char *> args(1, argv[0]);
+    for (int i = 1; i < argc; ++i)
+    {
+        if (std::strncmp(argv[i], "--max-size=", 11) == 0)
+        {
+            max_size = std::strtoull(argv[i] + 11, nullptr, 10);
+        }
+        else if (std::strcmp(argv[i], "--disassemble") == 0)
+        {
+            disassemble = true;
+        }
+        else
+        {
+            args.push_back(argv[i]);
+        }
+    }
+
+    try
+    {
+        learning::benchmark_runner runner(learning::benchmark_options::parse(static_cast<int>(args.size()), args.data()));
+        std::map<std::string, double> elements_per_op;
+        std::vector<std::size_t> sizes;
+        for (std::size_t n = 16; n <= max_size; n = n * 16 > max_size && n < max_size ? max_size : n * 16)
+        {
+            sizes.push_back(n);
+            add_size(runner, n, elements_per_op);
+        }
+
+        /********************** runner.run() ************/
+        print_summary(runner.run(std::cout), elements_per_op, sizes);
+        /************************************************/
+
+        /**************** disassemble_study() ***********/
+        if (disassemble)
+        {
+            disassemble_study();
+        }
+        /************************************************/
+    }
+    catch (const std::exception &e)
+    {
+        std::cerr << "error: " << e.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,312 @@
+/**
+ * @file compare.hpp
+ * @author Richard Wang
+ * @brief 两组基准结果的统计比较
+ *  1. Mann-Whitney U 检验
+ *      不假设正态分布，只看两组样本的秩；样本数较多时用带结(tie)修正和连续性修正的正态近似求双侧 p 值。
+ *  2. Bootstrap 置信区间
+ *      对两组样本分别有放回重采样，得到 "新中位数 / 旧中位数" 的分布，取百分位区间；随机种子固定，结果可复现。
+ *  3. 判定
+ *      变化显著(p < alpha，或置信区间不包含 1)且中位数变慢超过 threshold 记为回归，变快超过 threshold 记为提升，
+ *      其余为 "无变化"。单次运行的抖动即使超过阈值，只要不显著也不会被报告。
+ *
+ *  std::vector<learning::benchmark_result> base = learning::read_benchmark_json(old_file);
+ *  std::vector<learning::benchmark_result> head = learning::read_benchmark_json(new_file);
+ *  std::vector<learning::benchmark_comparison> diff = learning::compare_benchmarks(base, head, learning::compare_options());
+ *  learning::write_comparison(diff, std::cout);
+ * @version : 1.0
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c), Richard Wang.
+ *
+ */
+#ifndef BENCHMARK_COMPARE_HPP
+#define BENCHMARK_COMPARE_HPP
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <iomanip>
+#include <ostream>
+#include <random>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "benchmark.hpp"
+
+namespace learning
+{
+
+/**
+ * @brief Mann-Whitney U 检验结果
+ */
+struct mann_whitney_result
+{
+    double u = 0; // 第一组的 U 统计量
+    double z = 0;
+    double p = 1; // 双侧 p 值
+};
+
+/**
+ * @brief 两组独立样本的 Mann-Whitney U 检验(正态近似)；任何一组为空时 p = 1
+ */
+inline mann_whitney_result mann_whitney_u(const std::vector<double> &a, const std::vector<double> &b)
+{
+    mann_whitney_result result;
+    const std::size_t n1 = a.size();
+    const std::size_t n2 = b.size();
+    if (n1 == 0 || n2 == 0)
+    {
+        return result;
+    }
+
+    std::vector<std::pair<double, int>> all;
+    all.reserve(n1 + n2);
+    for (double v : a)
+    {
+        all.emplace_back(v, 0);
+    }
+    for (double v : b)
+    {
+        all.emplace_back(v, 1);
+    }
+    std::sort(all.begin(), all.end());
+
+    /* 相同的值取平均秩，同时累计结修正项 sum(t^3 - t) */
+    const double n = static_cast<double>(n1 + n2);
+    double rank_sum_a = 0;
+    double tie_term = 0;
+    for (std::size_t i = 0; i < all.size();)
+    {
+        std::size_t j = i;
+        while (j < all.size() && all[j].first == all[i].first)
+        {
+            ++j;
+        }
+        const double average_rank = (static_cast<double>(i + 1) + static_cast<double>(j)) / 2.0;
+        for (std::size_t k = i; k < j; ++k)
+        {
+            if (all[k].second == 0)
+            {
+                rank_sum_a += average_rank;
+            }
+        }
+        const double t = static_cast<double>(j - i);
+        tie_term += t * t * t - t;
+        i = j;
+    }
+
+    const double d1 = static_cast<double>(n1);
+    const double d2 = static_cast<double>(n2);
+    result.u = rank_sum_a - d1 * (d1 + 1) / 2.0;
+    const double mean = d1 * d2 / 2.0;
+    const double variance = d1 * d2 / 12.0 * ((n + 1) - tie_term / (n * (n - 1)));
+    if (variance <= 0)
+    {
+        return result; // 所有样本都相等
+    }
+    const double diff = result.u - mean;
+    const double corrected = std::max(0.0, std::fabs(diff) - 0.5);
+    result.z = (diff < 0 ? -corrected : corrected) / std::sqrt(variance);
+    result.p = std::erfc(std::fabs(result.z) / std::sqrt(2.0));
+    return result;
+}
+
+/**
+ * @brief median(b) / median(a) 的 bootstrap 百分位置信区间
+ */
+inline std::pair<double, double> bootstrap_median_ratio(const std::vector<double> &a, const std::vector<double> &b,
+                                                        double confidence = 0.99, std::size_t resamples = 2000,
+                                                        uint32_t seed = 12345)
+{
+    if (a.empty() || b.empty())
+    {
+        throw std::invalid_argument("bootstrap_median_ratio: empty sample set");
+    }
+    std::mt19937 rng(seed);
+    std::uniform_int_distribution<std::size_t> pick_a(0, a.size() - 1);
+    std::uniform_int_distribution<std::size_t> pick_b(0, b.size() - 1);
+    std::vector<double> ratios;
+    ratios.reserve(resamples);
+    std::vector<double> ra(a.size());
+    std::vector<double> rb(b.size());
+    for (std::size_t r = 0; r < resamples; ++r)
+    {
+        for (double &v : ra)
+        {
+            v = a[pick_a(rng)];
+        }
+        for (double &v : rb)
+        {
+            v = b[pick_b(rng)];
+        }
+        const double base = sample_median(ra);
+        ratios.push_back(base > 0 ? sample_median(rb) / base : 1.0);
+    }
+    std::sort(ratios.begin(), ratios.end());
+    const double tail = (1.0 - confidence) / 2.0;
+    const std::size_t lo = static_cast<std::size_t>(tail * static_cast<double>(resamples - 1));
+    const std::size_t hi = static_cast<std::size_t>((1.0 - tail) * static_cast<double>(resamples - 1) + 0.5);
+    return std::make_pair(ratios[lo], ratios[std::min(hi, resamples - 1)]);
+}
+
+enum class compare_method
+{
+    mann_whitney,
+    bootstrap
+};
+
+struct compare_options
+{
+    compare_method method = compare_method::mann_whitney;
+    double threshold = 0.05; // 中位数相对变化超过 5% 才考虑
+    double alpha = 0.01;     // 显著性水平；bootstrap 使用 1 - alpha 置信区间
+    std::size_t min_samples = 3; // 任何一边样本少于该值时不判定为显著
+};
+
+enum class compare_verdict
+{
+    unchanged,
+    improved,
+    regressed,
+    missing // 只在一边出现
+};
+
+/**
+ * @brief 单个基准的比较结果
+ */
+struct benchmark_comparison
+{
+    std::string name;
+    double old_median_ns = 0;
+    double new_median_ns = 0;
+    double change = 0;   // new / old - 1
+    double p = 1;        // Mann-Whitney 的 p 值
+    double ci_low = 0;   // bootstrap 时 median ratio 的置信区间
+    double ci_high = 0;
+    bool significant = false;
+    compare_verdict verdict = compare_verdict::unchanged;
+};
+
+inline const char *verdict_name(compare_verdict v)
+{
+    static const char *names[] = {"same", "FASTER", "SLOWER", "missing"};
+    return names[static_cast<int>(v)];
+}
+
+/**
+ * @brief 按名字配对比较；只在一边出现的基准标记为 missing
+ */
+inline std::vector<benchmark_comparison> compare_benchmarks(const std::vector<benchmark_result> &before,
+                                                            const std::vector<benchmark_result> &after,
+                                                            const compare_options &options)
+{
+    std::vector<benchmark_comparison> out;
+    for (const benchmark_result &old_result : before)
+    {
+        benchmark_comparison c;
+        c.name = old_result.name;
+        c.old_median_ns = sample_median(old_result.samples_ns);
+        std::vector<benchmark_result>::const_iterator it =
+            std::find_if(after.begin(), after.end(), [&old_result](const benchmark_result &r)
+                         { return r.name == old_result.name; });
+        if (it == after.end() || old_result.samples_ns.empty() || it->samples_ns.empty())
+        {
+            c.verdict = compare_verdict::missing;
+            out.push_back(c);
+            continue;
+        }
+
+        c.new_median_ns = sample_median(it->samples_ns);
+        c.change = c.old_median_ns > 0 ? c.new_median_ns / c.old_median_ns - 1.0 : 0.0;
+        c.p = mann_whitney_u(old_result.samples_ns, it->samples_ns).p;
+        if (old_result.samples_ns.size() < options.min_samples || it->samples_ns.size() < options.min_samples)
+        {
+            c.significant = false; // 样本太少，bootstrap 区间会退化成一个点
+        }
+        else if (options.method == compare_method::bootstrap)
+        {
+            const std::pair<double, double> ci = bootstrap_median_ratio(old_result.samples_ns, it->samples_ns, 1.0 - options.alpha);
+            c.ci_low = ci.first;
+            c.ci_high = ci.second;
+            c.significant = ci.first > 1.0 || ci.second < 1.0;
+        }
+        else
+        {
+            c.significant = c.p < options.alpha;
+        }
+        if (c.significant && c.change > options.threshold)
+        {
+            c.verdict = compare_verdict::regressed;
+        }
+        else if (c.significant && c.change < -options.threshold)
+        {
+            c.verdict = compare_verdict::improved;
+        }
+        out.push_back(c);
+    }
+    for (const benchmark_result &new_result : after)
+    {
+        if (std::none_of(before.begin(), before.end(), [&new_result](const benchmark_result &r)
+                         { return r.name == new_result.name; }))
+        {
+            benchmark_comparison c;
+            c.name = new_result.name;
+            c.new_median_ns = sample_median(new_result.samples_ns);
+            c.verdict = compare_verdict::missing;
+            out.push_back(c);
+        }
+    }
+    return out;
+}
+
+inline std::size_t count_regressions(const std::vector<benchmark_comparison> &comparisons)
+{
+    return static_cast<std::size_t>(std::count_if(comparisons.begin(), comparisons.end(), [](const benchmark_comparison &c)
+                                                  { return c.verdict == compare_verdict::regressed; }));
+}
+
+inline void write_comparison(const std::vector<benchmark_comparison> &comparisons, std::ostream &os)
+{
+    os << std::left << std::setw(36) << "benchmark" << std::right << std::setw(14) << "old(ns)" << std::setw(14)
+       << "new(ns)" << std::setw(10) << "change" << std::setw(10) << "p" << std::setw(20) << "ratio ci" << "  verdict" << std::endl;
+    for (const benchmark_comparison &c : comparisons)
+    {
+        std::ostringstream row;
+        row << std::fixed << std::left << std::setw(36) << c.name << std::right << std::setprecision(1);
+        if (c.verdict == compare_verdict::missing)
+        {
+            /* 缺失的一边中位数为 0 */
+            row << std::setw(14);
+            c.old_median_ns > 0 ? row << c.old_median_ns : row << "-";
+            row << std::setw(14);
+            c.new_median_ns > 0 ? row << c.new_median_ns : row << "-";
+            row << std::setw(10) << "-" << std::setw(10) << "-" << std::setw(20) << "-";
+        }
+        else
+        {
+            std::ostringstream change;
+            change << std::fixed << std::setprecision(1) << std::showpos << c.change * 100 << "%";
+            std::ostringstream ci;
+            if (c.ci_high > 0)
+            {
+                ci << std::fixed << std::setprecision(3) << "[" << c.ci_low << ", " << c.ci_high << "]";
+            }
+            else
+            {
+                ci << "-";
+            }
+            row << std::setw(14) << c.old_median_ns << std::setw(14) << c.new_median_ns << std::setw(10) << change.str() << std::setw(10) << std::setprecision(4) << c.p << std::setw(20) << ci.str();
+        }
+        row << "  " << verdict_name(c.verdict);
+        os << row.str() << std::endl;
+    }
+}
+
+} // namespace learning
+
+#endif // BENCHMARK_COMPARE_HPP
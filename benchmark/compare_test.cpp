@@ -0,0 +1,111 @@
+/**
+ * @file compare_test.cpp
+ * @author Richard Wang
+ * @brief 基准比较示例
+ *  1. 用带长尾噪声的模拟样本演示：同分布、变慢 3%(低于阈值)、变慢 10%、变快 20% 四种情况的判定；
+ *  2. 单次运行(每边一个样本)即使差 15% 也不会被判为回归，这正是单次比较会漏报、误报的原因；
+ *  3. 写出 / 读回 JSON 后再比较，结果与直接比较一致(bench_compare 工具走的就是这条路径)。
+ *
+ * 编译: g++ -std=c++14 -O2 compare_test.cpp -o compare_test
+ * @version : 1.0
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c), Richard Wang.
+ *
+ */
+
+#include <iostream>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "compare.hpp"
+
+/**
+ * @brief 模拟一个基准：中位数约为 median_ns，多数样本抖动 1%，偶尔被调度打断慢 30%
+ */
+static learning::benchmark_result simulate(const std::string &name, double median_ns, std::size_t samples, uint32_t seed)
+{
+    std::mt19937 rng(seed);
+    std::normal_distribution<double> jitter(0.0, 0.01);
+    std::bernoulli_distribution interrupted(0.05);
+    learning::benchmark_result r;
+    r.name = name;
+    r.iterations = 100;
+    for (std::size_t i = 0; i < samples; ++i)
+    {
+        r.samples_ns.push_back(median_ns * (1.0 + jitter(rng)) * (interrupted(rng) ? 1.3 : 1.0));
+    }
+    r.summarize();
+    return r;
+}
+
+/**
+ * @brief 四种典型情况
+ */
+void verdict_test()
+{
+    std::cout << "------------- test verdict ------------------" << std::endl;
+    std::vector<learning::benchmark_result> before = {simulate("sort/lambda", 1000, 30, 1), simulate("sort/std_function", 1000, 30, 2),
+                                                      simulate("build/list<tuple>", 1000, 30, 3), simulate("tie/unpack_copy", 1000, 30, 4)};
+    std::vector<learning::benchmark_result> after = {simulate("sort/lambda", 1000, 30, 11), simulate("sort/std_function", 1030, 30, 12),
+                                                     simulate("build/list<tuple>", 1100, 30, 13), simulate("tie/unpack_copy", 800, 30, 14)};
+
+    learning::compare_options options;
+    const std::vector<learning::benchmark_comparison> mw = learning::compare_benchmarks(before, after, options);
+    learning::write_comparison(mw, std::cout);
+
+    options.method = learning::compare_method::bootstrap;
+    const std::vector<learning::benchmark_comparison> bs = learning::compare_benchmarks(before, after, options);
+    learning::write_comparison(bs, std::cout);
+    std::cout << "regressions: mann-whitney " << learning::count_regressions(mw) << ", bootstrap " << learning::count_regressions(bs) << std::endl;
+}
+
+/**
+ * @brief 每边只有一个样本
+ */
+void single_run_test()
+{
+    std::cout << "------------- test single run ------------------" << std::endl;
+    std::vector<learning::benchmark_result> before = {simulate("sort/cmp_function", 1000, 1, 5)};
+    std::vector<learning::benchmark_result> after = {simulate("sort/cmp_function", 1150, 1, 6)};
+    learning::write_comparison(learning::compare_benchmarks(before, after, learning::compare_options()), std::cout);
+}
+
+/**
+ * @brief 经过 JSON 往返
+ */
+void json_test()
+{
+    std::cout << "------------- test json round trip ------------------" << std::endl;
+    std::vector<learning::benchmark_result> before = {simulate("for_each/list<tuple>", 2000, 20, 7)};
+    std::vector<learning::benchmark_result> after = {simulate("for_each/list<tuple>", 2300, 20, 8),
+                                                     simulate("for_each/vector<tuple>", 450, 20, 9)};
+    std::stringstream old_json;
+    std::stringstream new_json;
+    learning::write_benchmark_json(before, old_json);
+    learning::write_benchmark_json(after, new_json);
+
+    const std::vector<learning::benchmark_comparison> comparisons = learning::compare_benchmarks(
+        learning::read_benchmark_json(old_json), learning::read_benchmark_json(new_json), learning::compare_options());
+    learning::write_comparison(comparisons, std::cout);
+    std::cout << "exit code bench_compare would return: " << (learning::count_regressions(comparisons) > 0 ? 1 : 0) << std::endl;
+}
+
+int main()
+{
+    /********************* verdict_test() ***********/
+    verdict_test();
+    /************************************************/
+
+    /****************** single_run_test() ***********/
+    single_run_test();
+    /************************************************/
+
+    /************************ json_test() ***********/
+    json_test();
+    /************************************************/
+
+    return 0;
+}
@@ -0,0 +1,505 @@
+/**
+ * @file task.hpp
+ * @author Richard Wang
+ * @brief C++20 协程：task<T>、co_await sleep_for(...) 以及多线程调度器
+ *  1. 为什么用协程
+ *      lamba_test.cpp 中的周期任务是“一个线程 + sleep_for”，每个线程默认占用 8MB 栈；
+ *      协程挂起时只保留一个堆上的协程帧(通常几百字节)，成千上万个周期任务可以共享几个线程。
+ *  2. task<T>
+ *      惰性启动：创建时不执行，被 co_await 时才开始；完成时通过对称转移(symmetric transfer)直接恢复等待它的协程，
+ *      不经过调度队列，也不会因为长链条的 co_await 而栈溢出。异常在 co_await 处重新抛出。
+ *  3. scheduler
+ *      工作线程复用 future/future.hpp 中的 thread_pool；另有一个定时线程(jthread)维护按到期时间排序的最小堆，
+ *      到期的协程被投递回线程池恢复执行。co_await sleep_for(d) 挂起当前协程并登记一个定时器，不占用任何线程。
+ *  4. 入口
+ *      spawn(task)        后台运行，不关心结果；wait_idle() 等待所有 spawn 的任务结束；
+ *      sync_wait(s, task) 在调用线程阻塞等待结果(只应在 main 等非协程代码中使用)。
+ *      scheduler 析构前应保证没有仍在睡眠的协程(例如先调用 wait_idle())。
+ *
+ *  learning::task<void> tick(int val)
+ *  {
+ *      for (int i = 0; i < 3; ++i)
+ *      {
+ *          co_await learning::sleep_for(std::chrono::milliseconds(1000));
+ *          std::cout << val << std::endl;
+ *      }
+ *  }
+ *  learning::scheduler sched(4);
+ *  sched.spawn(tick(123));
+ *  sched.wait_idle();
+ * @version : 1.0
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c), Richard Wang.
+ *
+ */
+#ifndef TASK_HPP
+#define TASK_HPP
+
+#if !defined(__cpp_impl_coroutine)
+#error "task.hpp requires C++20 coroutines, compile with -std=c++20"
+#endif
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <coroutine>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <mutex>
+#include <optional>
+#include <queue>
+#include <stdexcept>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "../future/future.hpp"
+#include "../stop_token/stop_token.hpp"
+
+namespace learning
+{
+
+template <class T = void>
+class task;
+
+namespace detail
+{
+
+/**
+ * @brief task 的 promise 公共部分：保存等待者与异常
+ */
+class task_promise_base
+{
+public:
+    /* 完成时把控制权直接转交给等待者 */
+    struct final_awaiter
+    {
+        bool await_ready() const noexcept { return false; }
+
+        template <class Promise>
+        std::coroutine_handle<> await_suspend(std::coroutine_handle<Promise> h) noexcept
+        {
+            std::coroutine_handle<> next = h.promise().continuation_;
+            return next ? next : std::noop_coroutine();
+        }
+
+        void await_resume() const noexcept {}
+    };
+
+    std::suspend_always initial_suspend() const noexcept { return {}; }
+    final_awaiter final_suspend() const noexcept { return {}; }
+    void unhandled_exception() noexcept { error_ = std::current_exception(); }
+
+    void set_continuation(std::coroutine_handle<> h) noexcept { continuation_ = h; }
+
+protected:
+    void rethrow_if_failed()
+    {
+        if (error_)
+        {
+            std::rethrow_exception(error_);
+        }
+    }
+
+private:
+    std::coroutine_handle<> continuation_;
+    std::exception_ptr error_;
+};
+
+template <class T>
+class task_promise : public task_promise_base
+{
+public:
+    task<T> get_return_object() noexcept;
+
+    template <class U>
+    void return_value(U &&value)
+    {
+        value_.emplace(std::forward<U>(value));
+    }
+
+    T result()
+    {
+        rethrow_if_failed();
+        return std::move(*value_);
+    }
+
+private:
+    std::optional<T> value_;
+};
+
+template <>
+class task_promise<void> : public task_promise_base
+{
+public:
+    task<void> get_return_object() noexcept;
+
+    void return_void() noexcept {}
+
+    void result() { rethrow_if_failed(); }
+};
+
+} // namespace detail
+
+/**
+ * @brief 惰性协程任务；只移动，析构时销毁协程帧
+ */
+template <class T>
+class task
+{
+public:
+    typedef detail::task_promise<T> promise_type;
+    typedef std::coroutine_handle<promise_type> handle_type;
+
+    task() noexcept {}
+    explicit task(handle_type h) noexcept : handle_(h) {}
+    task(task &&other) noexcept : handle_(std::exchange(other.handle_, nullptr)) {}
+
+    task &operator=(task &&other) noexcept
+    {
+        if (this != &other)
+        {
+            destroy();
+            handle_ = std::exchange(other.handle_, nullptr);
+        }
+        return *this;
+    }
+
+    ~task() { destroy(); }
+
+    task(const task &) = delete;
+    task &operator=(const task &) = delete;
+
+    bool valid() const noexcept { return static_cast<bool>(handle_); }
+
+    /* co_await task：启动它，完成后恢复当前协程并取得结果 */
+    auto operator co_await() && noexcept
+    {
+        struct awaiter
+        {
+            handle_type h;
+
+            bool await_ready() const noexcept { return !h || h.done(); }
+
+            std::coroutine_handle<> await_suspend(std::coroutine_handle<> awaiting) noexcept
+            {
+                h.promise().set_continuation(awaiting);
+                return h;
+            }
+
+            T await_resume()
+            {
+                if (!h)
+                {
+                    throw std::logic_error("task: awaiting an empty task");
+                }
+                return h.promise().result();
+            }
+        };
+        return awaiter{handle_};
+    }
+
+private:
+    void destroy()
+    {
+        if (handle_)
+        {
+            handle_.destroy();
+            handle_ = nullptr;
+        }
+    }
+
+    handle_type handle_;
+};
+
+namespace detail
+{
+
+template <class T>
+task<T> task_promise<T>::get_return_object() noexcept
+{
+    return task<T>(std::coroutine_handle<task_promise<T>>::from_promise(*this));
+}
+
+inline task<void> task_promise<void>::get_return_object() noexcept
+{
+    return task<void>(std::coroutine_handle<task_promise<void>>::from_promise(*this));
+}
+
+/**
+ * @brief 立即开始、结束时自行销毁的协程，用于 spawn / sync_wait 的外层包装
+ */
+struct detached_task
+{
+    struct promise_type
+    {
+        detached_task get_return_object() noexcept { return {}; }
+        std::suspend_never initial_suspend() const noexcept { return {}; }
+        std::suspend_never final_suspend() const noexcept { return {}; }
+        void return_void() noexcept {}
+        void unhandled_exception() noexcept { std::terminate(); }
+    };
+};
+
+} // namespace detail
+
+/**
+ * @brief 多线程协程调度器
+ */
+class scheduler
+{
+public:
+    typedef std::chrono::steady_clock clock_type;
+
+    explicit scheduler(std::size_t threads = std::thread::hardware_concurrency())
+        : next_seq_(0), generation_(0), outstanding_(0), pool_(threads)
+    {
+        timer_thread_ = jthread([this](stop_token token)
+                                { timer_loop(token); });
+    }
+
+    /* 先停止定时线程；成员析构时线程池(最后声明)最先析构，执行完剩余任务后 join，之后才释放各个互斥量 */
+    ~scheduler()
+    {
+        timer_thread_.request_stop();
+        timer_thread_.join();
+    }
+
+    scheduler(const scheduler &) = delete;
+    scheduler &operator=(const scheduler &) = delete;
+
+    std::size_t size() const { return pool_.size(); }
+
+    /* 当前线程所属的调度器；不在调度器线程上时返回 nullptr */
+    static scheduler *current() noexcept { return current_slot(); }
+
+    /* co_await s.schedule()：切换到调度器的工作线程上继续执行 */
+    auto schedule() noexcept
+    {
+        struct awaiter
+        {
+            scheduler *s;
+            bool await_ready() const noexcept { return false; }
+            void await_suspend(std::coroutine_handle<> h) { s->post(h); }
+            void await_resume() const noexcept {}
+        };
+        return awaiter{this};
+    }
+
+    /* co_await s.sleep_until(t)：到期后在工作线程上恢复 */
+    auto sleep_until(clock_type::time_point deadline) noexcept
+    {
+        struct awaiter
+        {
+            scheduler *s;
+            clock_type::time_point deadline;
+            bool await_ready() const noexcept { return deadline <= clock_type::now(); }
+            void await_suspend(std::coroutine_handle<> h) { s->post_at(deadline, h); }
+            void await_resume() const noexcept {}
+        };
+        return awaiter{this, deadline};
+    }
+
+    template <class Rep, class Period>
+    auto sleep_for(const std::chrono::duration<Rep, Period> &rel_time) noexcept
+    {
+        return sleep_until(clock_type::now() + std::chrono::duration_cast<clock_type::duration>(rel_time));
+    }
+
+    /**
+     * @brief 在调度器上后台运行 t；t 抛出的异常会终止程序(与 std::thread 一致)
+     */
+    void spawn(task<void> t)
+    {
+        outstanding_.fetch_add(1, std::memory_order_relaxed);
+        run_detached(std::move(t));
+    }
+
+    /* 阻塞直到所有 spawn 的任务结束 */
+    void wait_idle()
+    {
+        std::unique_lock<std::mutex> lock(idle_mutex_);
+        idle_cv_.wait(lock, [this]()
+                      { return outstanding_.load(std::memory_order_acquire) == 0; });
+    }
+
+    /* 把协程投递到工作线程恢复执行 */
+    void post(std::coroutine_handle<> h)
+    {
+        pool_.execute([this, h]()
+                      {
+                          current_slot() = this;
+                          h.resume();
+                      });
+    }
+
+    /* deadline 到期后投递 h */
+    void post_at(clock_type::time_point deadline, std::coroutine_handle<> h)
+    {
+        {
+            std::lock_guard<std::mutex> lock(timer_mutex_);
+            const bool earliest = timers_.empty() || deadline < timers_.top().deadline;
+            timers_.push(timer_entry{deadline, next_seq_++, h});
+            if (!earliest)
+            {
+                return;
+            }
+            ++generation_;
+        }
+        timer_cv_.notify_all();
+    }
+
+private:
+    struct timer_entry
+    {
+        clock_type::time_point deadline;
+        uint64_t seq; // 到期时间相同时按登记顺序恢复
+        std::coroutine_handle<> handle;
+
+        bool operator>(const timer_entry &other) const
+        {
+            return deadline != other.deadline ? deadline > other.deadline : seq > other.seq;
+        }
+    };
+
+    static scheduler *&current_slot() noexcept
+    {
+        static thread_local scheduler *slot = nullptr;
+        return slot;
+    }
+
+    detail::detached_task run_detached(task<void> t)
+    {
+        co_await schedule();
+        co_await std::move(t);
+        if (outstanding_.fetch_sub(1, std::memory_order_acq_rel) == 1)
+        {
+            std::lock_guard<std::mutex> lock(idle_mutex_);
+            idle_cv_.notify_all();
+        }
+    }
+
+    /*
+     * 等待最早的定时器到期；有更早的定时器登记时 generation_ 改变，重新计算等待时间。
+     */
+    void timer_loop(const stop_token &token)
+    {
+        std::unique_lock<std::mutex> lock(timer_mutex_);
+        while (!token.stop_requested())
+        {
+            if (timers_.empty())
+            {
+                timer_cv_.wait(lock, token, [this]()
+                               { return !timers_.empty(); });
+                continue;
+            }
+            const timer_entry top = timers_.top();
+            if (top.deadline <= clock_type::now())
+            {
+                timers_.pop();
+                lock.unlock();
+                post(top.handle);
+                lock.lock();
+                continue;
+            }
+            const uint64_t generation = generation_;
+            timer_cv_.wait_until(lock, token, top.deadline, [this, generation]()
+                                 { return generation_ != generation; });
+        }
+    }
+
+    std::mutex timer_mutex_;
+    stop_condition timer_cv_;
+    std::priority_queue<timer_entry, std::vector<timer_entry>, std::greater<timer_entry>> timers_;
+    uint64_t next_seq_;
+    uint64_t generation_;
+
+    std::atomic<std::size_t> outstanding_;
+    std::mutex idle_mutex_;
+    std::condition_variable idle_cv_;
+
+    jthread timer_thread_;
+    thread_pool pool_;
+};
+
+/**
+ * @brief co_await sleep_for(d)：在当前调度器上睡眠；不在调度器线程上调用时抛出 std::logic_error
+ */
+template <class Rep, class Period>
+auto sleep_for(const std::chrono::duration<Rep, Period> &rel_time)
+{
+    scheduler *s = scheduler::current();
+    if (s == nullptr)
+    {
+        throw std::logic_error("sleep_for: not running on a scheduler thread");
+    }
+    return s->sleep_for(rel_time);
+}
+
+namespace detail
+{
+
+template <class T>
+struct sync_wait_state
+{
+    std::mutex m;
+    std::condition_variable cv;
+    bool done = false;
+    std::exception_ptr error;
+    std::optional<std::conditional_t<std::is_void_v<T>, unit, T>> value;
+};
+
+template <class T>
+detached_task sync_wait_body(scheduler &s, task<T> t, sync_wait_state<T> *state)
+{
+    co_await s.schedule();
+    try
+    {
+        if constexpr (std::is_void_v<T>)
+        {
+            co_await std::move(t);
+            state->value.emplace();
+        }
+        else
+        {
+            state->value.emplace(co_await std::move(t));
+        }
+    }
+    catch (...)
+    {
+        state->error = std::current_exception();
+    }
+    std::lock_guard<std::mutex> lock(state->m);
+    state->done = true;
+    state->cv.notify_one();
+}
+
+} // namespace detail
+
+/**
+ * @brief 在调度器上运行 t 并阻塞等待结果；t 的异常在这里重新抛出
+ */
+template <class T>
+T sync_wait(scheduler &s, task<T> t)
+{
+    detail::sync_wait_state<T> state;
+    detail::sync_wait_body(s, std::move(t), &state);
+    std::unique_lock<std::mutex> lock(state.m);
+    state.cv.wait(lock, [&state]()
+                  { return state.done; });
+    if (state.error)
+    {
+        std::rethrow_exception(state.error);
+    }
+    if constexpr (!std::is_void_v<T>)
+    {
+        return std::move(*state.value);
+    }
+}
+
+} // namespace learning
+
+#endif // TASK_HPP
@@ -0,0 +1,177 @@
+/**
+ * @file task_test.cpp
+ * @author Richard Wang
+ * @brief C++20 协程示例
+ *  1. task<T> 之间的 co_await 与 sync_wait；
+ *  2. lamba_test.cpp 中“线程 + sleep_for”的周期打印改写为协程；
+ *  3. 一万个周期任务共享 4 个工作线程；
+ *  4. 协程中抛出的异常在 co_await / sync_wait 处重新抛出。
+ *
+ * 编译: g++ -std=c++20 -O2 -pthread task_test.cpp -o task_test
+ * @version : 1.0
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c), Richard Wang.
+ *
+ */
+
+#include <iostream>
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <set>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <utility>
+
+#include "task.hpp"
+
+typedef std::chrono::steady_clock clock_type;
+
+learning::task<int> get_age(int id)
+{
+    co_await learning::sleep_for(std::chrono::milliseconds(10));
+    co_return 11 + id * 3;
+}
+
+learning::task<std::pair<int, std::string>> get_record(int id, std::string name)
+{
+    int age = co_await get_age(id);
+    co_return std::make_pair(age, std::move(name));
+}
+
+/**
+ * @brief 协程之间的 co_await
+ */
+void basic_test(learning::scheduler &sched)
+{
+    std::cout << "------------- test co_await ------------------" << std::endl;
+    std::pair<int, std::string> r = learning::sync_wait(sched, get_record(2, "Jim"));
+    std::cout << "Name: " << r.second << ", Age:" << r.first << std::endl;
+}
+
+/**
+ * @brief lamba_test.cpp test 5 的协程版本：不再为每个对象占用一个线程
+ */
+void periodic_test(learning::scheduler &sched)
+{
+    std::cout << "------------- test periodic ------------------" << std::endl;
+    class test
+    {
+    public:
+        test(int _val) : val(_val) {}
+
+        learning::task<void> init(int ticks)
+        {
+            for (int i = 0; i < ticks; ++i)
+            {
+                co_await learning::sleep_for(std::chrono::milliseconds(100));
+                std::cout << val << std::endl;
+            }
+        }
+
+    private:
+        int val;
+    };
+
+    test t1(123);
+    test t2(456);
+    sched.spawn(t1.init(3));
+    sched.spawn(t2.init(2));
+    sched.wait_idle();
+}
+
+/**
+ * @brief count 个周期任务，每个执行 ticks 次、间隔 interval
+ */
+void scale_test(learning::scheduler &sched, int count, int ticks, std::chrono::milliseconds interval)
+{
+    std::cout << "------------- test scale ------------------" << std::endl;
+    std::atomic<long> total(0);
+    std::mutex m;
+    std::set<std::thread::id> threads;
+
+    /* lambda 对象在 wait_idle() 返回前一直有效，因此协程可以通过它访问按引用捕获的变量 */
+    auto activity = [&]() -> learning::task<void>
+    {
+        for (int i = 0; i < ticks; ++i)
+        {
+            co_await learning::sleep_for(interval);
+            ++total;
+        }
+        std::lock_guard<std::mutex> lock(m);
+        threads.insert(std::this_thread::get_id());
+    };
+
+    clock_type::time_point begin = clock_type::now();
+    for (int i = 0; i < count; ++i)
+    {
+        sched.spawn(activity());
+    }
+    sched.wait_idle();
+    const long long ms = std::chrono::duration_cast<std::chrono::milliseconds>(clock_type::now() - begin).count();
+
+    std::cout << count << " activities x " << ticks << " ticks of " << interval.count() << " ms: "
+              << total << " ticks in " << ms << " ms on " << threads.size() << " threads" << std::endl;
+}
+
+learning::task<int> failing()
+{
+    co_await learning::sleep_for(std::chrono::milliseconds(5));
+    throw std::runtime_error("record not found");
+}
+
+learning::task<int> caller()
+{
+    try
+    {
+        co_return co_await failing();
+    }
+    catch (const std::exception &e)
+    {
+        std::cout << "caught in coroutine: " << e.what() << std::endl;
+    }
+    co_return -1;
+}
+
+/**
+ * @brief 异常传递
+ */
+void error_test(learning::scheduler &sched)
+{
+    std::cout << "------------- test error ------------------" << std::endl;
+    const int ret = learning::sync_wait(sched, caller());
+    std::cout << "caller returned " << ret << std::endl;
+    try
+    {
+        learning::sync_wait(sched, failing());
+    }
+    catch (const std::exception &e)
+    {
+        std::cout << "caught in sync_wait: " << e.what() << std::endl;
+    }
+}
+
+int main()
+{
+    learning::scheduler sched(4);
+
+    /******************** basic_test() **************/
+    basic_test(sched);
+    /************************************************/
+
+    /****************** periodic_test() *************/
+    periodic_test(sched);
+    /************************************************/
+
+    /******************** scale_test() **************/
+    scale_test(sched, 10000, 5, std::chrono::milliseconds(20));
+    /************************************************/
+
+    /******************** error_test() **************/
+    error_test(sched);
+    /************************************************/
+
+    return 0;
+}
@@ -0,0 +1,707 @@
+/**
+ * @file external_sort.hpp
+ * @author Richard Wang
+ * @brief 外部归并排序：数据量超过内存时，分批排序写入临时文件再多路归并
+ *  1. 生成有序段(run)
+ *      push() 收集记录，估算内存占用达到 memory_budget 的一半时，把当前缓冲区交给后台线程
+ *      排序并写入临时文件(write-behind)，主线程继续用另一半预算收集下一批记录。
+ *  2. 多路归并
+ *      每个 run 由一个 run_reader 读取：后台线程(std::async)提前读取并解码下一个数据块(read-ahead)，
+ *      当前块消费完时下一块通常已经就绪。k 个 run 用败者树(loser tree)归并，每输出一条记录只需 log2(k) 次比较。
+ *      同时打开的 run 数(fan-in)受 memory_budget / (2 * block_size) 和 max_fan_in 限制，
+ *      run 太多时先归并成较长的 run 写回临时文件，再进行下一轮，直到剩余 run 数不超过 fan-in。
+ *  3. 记录格式
+ *      record_codec<T> 负责记录的二进制编码：算术类型按原始字节，std::string 为 32位长度 + 内容，
+ *      std::pair / std::tuple 逐字段递归。临时文件由 mkstemp 创建后立即 unlink，进程退出时自动回收。
+ *  4. 错误处理
+ *      文件读写失败时抛出 std::system_error。
+ * 若全部数据没有超过内存预算，则不会产生任何临时文件，直接在内存中排序输出。
+ * @version : 1.0
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c), Richard Wang.
+ *
+ */
+#ifndef EXTERNAL_SORT_HPP
+#define EXTERNAL_SORT_HPP
+
+#include <algorithm>
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <future>
+#include <iterator>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <stdlib.h>
+#include <unistd.h>
+
+namespace learning
+{
+
+/************************ 记录编码 ************************/
+
+template <class T, class Enable = void>
+struct record_codec;
+
+template <class T>
+struct record_codec<T, typename std::enable_if<std::is_arithmetic<T>::value || std::is_enum<T>::value>::type>
+{
+    static void write(std::string &out, const T &v) { out.append(reinterpret_cast<const char *>(&v), sizeof(T)); }
+
+    static void read(const char *&p, T &v)
+    {
+        std::memcpy(&v, p, sizeof(T));
+        p += sizeof(T);
+    }
+
+    /* 记录在对象本身之外占用的堆内存 */
+    static std::size_t heap_bytes(const T &) { return 0; }
+};
+
+template <>
+struct record_codec<std::string>
+{
+    static void write(std::string &out, const std::string &s)
+    {
+        const uint32_t len = static_cast<uint32_t>(s.size());
+        out.append(reinterpret_cast<const char *>(&len), sizeof(len));
+        out.append(s);
+    }
+
+    static void read(const char *&p, std::string &s)
+    {
+        uint32_t len;
+        std::memcpy(&len, p, sizeof(len));
+        p += sizeof(len);
+        s.assign(p, len);
+        p += len;
+    }
+
+    /* 超出短字符串优化(SSO)容量的部分才在堆上 */
+    static std::size_t heap_bytes(const std::string &s) { return s.capacity() > 15 ? s.capacity() + 1 : 0; }
+};
+
+template <class T1, class T2>
+struct record_codec<std::pair<T1, T2>>
+{
+    static void write(std::string &out, const std::pair<T1, T2> &v)
+    {
+        record_codec<T1>::write(out, v.first);
+        record_codec<T2>::write(out, v.second);
+    }
+
+    static void read(const char *&p, std::pair<T1, T2> &v)
+    {
+        record_codec<T1>::read(p, v.first);
+        record_codec<T2>::read(p, v.second);
+    }
+
+    static std::size_t heap_bytes(const std::pair<T1, T2> &v)
+    {
+        return record_codec<T1>::heap_bytes(v.first) + record_codec<T2>::heap_bytes(v.second);
+    }
+};
+
+template <class... Ts>
+struct record_codec<std::tuple<Ts...>>
+{
+    typedef std::tuple<Ts...> tuple_t;
+
+    static void write(std::string &out, const tuple_t &v) { write_impl(out, v, std::index_sequence_for<Ts...>()); }
+    static void read(const char *&p, tuple_t &v) { read_impl(p, v, std::index_sequence_for<Ts...>()); }
+    static std::size_t heap_bytes(const tuple_t &v) { return heap_impl(v, std::index_sequence_for<Ts...>()); }
+
+private:
+    template <std::size_t... I>
+    static void write_impl(std::string &out, const tuple_t &v, std::index_sequence<I...>)
+    {
+        int expand[] = {0, (record_codec<Ts>::write(out, std::get<I>(v)), 0)...};
+        (void)expand;
+    }
+
+    template <std::size_t... I>
+    static void read_impl(const char *&p, tuple_t &v, std::index_sequence<I...>)
+    {
+        int expand[] = {0, (record_codec<Ts>::read(p, std::get<I>(v)), 0)...};
+        (void)expand;
+    }
+
+    template <std::size_t... I>
+    static std::size_t heap_impl(const tuple_t &v, std::index_sequence<I...>)
+    {
+        std::size_t total = 0;
+        int expand[] = {0, (total += record_codec<Ts>::heap_bytes(std::get<I>(v)), 0)...};
+        (void)expand;
+        return total;
+    }
+};
+
+/************************ 配置与统计 ************************/
+
+struct external_sort_config
+{
+    std::size_t memory_budget = std::size_t(256) << 20; // 排序过程可使用的内存上限(估算值)
+    std::size_t block_size = std::size_t(1) << 20;      // 每次读写临时文件的数据块大小
+    std::size_t max_fan_in = 64;                        // 单轮归并同时打开的 run 数上限
+    std::string temp_dir = "/tmp";                      // 临时文件目录
+};
+
+struct external_sort_stats
+{
+    std::size_t records = 0;
+    std::size_t initial_runs = 0;
+    std::size_t merge_passes = 0;
+    std::size_t bytes_spilled = 0;
+};
+
+namespace detail
+{
+
+/**
+ * @brief 已 unlink 的临时文件；用 pwrite/pread 按偏移读写，多个 reader 可并发读取
+ */
+class spill_file
+{
+public:
+    explicit spill_file(const std::string &dir) : fd_(-1), size_(0)
+    {
+        std::string path = dir + "/external_sort_XXXXXX";
+        fd_ = ::mkstemp(&path[0]);
+        if (fd_ < 0)
+        {
+            throw std::system_error(errno, std::generic_category(), "external_sort: mkstemp " + path);
+        }
+        ::unlink(path.c_str());
+    }
+
+    ~spill_file()
+    {
+        if (fd_ >= 0)
+        {
+            ::close(fd_);
+        }
+    }
+
+    spill_file(const spill_file &) = delete;
+    spill_file &operator=(const spill_file &) = delete;
+
+    /* 预留一段空间并返回其偏移；实际写入可以在其他线程完成 */
+    uint64_t reserve(std::size_t bytes)
+    {
+        const uint64_t offset = size_;
+        size_ += bytes;
+        return offset;
+    }
+
+    void write_at(uint64_t offset, const char *data, std::size_t len)
+    {
+        while (len > 0)
+        {
+            const ssize_t n = ::pwrite(fd_, data, len, static_cast<off_t>(offset));
+            if (n < 0)
+            {
+                if (errno == EINTR)
+                {
+                    continue;
+                }
+                throw std::system_error(errno, std::generic_category(), "external_sort: pwrite");
+            }
+            data += n;
+            len -= static_cast<std::size_t>(n);
+            offset += static_cast<uint64_t>(n);
+        }
+    }
+
+    void read_at(uint64_t offset, char *data, std::size_t len) const
+    {
+        while (len > 0)
+        {
+            const ssize_t n = ::pread(fd_, data, len, static_cast<off_t>(offset));
+            if (n < 0 && errno == EINTR)
+            {
+                continue;
+            }
+            if (n <= 0)
+            {
+                throw std::system_error(n < 0 ? errno : EIO, std::generic_category(), "external_sort: pread");
+            }
+            data += n;
+            len -= static_cast<std::size_t>(n);
+            offset += static_cast<uint64_t>(n);
+        }
+    }
+
+private:
+    int fd_;
+    uint64_t size_;
+};
+
+/**
+ * @brief 一个有序段在临时文件中的位置；文件由 shared_ptr 管理，最后一个引用它的 run 消费完后关闭
+ */
+struct run_info
+{
+    std::shared_ptr<spill_file> file;
+    uint64_t offset;
+    uint64_t bytes;
+};
+
+/* 数据块格式: [uint64 负载字节数][uint64 记录数][记录...] */
+static const std::size_t kBlockHeader = 2 * sizeof(uint64_t);
+
+/**
+ * @brief 按块写出一个 run；块编码在调用线程完成，文件写入交给后台任务(write-behind)，
+ *  同一时刻最多一个块在写，因此额外内存只有一个块。
+ */
+template <class T>
+class run_writer
+{
+public:
+    run_writer(std::shared_ptr<spill_file> file, std::size_t block_size)
+        : file_(std::move(file)), block_size_(block_size), count_(0), start_(0), bytes_(0), started_(false)
+    {
+        block_.reserve(block_size_ + kBlockHeader);
+        block_.resize(kBlockHeader);
+    }
+
+    ~run_writer()
+    {
+        if (pending_.valid())
+        {
+            pending_.wait();
+        }
+    }
+
+    void write(const T &record)
+    {
+        record_codec<T>::write(block_, record);
+        ++count_;
+        if (block_.size() >= block_size_)
+        {
+            flush_block();
+        }
+    }
+
+    /* 写完最后一块并等待落盘，返回该 run 的位置 */
+    run_info finish()
+    {
+        if (count_ > 0)
+        {
+            flush_block();
+        }
+        if (pending_.valid())
+        {
+            pending_.get();
+        }
+        run_info info;
+        info.file = file_;
+        info.offset = start_;
+        info.bytes = bytes_;
+        return info;
+    }
+
+private:
+    void flush_block()
+    {
+        const uint64_t payload = block_.size() - kBlockHeader;
+        const uint64_t count = count_;
+        std::memcpy(&block_[0], &payload, sizeof(payload));
+        std::memcpy(&block_[sizeof(payload)], &count, sizeof(count));
+
+        const uint64_t offset = file_->reserve(block_.size());
+        if (!started_)
+        {
+            start_ = offset;
+            started_ = true;
+        }
+        bytes_ += block_.size();
+
+        if (pending_.valid())
+        {
+            pending_.get();
+        }
+        std::shared_ptr<std::string> data = std::make_shared<std::string>();
+        data->swap(block_);
+        std::shared_ptr<spill_file> file = file_;
+        pending_ = std::async(std::launch::async, [file, data, offset]()
+                              { file->write_at(offset, data->data(), data->size()); });
+
+        block_.reserve(block_size_ + kBlockHeader);
+        block_.resize(kBlockHeader);
+        count_ = 0;
+    }
+
+    std::shared_ptr<spill_file> file_;
+    std::size_t block_size_;
+    std::string block_;
+    std::size_t count_;
+    uint64_t start_;
+    uint64_t bytes_;
+    bool started_;
+    std::future<void> pending_;
+};
+
+/**
+ * @brief 顺序读取一个 run；后台任务提前读取并解码下一块(read-ahead)
+ */
+template <class T>
+class run_reader
+{
+public:
+    explicit run_reader(run_info run) : run_(std::move(run)), next_offset_(run_.offset), pos_(0)
+    {
+        prefetch();
+        advance_block();
+    }
+
+    run_reader(const run_reader &) = delete;
+    run_reader &operator=(const run_reader &) = delete;
+
+    ~run_reader()
+    {
+        if (next_.valid())
+        {
+            next_.wait();
+        }
+    }
+
+    bool valid() const { return pos_ < current_.size(); }
+    T &current() { return current_[pos_]; }
+
+    void advance()
+    {
+        if (++pos_ == current_.size())
+        {
+            advance_block();
+        }
+    }
+
+private:
+    void advance_block()
+    {
+        current_.clear();
+        pos_ = 0;
+        if (next_.valid())
+        {
+            current_ = next_.get();
+            prefetch();
+        }
+    }
+
+    void prefetch()
+    {
+        const uint64_t end = run_.offset + run_.bytes;
+        if (next_offset_ >= end)
+        {
+            return;
+        }
+        std::shared_ptr<spill_file> file = run_.file;
+        const uint64_t offset = next_offset_;
+        uint64_t header[2];
+        file->read_at(offset, reinterpret_cast<char *>(header), sizeof(header));
+        next_offset_ += kBlockHeader + header[0];
+
+        const uint64_t payload = header[0];
+        const uint64_t count = header[1];
+        next_ = std::async(std::launch::async, [file, offset, payload, count]()
+                           {
+                               std::string buf(payload, '\0');
+                               file->read_at(offset + kBlockHeader, &buf[0], payload);
+                               std::vector<T> records(count);
+                               const char *p = buf.data();
+                               for (T &r : records)
+                               {
+                                   record_codec<T>::read(p, r);
+                               }
+                               return records;
+                           });
+    }
+
+    run_info run_;
+    uint64_t next_offset_;
+    std::vector<T> current_;
+    std::size_t pos_;
+    std::future<std::vector<T>> next_;
+};
+
+/**
+ * @brief 败者树：内部节点保存本场比赛的败者，tree_[0] 保存总冠军；
+ *  冠军所在 run 前进一步后，只需沿该叶子到根的路径重赛一次。
+ */
+template <class T, class Compare>
+class loser_tree
+{
+public:
+    loser_tree(std::vector<std::unique_ptr<run_reader<T>>> &sources, Compare comp)
+        : sources_(sources), k_(sources.size()), tree_(sources.size() > 0 ? sources.size() : 1), comp_(comp)
+    {
+        tree_[0] = k_ <= 1 ? 0 : build(1);
+    }
+
+    bool empty() const { return k_ == 0 || !sources_[tree_[0]]->valid(); }
+    T &top() { return sources_[tree_[0]]->current(); }
+
+    void pop()
+    {
+        std::size_t winner = tree_[0];
+        sources_[winner]->advance();
+        for (std::size_t node = (winner + k_) / 2; node >= 1; node /= 2)
+        {
+            if (beats(tree_[node], winner))
+            {
+                std::swap(tree_[node], winner);
+            }
+        }
+        tree_[0] = winner;
+    }
+
+private:
+    /* 叶子 i 位于隐式完全二叉树的 k+i 处，返回子树的冠军 */
+    std::size_t build(std::size_t node)
+    {
+        if (node >= k_)
+        {
+            return node - k_;
+        }
+        const std::size_t l = build(2 * node);
+        const std::size_t r = build(2 * node + 1);
+        if (beats(l, r))
+        {
+            tree_[node] = r;
+            return l;
+        }
+        tree_[node] = l;
+        return r;
+    }
+
+    /* 已耗尽的 run 视为无穷大；相等时下标小的 run 获胜 */
+    bool beats(std::size_t a, std::size_t b)
+    {
+        if (!sources_[a]->valid())
+        {
+            return false;
+        }
+        if (!sources_[b]->valid())
+        {
+            return true;
+        }
+        if (comp_(sources_[a]->current(), sources_[b]->current()))
+        {
+            return true;
+        }
+        return !comp_(sources_[b]->current(), sources_[a]->current()) && a < b;
+    }
+
+    std::vector<std::unique_ptr<run_reader<T>>> &sources_;
+    std::size_t k_;
+    std::vector<std::size_t> tree_;
+    Compare comp_;
+};
+
+} // namespace detail
+
+/**
+ * @brief 外部排序器
+ *  external_sorter<std::tuple<int, std::string, int>> sorter(comp, config);
+ *  for (...) sorter.push(record);
+ *  sorter.finish([](std::tuple<int, std::string, int> &&r) { ... });
+ */
+template <class T, class Compare = std::less<T>>
+class external_sorter
+{
+public:
+    explicit external_sorter(Compare comp = Compare(), external_sort_config config = external_sort_config())
+        : comp_(comp), config_(std::move(config)), buffer_bytes_(0)
+    {
+        if (config_.block_size == 0 || config_.memory_budget < 4 * config_.block_size)
+        {
+            throw std::invalid_argument("external_sort: memory_budget must hold at least 4 blocks");
+        }
+    }
+
+    ~external_sorter()
+    {
+        if (pending_spill_.valid())
+        {
+            pending_spill_.wait();
+        }
+    }
+
+    void push(const T &record) { push(T(record)); }
+
+    void push(T &&record)
+    {
+        buffer_bytes_ += sizeof(T) + record_codec<T>::heap_bytes(record);
+        buffer_.push_back(std::move(record));
+        ++stats_.records;
+        /* 一半预算用于正在收集的缓冲区，另一半留给后台正在排序写盘的上一批 */
+        if (buffer_bytes_ >= config_.memory_budget / 2)
+        {
+            spill();
+        }
+    }
+
+    template <class InputIt>
+    void push(InputIt first, InputIt last)
+    {
+        for (; first != last; ++first)
+        {
+            push(*first);
+        }
+    }
+
+    /**
+     * @brief 结束输入，按顺序把所有记录交给 sink(T&&)
+     */
+    template <class Sink>
+    void finish(Sink sink)
+    {
+        if (runs_.empty() && !pending_spill_.valid())
+        {
+            std::sort(buffer_.begin(), buffer_.end(), comp_);
+            for (T &r : buffer_)
+            {
+                sink(std::move(r));
+            }
+            reset_buffer();
+            return;
+        }
+
+        if (!buffer_.empty())
+        {
+            spill();
+        }
+        wait_spill();
+        stats_.initial_runs = runs_.size();
+
+        const std::size_t fan_in = std::max<std::size_t>(2, std::min(config_.max_fan_in, config_.memory_budget / (2 * config_.block_size)));
+        while (runs_.size() > fan_in)
+        {
+            merge_pass(fan_in);
+        }
+
+        std::vector<std::unique_ptr<detail::run_reader<T>>> readers;
+        for (detail::run_info &run : runs_)
+        {
+            readers.emplace_back(new detail::run_reader<T>(std::move(run)));
+        }
+        runs_.clear();
+        detail::loser_tree<T, Compare> tree(readers, comp_);
+        for (; !tree.empty(); tree.pop())
+        {
+            sink(std::move(tree.top()));
+        }
+    }
+
+    const external_sort_stats &stats() const { return stats_; }
+
+private:
+    void reset_buffer()
+    {
+        std::vector<T>().swap(buffer_);
+        buffer_bytes_ = 0;
+    }
+
+    /* 把当前缓冲区交给后台线程排序并写成一个 run */
+    void spill()
+    {
+        wait_spill();
+        if (!spill_file_)
+        {
+            spill_file_ = std::make_shared<detail::spill_file>(config_.temp_dir);
+        }
+        std::shared_ptr<std::vector<T>> batch = std::make_shared<std::vector<T>>();
+        batch->swap(buffer_);
+        reset_buffer();
+
+        std::shared_ptr<detail::spill_file> file = spill_file_;
+        const std::size_t block_size = config_.block_size;
+        Compare comp = comp_;
+        pending_spill_ = std::async(std::launch::async, [batch, file, block_size, comp]()
+                                    {
+                                        std::sort(batch->begin(), batch->end(), comp);
+                                        detail::run_writer<T> writer(file, block_size);
+                                        for (const T &r : *batch)
+                                        {
+                                            writer.write(r);
+                                        }
+                                        return writer.finish();
+                                    });
+    }
+
+    void wait_spill()
+    {
+        if (pending_spill_.valid())
+        {
+            detail::run_info run = pending_spill_.get();
+            stats_.bytes_spilled += run.bytes;
+            runs_.push_back(std::move(run));
+        }
+    }
+
+    /* 每 fan_in 个 run 归并成一个新 run，写入新的临时文件 */
+    void merge_pass(std::size_t fan_in)
+    {
+        std::shared_ptr<detail::spill_file> out = std::make_shared<detail::spill_file>(config_.temp_dir);
+        std::vector<detail::run_info> merged;
+        for (std::size_t i = 0; i < runs_.size(); i += fan_in)
+        {
+            const std::size_t end = std::min(runs_.size(), i + fan_in);
+            std::vector<std::unique_ptr<detail::run_reader<T>>> readers;
+            for (std::size_t j = i; j < end; ++j)
+            {
+                readers.emplace_back(new detail::run_reader<T>(std::move(runs_[j])));
+            }
+            detail::loser_tree<T, Compare> tree(readers, comp_);
+            detail::run_writer<T> writer(out, config_.block_size);
+            for (; !tree.empty(); tree.pop())
+            {
+                writer.write(tree.top());
+            }
+            detail::run_info run = writer.finish();
+            stats_.bytes_spilled += run.bytes;
+            merged.push_back(std::move(run));
+        }
+        runs_.swap(merged);
+        spill_file_.reset();
+        ++stats_.merge_passes;
+    }
+
+    Compare comp_;
+    external_sort_config config_;
+    std::vector<T> buffer_;
+    std::size_t buffer_bytes_;
+    std::shared_ptr<detail::spill_file> spill_file_;
+    std::future<detail::run_info> pending_spill_;
+    std::vector<detail::run_info> runs_;
+    external_sort_stats stats_;
+};
+
+/**
+ * @brief 便捷接口：对 [first, last) 做外部排序，结果依次写入 out
+ */
+template <class InputIt, class OutputIt, class Compare>
+OutputIt external_sort(InputIt first, InputIt last, OutputIt out, Compare comp,
+                       external_sort_config config = external_sort_config())
+{
+    typedef typename std::iterator_traits<InputIt>::value_type value_t;
+    external_sorter<value_t, Compare> sorter(comp, std::move(config));
+    sorter.push(first, last);
+    sorter.finish([&out](value_t &&r)
+                  { *out++ = std::move(r); });
+    return out;
+}
+
+} // namespace learning
+
+#endif // EXTERNAL_SORT_HPP
@@ -0,0 +1,100 @@
+/**
+ * @file external_sort_test.cpp
+ * @author Richard Wang
+ * @brief 外部归并排序示例
+ *  1. 数据量小于内存预算时，external_sort 退化为内存排序；
+ *  2. 把内存预算压到 4MB，对 100万条 std::tuple<int, std::string, int> 记录排序，
+ *     观察产生的 run 数、归并轮数和溢写字节数，并与 std::sort 的结果比对。
+ *
+ * 编译: g++ -std=c++14 -O2 -pthread external_sort_test.cpp -o external_sort_test
+ * @version : 1.0
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c), Richard Wang.
+ *
+ */
+
+#include <iostream>
+#include <algorithm>
+#include <chrono>
+#include <iterator>
+#include <random>
+#include <string>
+#include <tuple>
+#include <vector>
+
+#include "external_sort.hpp"
+
+typedef std::tuple<int, std::string, int> user_t;
+
+/**
+ * @brief 数据量很小，不会产生临时文件
+ */
+void in_memory_test()
+{
+    std::cout << "------------- test in memory ------------------" << std::endl;
+    std::vector<int> val_list = {3, 2, 1, 5, 4, 6};
+    std::vector<int> sorted;
+    learning::external_sort(val_list.begin(), val_list.end(), std::back_inserter(sorted),
+                            [](int a, int b) -> bool
+                            { return a < b; });
+
+    std::cout << "[Sort  After]:";
+    for_each(sorted.begin(), sorted.end(), [](int val)
+             { std::cout << val << " "; });
+    std::cout << std::endl;
+}
+
+/**
+ * @brief 内存预算远小于数据量，需要溢写与多轮归并
+ */
+void spill_test()
+{
+    std::cout << "------------- test spill ------------------" << std::endl;
+    const char *names[] = {"Richard", "Jack", "Simth", "Mark", "Rose", "Jim", "Amy", "Lucy"};
+    std::mt19937 rng(3);
+    std::vector<user_t> userList;
+    userList.reserve(1000000);
+    for (std::size_t i = 0; i < 1000000; ++i)
+    {
+        userList.emplace_back(static_cast<int>(rng() % 100), std::string(names[rng() % 8]) + "_" + std::to_string(rng()),
+                              static_cast<int>(150 + rng() % 60));
+    }
+
+    learning::external_sort_config config;
+    config.memory_budget = 4 << 20;
+    config.block_size = 256 << 10;
+    config.max_fan_in = 8;
+
+    auto cmp = [](const user_t &a, const user_t &b) -> bool
+    { return a < b; };
+    learning::external_sorter<user_t, decltype(cmp)> sorter(cmp, config);
+
+    std::chrono::steady_clock::time_point t0 = std::chrono::steady_clock::now();
+    sorter.push(userList.begin(), userList.end());
+    std::vector<user_t> result;
+    result.reserve(userList.size());
+    sorter.finish([&result](user_t &&user)
+                  { result.push_back(std::move(user)); });
+    std::chrono::steady_clock::time_point t1 = std::chrono::steady_clock::now();
+
+    std::sort(userList.begin(), userList.end(), cmp);
+    const learning::external_sort_stats &stats = sorter.stats();
+    std::cout << "records: " << stats.records << ", initial runs: " << stats.initial_runs
+              << ", merge passes: " << stats.merge_passes << ", spilled: " << (stats.bytes_spilled >> 20) << " MB" << std::endl;
+    std::cout << "external sort: " << std::chrono::duration_cast<std::chrono::milliseconds>(t1 - t0).count() << " ms" << std::endl;
+    std::cout << "same as std::sort: " << (result == userList) << std::endl;
+}
+
+int main()
+{
+    /***************** in_memory_test() *************/
+    in_memory_test();
+    /************************************************/
+
+    /******************* spill_test() ***************/
+    spill_test();
+    /************************************************/
+
+    return 0;
+}
@@ -0,0 +1,758 @@
+/**
+ * @file flat_hash_map.hpp
+ * @author Richard Wang
+ * @brief 开放寻址 + SIMD 分组探测的扁平哈希表(Swiss Table 风格)
+ *  1. 内存布局
+ *      ctrl_  : 每个槽位一个控制字节；最高位为1表示空(kEmpty)或已删除(kDeleted)，为0时低7位保存哈希值的 H2 部分。
+ *      slots_ : 与控制字节一一对应的连续数组，直接存放元素，没有链表节点。
+ *               槽位是 std::pair<const K, V> 与 std::pair<K, V> 的联合体：对外只暴露前者，
+ *               两者布局兼容时内部按后者构造和移动，rehash 时键也被移动而不是复制(与 Abseil 的做法相同)。
+ *  2. 查找过程
+ *      哈希值拆分为 H1(高57位，决定从哪个分组开始探测) 和 H2(低7位，存入控制字节)。
+ *      每次载入16个控制字节，用一条 SSE2 比较指令同时找出所有 H2 相同的候选槽位，只对候选槽位比较键；
+ *      分组内只要出现空槽位就说明键不存在，探测结束。分组之间按三角数序列(1,2,3...)跳跃。
+ *  3. 容量控制
+ *      容量总是2的幂且不小于16；最大负载因子为 7/8。reserve(n) 保证插入n个元素期间不会再发生 rehash。
+ *      rehash 先算出所有元素的新位置，再搬动元素：K、V 的移动构造不抛异常时移动，否则复制；
+ *      哈希函数或复制抛出异常时表保持原样(强异常安全)。
+ *  4. 异构查找
+ *      默认的 tuple_hash / key_equal 都是 transparent 的，find/contains/count/erase 可以直接接受
+ *      std::tuple<int, const char*>、std::tuple<int, std::string_view> 这样的“视图键”，不需要构造 std::string。
+ * @version : 1.0
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c), Richard Wang.
+ *
+ */
+#ifndef FLAT_HASH_MAP_HPP
+#define FLAT_HASH_MAP_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <initializer_list>
+#include <iterator>
+#include <new>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+#include "tuple_hash.hpp"
+
+namespace learning
+{
+
+namespace swiss
+{
+
+typedef int8_t ctrl_t;
+static const ctrl_t kEmpty = -128;  // 0b10000000
+static const ctrl_t kDeleted = -2;  // 0b11111110
+static const std::size_t kGroupWidth = 16;
+
+inline bool is_full(ctrl_t c) { return c >= 0; }
+
+/**
+ * @brief 槽位：对外是 value(键为 const)，内部在布局兼容时通过 mutable_value 构造、移动和析构
+ */
+template <class K, class V>
+union map_slot
+{
+    map_slot() {}
+    ~map_slot() {}
+
+    std::pair<const K, V> value;
+    std::pair<K, V> mutable_value;
+};
+
+/* 两种 pair 的大小、对齐与成员偏移都相同时，才能通过 mutable_value 改写键 */
+template <class K, class V>
+struct mutable_keys
+{
+    typedef std::pair<const K, V> value_type;
+    typedef std::pair<K, V> mutable_type;
+
+    static const bool value = std::is_standard_layout<value_type>::value && std::is_standard_layout<mutable_type>::value &&
+                              sizeof(value_type) == sizeof(mutable_type) && alignof(value_type) == alignof(mutable_type);
+};
+
+/**
+ * @brief 16个控制字节组成的一个分组；每个 match 返回一个16位掩码，第i位为1表示第i个槽位命中
+ */
+struct group
+{
+#if defined(__SSE2__)
+    __m128i ctrl;
+
+    explicit group(const ctrl_t *pos) : ctrl(_mm_loadu_si128(reinterpret_cast<const __m128i *>(pos))) {}
+
+    uint32_t match(ctrl_t h2) const
+    {
+        return static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_set1_epi8(h2), ctrl)));
+    }
+
+    uint32_t match_empty() const { return match(kEmpty); }
+
+    /* 空槽位与已删除槽位的最高位都是1，movemask 正好取出每个字节的最高位 */
+    uint32_t match_empty_or_deleted() const { return static_cast<uint32_t>(_mm_movemask_epi8(ctrl)); }
+#else
+    const ctrl_t *ctrl;
+
+    explicit group(const ctrl_t *pos) : ctrl(pos) {}
+
+    uint32_t match(ctrl_t h2) const
+    {
+        uint32_t mask = 0;
+        for (std::size_t i = 0; i < kGroupWidth; ++i)
+        {
+            mask |= static_cast<uint32_t>(ctrl[i] == h2) << i;
+        }
+        return mask;
+    }
+
+    uint32_t match_empty() const { return match(kEmpty); }
+
+    uint32_t match_empty_or_deleted() const
+    {
+        uint32_t mask = 0;
+        for (std::size_t i = 0; i < kGroupWidth; ++i)
+        {
+            mask |= static_cast<uint32_t>(ctrl[i] < 0) << i;
+        }
+        return mask;
+    }
+#endif
+};
+
+inline unsigned lowest_bit(uint32_t mask) { return static_cast<unsigned>(__builtin_ctz(mask)); }
+
+inline std::size_t h1(std::size_t hash) { return hash >> 7; }
+inline ctrl_t h2(std::size_t hash) { return static_cast<ctrl_t>(hash & 0x7F); }
+
+/* 容纳n个元素且负载不超过 7/8 所需的最小容量(2的幂，至少一个分组) */
+inline std::size_t capacity_for(std::size_t n)
+{
+    std::size_t need = n + (n + 6) / 7;
+    std::size_t cap = kGroupWidth;
+    while (cap < need)
+    {
+        cap <<= 1;
+    }
+    return cap;
+}
+
+} // namespace swiss
+
+template <class K, class V, class Hash = tuple_hash, class KeyEqual = key_equal>
+class flat_hash_map
+{
+public:
+    typedef K key_type;
+    typedef V mapped_type;
+    typedef std::pair<const K, V> value_type;
+    typedef std::size_t size_type;
+    typedef Hash hasher;
+    typedef KeyEqual key_equal_type;
+
+    template <bool Const>
+    class iterator_base
+    {
+        friend class flat_hash_map;
+        typedef typename std::conditional<Const, const std::pair<const K, V>, std::pair<const K, V>>::type elem_t;
+        typedef typename std::conditional<Const, const swiss::map_slot<K, V>, swiss::map_slot<K, V>>::type slot_t;
+
+    public:
+        typedef std::forward_iterator_tag iterator_category;
+        typedef std::pair<const K, V> value_type;
+        typedef std::ptrdiff_t difference_type;
+        typedef elem_t *pointer;
+        typedef elem_t &reference;
+
+        iterator_base() : ctrl_(nullptr), slot_(nullptr), end_(nullptr) {}
+
+        /* 允许 iterator 隐式转换为 const_iterator */
+        template <bool C, class = typename std::enable_if<Const && !C>::type>
+        iterator_base(const iterator_base<C> &other) : ctrl_(other.ctrl_), slot_(other.slot_), end_(other.end_) {}
+
+        reference operator*() const { return slot_->value; }
+        pointer operator->() const { return &slot_->value; }
+
+        iterator_base &operator++()
+        {
+            ++ctrl_;
+            ++slot_;
+            skip_empty();
+            return *this;
+        }
+
+        iterator_base operator++(int)
+        {
+            iterator_base tmp(*this);
+            ++*this;
+            return tmp;
+        }
+
+        friend bool operator==(const iterator_base &a, const iterator_base &b) { return a.slot_ == b.slot_; }
+        friend bool operator!=(const iterator_base &a, const iterator_base &b) { return a.slot_ != b.slot_; }
+
+    private:
+        template <bool>
+        friend class iterator_base;
+
+        iterator_base(const swiss::ctrl_t *ctrl, slot_t *slot, const swiss::ctrl_t *end)
+            : ctrl_(ctrl), slot_(slot), end_(end) {}
+
+        void skip_empty()
+        {
+            while (ctrl_ != end_ && !swiss::is_full(*ctrl_))
+            {
+                ++ctrl_;
+                ++slot_;
+            }
+        }
+
+        const swiss::ctrl_t *ctrl_;
+        slot_t *slot_;
+        const swiss::ctrl_t *end_;
+    };
+
+    typedef iterator_base<false> iterator;
+    typedef iterator_base<true> const_iterator;
+
+    flat_hash_map() : ctrl_(nullptr), slots_(nullptr), capacity_(0), size_(0), growth_left_(0) {}
+
+    explicit flat_hash_map(size_type n, const Hash &hash = Hash(), const KeyEqual &eq = KeyEqual())
+        : flat_hash_map()
+    {
+        hash_ = hash;
+        eq_ = eq;
+        reserve(n);
+    }
+
+    template <class InputIt>
+    flat_hash_map(InputIt first, InputIt last) : flat_hash_map()
+    {
+        insert(first, last);
+    }
+
+    flat_hash_map(std::initializer_list<value_type> init) : flat_hash_map()
+    {
+        reserve(init.size());
+        insert(init.begin(), init.end());
+    }
+
+    flat_hash_map(const flat_hash_map &other) : flat_hash_map()
+    {
+        hash_ = other.hash_;
+        eq_ = other.eq_;
+        reserve(other.size_);
+        for (const value_type &v : other)
+        {
+            insert_unique_no_grow(hash_(v.first), v);
+        }
+    }
+
+    flat_hash_map(flat_hash_map &&other) noexcept : flat_hash_map()
+    {
+        swap(other);
+    }
+
+    flat_hash_map &operator=(const flat_hash_map &other)
+    {
+        if (this != &other)
+        {
+            flat_hash_map tmp(other);
+            swap(tmp);
+        }
+        return *this;
+    }
+
+    flat_hash_map &operator=(flat_hash_map &&other) noexcept
+    {
+        if (this != &other)
+        {
+            destroy();
+            swap(other);
+        }
+        return *this;
+    }
+
+    ~flat_hash_map() { destroy(); }
+
+    void swap(flat_hash_map &other) noexcept
+    {
+        using std::swap;
+        swap(ctrl_, other.ctrl_);
+        swap(slots_, other.slots_);
+        swap(capacity_, other.capacity_);
+        swap(size_, other.size_);
+        swap(growth_left_, other.growth_left_);
+        swap(hash_, other.hash_);
+        swap(eq_, other.eq_);
+    }
+
+    /************************ 迭代器 ************************/
+    iterator begin()
+    {
+        iterator it(ctrl_, slots_, ctrl_ + capacity_);
+        it.skip_empty();
+        return it;
+    }
+    iterator end() { return iterator(ctrl_ + capacity_, slots_ + capacity_, ctrl_ + capacity_); }
+    const_iterator begin() const { return const_cast<flat_hash_map *>(this)->begin(); }
+    const_iterator end() const { return const_cast<flat_hash_map *>(this)->end(); }
+    const_iterator cbegin() const { return begin(); }
+    const_iterator cend() const { return end(); }
+
+    /************************ 容量 ************************/
+    bool empty() const { return size_ == 0; }
+    size_type size() const { return size_; }
+    size_type capacity() const { return capacity_; }
+    size_type bucket_count() const { return capacity_; }
+    float load_factor() const { return capacity_ == 0 ? 0.0f : static_cast<float>(size_) / capacity_; }
+    float max_load_factor() const { return 7.0f / 8.0f; }
+
+    /**
+     * @brief 预留空间，保证之后插入n个元素不会触发 rehash
+     */
+    void reserve(size_type n)
+    {
+        if (n > size_ + growth_left_)
+        {
+            resize(swiss::capacity_for(n));
+        }
+    }
+
+    /**
+     * @brief 把容量调整为至少n个槽位(同时满足当前元素数的负载要求)；rehash(0) 相当于 shrink_to_fit
+     */
+    void rehash(size_type n)
+    {
+        if (n == 0 && size_ == 0)
+        {
+            destroy();
+            return;
+        }
+        size_type cap = swiss::capacity_for(size_);
+        while (cap < n)
+        {
+            cap <<= 1;
+        }
+        resize(cap);
+    }
+
+    void clear()
+    {
+        for (size_type i = 0; i < capacity_; ++i)
+        {
+            if (swiss::is_full(ctrl_[i]))
+            {
+                destroy_slot(slots_ + i);
+            }
+        }
+        if (capacity_ > 0)
+        {
+            std::memset(ctrl_, static_cast<unsigned char>(swiss::kEmpty), capacity_);
+        }
+        size_ = 0;
+        growth_left_ = max_size_for(capacity_);
+    }
+
+    /************************ 查找 ************************/
+    template <class Q>
+    iterator find(const Q &key)
+    {
+        size_type idx = find_index(key, hash_(key));
+        return idx == capacity_ ? end() : iterator_at(idx);
+    }
+
+    template <class Q>
+    const_iterator find(const Q &key) const { return const_cast<flat_hash_map *>(this)->find(key); }
+
+    template <class Q>
+    bool contains(const Q &key) const { return find_index(key, hash_(key)) != capacity_; }
+
+    template <class Q>
+    size_type count(const Q &key) const { return contains(key) ? 1 : 0; }
+
+    V &at(const K &key)
+    {
+        size_type idx = find_index(key, hash_(key));
+        if (idx == capacity_)
+        {
+            throw std::out_of_range("flat_hash_map::at");
+        }
+        return slots_[idx].value.second;
+    }
+
+    const V &at(const K &key) const { return const_cast<flat_hash_map *>(this)->at(key); }
+
+    V &operator[](const K &key) { return try_emplace(key).first->second; }
+    V &operator[](K &&key) { return try_emplace(std::move(key)).first->second; }
+
+    /************************ 插入 ************************/
+    template <class KK, class... Args>
+    std::pair<iterator, bool> try_emplace(KK &&key, Args &&...args)
+    {
+        std::size_t hash = hash_(key);
+        size_type idx = find_index(key, hash);
+        if (idx != capacity_)
+        {
+            return std::make_pair(iterator_at(idx), false);
+        }
+        idx = prepare_insert(hash);
+        try
+        {
+            construct_slot(slots_ + idx, std::piecewise_construct, std::forward_as_tuple(std::forward<KK>(key)),
+                           std::forward_as_tuple(std::forward<Args>(args)...));
+        }
+        catch (...)
+        {
+            /* 元素构造失败：撤销 prepare_insert 占用的槽位 */
+            unprepare_insert(idx);
+            throw;
+        }
+        return std::make_pair(iterator_at(idx), true);
+    }
+
+    std::pair<iterator, bool> insert(const value_type &v) { return try_emplace(v.first, v.second); }
+
+    template <class P, class = typename std::enable_if<std::is_constructible<value_type, P &&>::value>::type>
+    std::pair<iterator, bool> insert(P &&v)
+    {
+        return emplace(std::forward<P>(v));
+    }
+
+    template <class InputIt>
+    void insert(InputIt first, InputIt last)
+    {
+        for (; first != last; ++first)
+        {
+            emplace(*first);
+        }
+    }
+
+    /* emplace 需要先构造出元素才能拿到键，键已存在时该元素被丢弃；已知键时优先使用 try_emplace */
+    template <class... Args>
+    std::pair<iterator, bool> emplace(Args &&...args)
+    {
+        std::pair<K, V> tmp(std::forward<Args>(args)...); // 键不是 const，可以移动进 try_emplace
+        return try_emplace(std::move(tmp.first), std::move(tmp.second));
+    }
+
+    template <class M>
+    std::pair<iterator, bool> insert_or_assign(const K &key, M &&obj)
+    {
+        std::pair<iterator, bool> res = try_emplace(key, std::forward<M>(obj));
+        if (!res.second)
+        {
+            res.first->second = std::forward<M>(obj);
+        }
+        return res;
+    }
+
+    /************************ 删除 ************************/
+    template <class Q>
+    size_type erase(const Q &key)
+    {
+        size_type idx = find_index(key, hash_(key));
+        if (idx == capacity_)
+        {
+            return 0;
+        }
+        erase_at(idx);
+        return 1;
+    }
+
+    iterator erase(const_iterator pos)
+    {
+        size_type idx = static_cast<size_type>(pos.ctrl_ - ctrl_);
+        erase_at(idx);
+        iterator it = iterator_at(idx);
+        it.skip_empty();
+        return it;
+    }
+
+    hasher hash_function() const { return hash_; }
+    key_equal_type key_eq() const { return eq_; }
+
+private:
+    typedef swiss::map_slot<K, V> slot_type;
+    static const bool kMutableKeys = swiss::mutable_keys<K, V>::value;
+
+    /* 搬动元素时 K、V 的移动构造都不抛异常才移动，否则复制，保证失败时旧表不受影响 */
+    static const bool kMoveOnRelocate = std::is_nothrow_move_constructible<K>::value && std::is_nothrow_move_constructible<V>::value;
+
+    static size_type max_size_for(size_type cap) { return cap - cap / 8; }
+
+    iterator iterator_at(size_type idx) { return iterator(ctrl_ + idx, slots_ + idx, ctrl_ + capacity_); }
+
+    template <class Q>
+    size_type find_index(const Q &key, std::size_t hash) const
+    {
+        if (capacity_ == 0)
+        {
+            return capacity_;
+        }
+        const size_type group_mask = capacity_ / swiss::kGroupWidth - 1;
+        size_type g = swiss::h1(hash) & group_mask;
+        const swiss::ctrl_t tag = swiss::h2(hash);
+        for (size_type step = 1;; ++step)
+        {
+            const size_type base = g * swiss::kGroupWidth;
+            swiss::group grp(ctrl_ + base);
+            for (uint32_t m = grp.match(tag); m != 0; m &= m - 1)
+            {
+                const size_type idx = base + swiss::lowest_bit(m);
+                if (eq_(slots_[idx].value.first, key))
+                {
+                    return idx;
+                }
+            }
+            if (grp.match_empty() != 0)
+            {
+                return capacity_;
+            }
+            g = (g + step) & group_mask;
+        }
+    }
+
+    /* 沿探测序列找到第一个空槽位或已删除槽位 */
+    size_type find_insert_slot(std::size_t hash) const { return find_insert_slot(ctrl_, capacity_, hash); }
+
+    static size_type find_insert_slot(const swiss::ctrl_t *ctrl, size_type capacity, std::size_t hash)
+    {
+        const size_type group_mask = capacity / swiss::kGroupWidth - 1;
+        size_type g = swiss::h1(hash) & group_mask;
+        for (size_type step = 1;; ++step)
+        {
+            const size_type base = g * swiss::kGroupWidth;
+            uint32_t m = swiss::group(ctrl + base).match_empty_or_deleted();
+            if (m != 0)
+            {
+                return base + swiss::lowest_bit(m);
+            }
+            g = (g + step) & group_mask;
+        }
+    }
+
+    /* 返回可用于构造新元素的槽位，必要时先扩容或清理墓碑 */
+    size_type prepare_insert(std::size_t hash)
+    {
+        if (capacity_ == 0)
+        {
+            resize(swiss::kGroupWidth);
+        }
+        size_type idx = find_insert_slot(hash);
+        if (growth_left_ == 0 && ctrl_[idx] == swiss::kEmpty)
+        {
+            /* 墓碑占了超过一半的可用空间时原地重建即可，否则容量翻倍 */
+            resize(size_ * 2 < max_size_for(capacity_) ? capacity_ : capacity_ * 2);
+            idx = find_insert_slot(hash);
+        }
+        if (ctrl_[idx] == swiss::kEmpty)
+        {
+            --growth_left_;
+        }
+        ctrl_[idx] = swiss::h2(hash);
+        ++size_;
+        return idx;
+    }
+
+    /* prepare_insert 的逆操作：槽位中还没有构造元素 */
+    void unprepare_insert(size_type idx)
+    {
+        --size_;
+        const size_type base = idx & ~(swiss::kGroupWidth - 1);
+        if (swiss::group(ctrl_ + base).match_empty() != 0)
+        {
+            ctrl_[idx] = swiss::kEmpty;
+            ++growth_left_;
+        }
+        else
+        {
+            ctrl_[idx] = swiss::kDeleted;
+        }
+    }
+
+    template <class... Args>
+    static void construct_slot(slot_type *slot, Args &&...args)
+    {
+        construct_slot(std::integral_constant<bool, kMutableKeys>(), slot, std::forward<Args>(args)...);
+    }
+
+    template <class... Args>
+    static void construct_slot(std::true_type, slot_type *slot, Args &&...args)
+    {
+        new (&slot->mutable_value) std::pair<K, V>(std::forward<Args>(args)...);
+    }
+
+    template <class... Args>
+    static void construct_slot(std::false_type, slot_type *slot, Args &&...args)
+    {
+        new (&slot->value) value_type(std::forward<Args>(args)...);
+    }
+
+    static void destroy_slot(slot_type *slot) noexcept
+    {
+        destroy_slot(std::integral_constant<bool, kMutableKeys>(), slot);
+    }
+
+    static void destroy_slot(std::true_type, slot_type *slot) noexcept { slot->mutable_value.~pair(); }
+    static void destroy_slot(std::false_type, slot_type *slot) noexcept { slot->value.~value_type(); }
+
+    /* 把 from 中的元素复制或移动到 to；from 保持构造状态，由调用者析构 */
+    static void relocate_slot(slot_type *to, slot_type *from)
+    {
+        relocate_slot(std::integral_constant<bool, kMutableKeys && kMoveOnRelocate>(), to, from);
+    }
+
+    static void relocate_slot(std::true_type, slot_type *to, slot_type *from)
+    {
+        new (&to->mutable_value) std::pair<K, V>(std::move(from->mutable_value));
+    }
+
+    /* 键不可变或移动可能抛异常：复制键；值的移动不抛异常时仍然移动(键先构造，复制键失败时值未被改动) */
+    static void relocate_slot(std::false_type, slot_type *to, slot_type *from)
+    {
+        if (std::is_nothrow_move_constructible<V>::value)
+        {
+            construct_slot(to, from->value.first, std::move(from->value.second));
+        }
+        else
+        {
+            construct_slot(to, from->value);
+        }
+    }
+
+    /* 仅用于 rehash/拷贝：目标表一定有空位，且不存在墓碑 */
+    void insert_unique_no_grow(std::size_t hash, const value_type &v)
+    {
+        size_type idx = find_insert_slot(hash);
+        construct_slot(slots_ + idx, v);
+        ctrl_[idx] = swiss::h2(hash);
+        --growth_left_;
+        ++size_;
+    }
+
+    void erase_at(size_type idx)
+    {
+        destroy_slot(slots_ + idx);
+        --size_;
+        /*
+         * 分组内若仍有空槽位，说明这个分组自上次 rehash 以来从未被填满，
+         * 没有任何探测序列越过它，可以直接标记为空；否则必须留下墓碑以保证后面的元素仍可被找到。
+         */
+        const size_type base = idx & ~(swiss::kGroupWidth - 1);
+        if (swiss::group(ctrl_ + base).match_empty() != 0)
+        {
+            ctrl_[idx] = swiss::kEmpty;
+            ++growth_left_;
+        }
+        else
+        {
+            ctrl_[idx] = swiss::kDeleted;
+        }
+    }
+
+    /*
+     * 先在局部变量中分配新数组并算出每个元素的新位置(哈希函数可能抛异常)，再搬动元素，
+     * 全部成功后才替换成员；任何一步失败都释放新数组，表保持原样。
+     */
+    void resize(size_type new_capacity)
+    {
+        struct new_arrays
+        {
+            swiss::ctrl_t *ctrl = nullptr;
+            slot_type *slots = nullptr;
+
+            ~new_arrays()
+            {
+                ::operator delete(ctrl);
+                ::operator delete(slots);
+            }
+        } fresh;
+        fresh.ctrl = static_cast<swiss::ctrl_t *>(::operator new(new_capacity));
+        fresh.slots = static_cast<slot_type *>(::operator new(new_capacity * sizeof(slot_type)));
+        std::memset(fresh.ctrl, static_cast<unsigned char>(swiss::kEmpty), new_capacity);
+
+        std::vector<size_type> target(capacity_);
+        for (size_type i = 0; i < capacity_; ++i)
+        {
+            if (swiss::is_full(ctrl_[i]))
+            {
+                const std::size_t hash = hash_(slots_[i].value.first);
+                const size_type idx = find_insert_slot(fresh.ctrl, new_capacity, hash);
+                fresh.ctrl[idx] = swiss::h2(hash);
+                target[i] = idx;
+            }
+        }
+
+        size_type done = 0;
+        try
+        {
+            for (; done < capacity_; ++done)
+            {
+                if (swiss::is_full(ctrl_[done]))
+                {
+                    relocate_slot(fresh.slots + target[done], slots_ + done);
+                }
+            }
+        }
+        catch (...)
+        {
+            for (size_type i = 0; i < done; ++i)
+            {
+                if (swiss::is_full(ctrl_[i]))
+                {
+                    destroy_slot(fresh.slots + target[i]);
+                }
+            }
+            throw;
+        }
+
+        for (size_type i = 0; i < capacity_; ++i)
+        {
+            if (swiss::is_full(ctrl_[i]))
+            {
+                destroy_slot(slots_ + i);
+            }
+        }
+        using std::swap;
+        swap(ctrl_, fresh.ctrl);
+        swap(slots_, fresh.slots);
+        capacity_ = new_capacity;
+        growth_left_ = max_size_for(new_capacity) - size_;
+    }
+
+    void destroy()
+    {
+        if (capacity_ == 0)
+        {
+            return;
+        }
+        clear();
+        ::operator delete(ctrl_);
+        ::operator delete(slots_);
+        ctrl_ = nullptr;
+        slots_ = nullptr;
+        capacity_ = 0;
+        growth_left_ = 0;
+    }
+
+    swiss::ctrl_t *ctrl_;
+    slot_type *slots_;
+    size_type capacity_;
+    size_type size_;
+    size_type growth_left_;
+    Hash hash_;
+    KeyEqual eq_;
+};
+
+} // namespace learning
+
+#endif // FLAT_HASH_MAP_HPP
@@ -0,0 +1,151 @@
+/**
+ * @file flat_hash_map_test.cpp
+ * @author Richard Wang
+ * @brief 以 std::pair / std::tuple 为键的 flat_hash_map 使用示例
+ *  1. 用 (age, name) 组成的 std::pair 为 info_list 建立索引，查找从线性 for_each 扫描变为 O(1)；
+ *  2. 用 std::tuple<int, std::string, int> 记录去重；
+ *  3. 异构查找：用 std::tuple<int, const char*> 查找 std::tuple<int, std::string> 键，不构造临时 std::string；
+ *  4. reserve / rehash 控制容量。
+ *
+ * 编译: g++ -std=c++14 -O2 -msse2 flat_hash_map_test.cpp -o flat_hash_map_test
+ * @version : 1.0
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c), Richard Wang.
+ *
+ */
+
+#include <iostream>
+#include <list>
+#include <string>
+#include <tuple>
+#include <vector>
+#include <algorithm>
+
+#include "flat_hash_map.hpp"
+
+/**
+ * @brief 用 pair 键为 info_list 建立索引
+ */
+void pair_key_test()
+{
+    std::cout << "------------- test pair key ------------------" << std::endl;
+    std::vector<std::pair<int, std::string>> info_list = {{12, "Mark"}, {17, "Jack"}, {11, "Jim"}, {14, "Rose"}};
+
+    /* 键为(age, name)，值为在 info_list 中的下标 */
+    learning::flat_hash_map<std::pair<int, std::string>, std::size_t> index;
+    index.reserve(info_list.size());
+    for (std::size_t i = 0; i < info_list.size(); ++i)
+    {
+        index.try_emplace(info_list[i], i);
+    }
+
+    auto iter = index.find(std::make_pair(17, std::string("Jack")));
+    if (iter != index.end())
+    {
+        std::cout << "Found Jack at " << iter->second << std::endl;
+    }
+
+    /* pair 与两元素 tuple 哈希一致，可以互相查找 */
+    std::cout << "contains (11, Jim): " << index.contains(std::make_tuple(11, "Jim")) << std::endl;
+    std::cout << "contains (11, Tom): " << index.contains(std::make_tuple(11, "Tom")) << std::endl;
+}
+
+/**
+ * @brief 用 tuple 键对 userList 去重
+ */
+void tuple_dedupe_test()
+{
+    std::cout << "------------- test tuple dedupe ------------------" << std::endl;
+    std::list<std::tuple<int, std::string, int>> userList = {
+        std::make_tuple(26, "Richard", 178),
+        std::make_tuple(29, "Jack", 180),
+        std::make_tuple(26, "Richard", 178),
+        std::make_tuple(25, "Simth", 191),
+        std::make_tuple(29, "Jack", 180),
+    };
+
+    learning::flat_hash_map<std::tuple<int, std::string, int>, int> seen;
+    for_each(userList.begin(), userList.end(), [&seen](const std::tuple<int, std::string, int> &user)
+             { ++seen[user]; });
+
+    for (const auto &kv : seen)
+    {
+        std::cout << "Age:" << std::get<0>(kv.first) << ", Name: " << std::get<1>(kv.first)
+                  << ", High: " << std::get<2>(kv.first) << ", Count: " << kv.second << std::endl;
+    }
+}
+
+/**
+ * @brief 异构查找：查询键只持有字符串的“视图”
+ */
+void heterogeneous_lookup_test()
+{
+    std::cout << "------------- test heterogeneous lookup ------------------" << std::endl;
+    learning::flat_hash_map<std::tuple<int, std::string>, std::string> country;
+    country.try_emplace(std::make_tuple(12, std::string("Feb")), "China");
+    country.try_emplace(std::make_tuple(24, std::string("Jun")), "America");
+
+    const char *month = "Jun";
+    auto iter = country.find(std::make_tuple(24, month));
+    std::cout << "(24, Jun) -> " << (iter != country.end() ? iter->second : "<none>") << std::endl;
+
+#if __cplusplus >= 201703L
+    std::string_view view("Feb");
+    std::cout << "(12, Feb) -> " << country.find(std::make_tuple(12, view))->second << std::endl;
+#endif
+
+    std::cout << "erase (12, Feb): " << country.erase(std::make_tuple(12, "Feb")) << ", size: " << country.size() << std::endl;
+}
+
+/**
+ * @brief reserve / rehash 对容量的影响
+ */
+void capacity_test()
+{
+    std::cout << "------------- test reserve / rehash ------------------" << std::endl;
+    learning::flat_hash_map<std::pair<int, int>, int> table;
+    table.reserve(1000);
+    std::size_t cap = table.capacity();
+    for (int i = 0; i < 1000; ++i)
+    {
+        table.try_emplace(std::make_pair(i, i * 7), i);
+    }
+    std::cout << "capacity after reserve(1000): " << cap << ", after 1000 inserts: " << table.capacity()
+              << ", load factor: " << table.load_factor() << std::endl;
+
+    for (int i = 0; i < 900; ++i)
+    {
+        table.erase(std::make_pair(i, i * 7));
+    }
+    table.rehash(0);
+    std::cout << "size: " << table.size() << ", capacity after rehash(0): " << table.capacity() << std::endl;
+
+    int missing = 0;
+    for (int i = 900; i < 1000; ++i)
+    {
+        missing += table.contains(std::make_pair(i, i * 7)) ? 0 : 1;
+    }
+    std::cout << "missing keys: " << missing << std::endl;
+}
+
+int main()
+{
+    /****************** pair_key_test() *************/
+    pair_key_test();
+    /************************************************/
+
+    /**************** tuple_dedupe_test() ***********/
+    tuple_dedupe_test();
+    /************************************************/
+
+    /********** heterogeneous_lookup_test() *********/
+    heterogeneous_lookup_test();
+    /************************************************/
+
+    /****************** capacity_test() *************/
+    capacity_test();
+    /************************************************/
+
+    return 0;
+}
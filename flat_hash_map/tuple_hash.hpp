@@ -0,0 +1,238 @@
+/**
+ * @file tuple_hash.hpp
+ * @author Richard Wang
+ * @brief 面向 std::pair / std::tuple 复合键的哈希与相等比较
+ *  1. tuple_hash
+ *      对整型、枚举、浮点、字符串(std::string / const char* / std::string_view)、std::pair 和 std::tuple 递归求哈希。
+ *      同一个值无论以哪种“视图”类型出现(例如 std::string 与 const char*，int 与 long)，得到的哈希值都相同，
+ *      因此可以用 std::tuple<int, const char*> 去查找以 std::tuple<int, std::string> 为键的容器(异构查找)。
+ *  2. key_equal
+ *      逐元素比较两个键，允许 pair 与 tuple、std::string 与 const char* 之间混合比较。
+ * @version : 1.0
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c), Richard Wang.
+ *
+ */
+#ifndef TUPLE_HASH_HPP
+#define TUPLE_HASH_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <string>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#if __cplusplus >= 201703L
+#include <string_view>
+#endif
+
+namespace learning
+{
+
+/**
+ * @brief 64位混合函数(murmur3 fmix64)，把低质量的输入(例如连续的整数)打散到全部比特位
+ */
+inline uint64_t hash_mix(uint64_t x)
+{
+    x ^= x >> 33;
+    x *= 0xff51afd7ed558ccdULL;
+    x ^= x >> 33;
+    x *= 0xc4ceb9fe1a85ec53ULL;
+    x ^= x >> 33;
+    return x;
+}
+
+inline uint64_t hash_combine(uint64_t seed, uint64_t value)
+{
+    return hash_mix(seed ^ (value + 0x9e3779b97f4a7c15ULL + (seed << 6) + (seed >> 2)));
+}
+
+/**
+ * @brief 字节串哈希：每次处理8字节，尾部不足8字节的部分补零后再处理一次
+ */
+inline uint64_t hash_bytes(const void *data, std::size_t len, uint64_t seed = 0)
+{
+    const unsigned char *p = static_cast<const unsigned char *>(data);
+    uint64_t h = seed ^ (len * 0x9e3779b97f4a7c15ULL);
+    while (len >= 8)
+    {
+        uint64_t word;
+        std::memcpy(&word, p, 8);
+        h = hash_combine(h, word);
+        p += 8;
+        len -= 8;
+    }
+    if (len > 0)
+    {
+        uint64_t word = 0;
+        std::memcpy(&word, p, len);
+        h = hash_combine(h, word);
+    }
+    return hash_mix(h);
+}
+
+/**
+ * @brief 每种键类型的哈希实现，默认退化为 std::hash 再混合一次
+ */
+template <class T, class Enable = void>
+struct key_hasher
+{
+    uint64_t operator()(const T &v) const { return hash_mix(std::hash<T>()(v)); }
+};
+
+/* 整型与枚举：按数值哈希，保证 int 与 long 等不同宽度的同值整数哈希一致 */
+template <class T>
+struct key_hasher<T, typename std::enable_if<std::is_integral<T>::value || std::is_enum<T>::value>::type>
+{
+    uint64_t operator()(T v) const { return hash_mix(static_cast<uint64_t>(static_cast<long long>(v))); }
+};
+
+template <class T>
+struct key_hasher<T, typename std::enable_if<std::is_floating_point<T>::value>::type>
+{
+    uint64_t operator()(T v) const
+    {
+        double d = (v == 0) ? 0.0 : static_cast<double>(v); // +0.0 与 -0.0 相等，哈希也必须相等
+        uint64_t bits;
+        std::memcpy(&bits, &d, sizeof(bits));
+        return hash_mix(bits);
+    }
+};
+
+template <>
+struct key_hasher<std::string>
+{
+    uint64_t operator()(const std::string &s) const { return hash_bytes(s.data(), s.size()); }
+};
+
+template <>
+struct key_hasher<const char *>
+{
+    uint64_t operator()(const char *s) const { return hash_bytes(s, std::strlen(s)); }
+};
+
+template <>
+struct key_hasher<char *> : key_hasher<const char *>
+{
+};
+
+#if __cplusplus >= 201703L
+template <>
+struct key_hasher<std::string_view>
+{
+    uint64_t operator()(std::string_view s) const { return hash_bytes(s.data(), s.size()); }
+};
+#endif
+
+template <class T>
+using key_hasher_t = key_hasher<typename std::decay<T>::type>;
+
+template <class T1, class T2>
+struct key_hasher<std::pair<T1, T2>>
+{
+    uint64_t operator()(const std::pair<T1, T2> &p) const
+    {
+        return hash_combine(hash_combine(0, key_hasher_t<T1>()(p.first)), key_hasher_t<T2>()(p.second));
+    }
+};
+
+template <class Tuple, std::size_t I = 0, bool End = (I == std::tuple_size<Tuple>::value)>
+struct tuple_hash_impl
+{
+    static uint64_t apply(const Tuple &t, uint64_t seed)
+    {
+        typedef typename std::tuple_element<I, Tuple>::type elem_t;
+        return tuple_hash_impl<Tuple, I + 1>::apply(t, hash_combine(seed, key_hasher_t<elem_t>()(std::get<I>(t))));
+    }
+};
+
+template <class Tuple, std::size_t I>
+struct tuple_hash_impl<Tuple, I, true>
+{
+    static uint64_t apply(const Tuple &, uint64_t seed) { return seed; }
+};
+
+/* pair 与两元素 tuple 的哈希方式相同(种子都从0开始逐元素合并)，因此二者可以互相查找 */
+template <class... Ts>
+struct key_hasher<std::tuple<Ts...>>
+{
+    uint64_t operator()(const std::tuple<Ts...> &t) const
+    {
+        return tuple_hash_impl<std::tuple<Ts...>>::apply(t, 0);
+    }
+};
+
+/**
+ * @brief 容器使用的哈希仿函数；is_transparent 表示支持异构查找
+ */
+struct tuple_hash
+{
+    typedef void is_transparent;
+
+    template <class T>
+    std::size_t operator()(const T &v) const
+    {
+        return static_cast<std::size_t>(key_hasher_t<T>()(v));
+    }
+};
+
+/**
+ * @brief 逐元素比较的相等仿函数，允许 pair/tuple 之间以及不同字符串类型之间比较
+ */
+struct key_equal
+{
+    typedef void is_transparent;
+
+    template <class A, class B>
+    bool operator()(const A &a, const B &b) const { return equal(a, b, 0); }
+
+private:
+    template <class A, class B, std::size_t I = 0, bool End = (I == std::tuple_size<A>::value)>
+    struct tuple_equal_impl
+    {
+        static bool apply(const A &a, const B &b)
+        {
+            return key_equal()(std::get<I>(a), std::get<I>(b)) && tuple_equal_impl<A, B, I + 1>::apply(a, b);
+        }
+    };
+
+    template <class A, class B, std::size_t I>
+    struct tuple_equal_impl<A, B, I, true>
+    {
+        static bool apply(const A &, const B &) { return true; }
+    };
+
+    template <class A, class B>
+    struct is_tuple_like_pair
+    {
+        template <class T>
+        static std::true_type test(typename std::tuple_size<T>::type *);
+        template <class T>
+        static std::false_type test(...);
+        static const bool value = decltype(test<A>(0))::value && decltype(test<B>(0))::value;
+    };
+
+    /* const char* 与 const char* 比较的是内容而不是指针 */
+    static bool equal(const char *a, const char *b, int) { return std::strcmp(a, b) == 0; }
+
+    template <class A, class B>
+    static auto equal(const A &a, const B &b, int)
+        -> typename std::enable_if<is_tuple_like_pair<A, B>::value, bool>::type
+    {
+        static_assert(std::tuple_size<A>::value == std::tuple_size<B>::value, "key arity mismatch");
+        return tuple_equal_impl<A, B>::apply(a, b);
+    }
+
+    template <class A, class B>
+    static auto equal(const A &a, const B &b, long) -> decltype(a == b)
+    {
+        return a == b;
+    }
+};
+
+} // namespace learning
+
+#endif // TUPLE_HASH_HPP
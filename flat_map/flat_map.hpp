@@ -0,0 +1,553 @@
+/**
+ * @file flat_map.hpp
+ * @author Richard Wang
+ * @brief 基于有序连续数组的 flat_map / flat_set
+ *  1. 存储方式
+ *      flat_set<K> 只有一个有序的 std::vector<K>；
+ *      flat_map<K, V> 把键和值分别存放在两个 std::vector 中(与 C++23 std::flat_map 相同)，
+ *      查找时只在紧凑的键数组上做二分，值数组不会污染缓存。
+ *  2. 批量构造
+ *      从无序输入构造时只做一次排序 + 去重(相同键保留第一次出现的元素)，复杂度 O(n log n)；
+ *      若调用方保证输入已排序且无重复，可传入 sorted_unique 标记跳过排序。
+ *  3. 查找
+ *      使用无分支二分查找：循环中只有一次条件赋值(编译为 cmov)，没有难以预测的跳转。
+ *  4. 插入
+ *      单个插入需要移动插入点之后的元素，复杂度 O(n)；
+ *      insert(first, last) 先对新元素排序去重，再与原数组做一次线性归并，复杂度 O(n + m log m)，
+ *      大量插入时应优先使用批量接口。
+ * 适用于“构造一次，查询多次”的只读查找表；频繁单点插入/删除的场景仍应使用 std::map。
+ * @version : 1.0
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c), Richard Wang.
+ *
+ */
+#ifndef FLAT_MAP_HPP
+#define FLAT_MAP_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <functional>
+#include <initializer_list>
+#include <iterator>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+namespace learning
+{
+
+/**
+ * @brief 标记：输入已按比较器排好序且没有重复键
+ */
+struct sorted_unique_t
+{
+    explicit sorted_unique_t() = default;
+};
+static const sorted_unique_t sorted_unique{};
+
+namespace detail
+{
+
+/**
+ * @brief 无分支二分查找，返回第一个不小于 key 的元素下标
+ *  每轮把区间缩小一半，base 的移动用条件赋值完成；区间长度只取决于 n，循环次数固定为 ceil(log2(n))。
+ */
+template <class T, class Q, class Compare>
+std::size_t branchless_lower_bound(const T *first, std::size_t n, const Q &key, Compare comp)
+{
+    if (n == 0)
+    {
+        return 0;
+    }
+    const T *base = first;
+    while (n > 1)
+    {
+        const std::size_t half = n / 2;
+        base = comp(base[half], key) ? base + half : base;
+        n -= half;
+    }
+    return static_cast<std::size_t>(base - first) + (comp(*base, key) ? 1 : 0);
+}
+
+/* 第一个大于 key 的元素下标 */
+template <class T, class Q, class Compare>
+std::size_t branchless_upper_bound(const T *first, std::size_t n, const Q &key, Compare comp)
+{
+    if (n == 0)
+    {
+        return 0;
+    }
+    const T *base = first;
+    while (n > 1)
+    {
+        const std::size_t half = n / 2;
+        base = !comp(key, base[half]) ? base + half : base;
+        n -= half;
+    }
+    return static_cast<std::size_t>(base - first) + (!comp(key, *base) ? 1 : 0);
+}
+
+} // namespace detail
+
+/**
+ * @brief 有序集合，元素连续存放在 std::vector 中
+ */
+template <class K, class Compare = std::less<K>>
+class flat_set
+{
+public:
+    typedef K key_type;
+    typedef K value_type;
+    typedef Compare key_compare;
+    typedef std::vector<K> container_type;
+    typedef std::size_t size_type;
+    typedef typename container_type::const_iterator iterator;
+    typedef typename container_type::const_iterator const_iterator;
+
+    flat_set() = default;
+
+    explicit flat_set(container_type data, const Compare &comp = Compare()) : data_(std::move(data)), comp_(comp)
+    {
+        sort_and_unique();
+    }
+
+    flat_set(sorted_unique_t, container_type data, const Compare &comp = Compare()) : data_(std::move(data)), comp_(comp) {}
+
+    template <class InputIt>
+    flat_set(InputIt first, InputIt last, const Compare &comp = Compare()) : data_(first, last), comp_(comp)
+    {
+        sort_and_unique();
+    }
+
+    flat_set(std::initializer_list<K> init, const Compare &comp = Compare()) : flat_set(init.begin(), init.end(), comp) {}
+
+    /************************ 迭代器与容量 ************************/
+    const_iterator begin() const { return data_.begin(); }
+    const_iterator end() const { return data_.end(); }
+    bool empty() const { return data_.empty(); }
+    size_type size() const { return data_.size(); }
+    void reserve(size_type n) { data_.reserve(n); }
+    void clear() { data_.clear(); }
+    const K *data() const { return data_.data(); }
+
+    /* 取出底层数组(之后本对象为空)，可用于零拷贝地交给其他组件 */
+    container_type extract() &&
+    {
+        container_type tmp;
+        tmp.swap(data_);
+        return tmp;
+    }
+
+    /************************ 查找 ************************/
+    template <class Q>
+    const_iterator lower_bound(const Q &key) const
+    {
+        return begin() + detail::branchless_lower_bound(data_.data(), data_.size(), key, comp_);
+    }
+
+    template <class Q>
+    const_iterator upper_bound(const Q &key) const
+    {
+        return begin() + detail::branchless_upper_bound(data_.data(), data_.size(), key, comp_);
+    }
+
+    template <class Q>
+    std::pair<const_iterator, const_iterator> equal_range(const Q &key) const
+    {
+        return std::make_pair(lower_bound(key), upper_bound(key));
+    }
+
+    template <class Q>
+    const_iterator find(const Q &key) const
+    {
+        const_iterator it = lower_bound(key);
+        return (it != end() && !comp_(key, *it)) ? it : end();
+    }
+
+    template <class Q>
+    bool contains(const Q &key) const { return find(key) != end(); }
+
+    template <class Q>
+    size_type count(const Q &key) const { return contains(key) ? 1 : 0; }
+
+    /************************ 修改 ************************/
+    std::pair<const_iterator, bool> insert(const K &key) { return emplace(key); }
+    std::pair<const_iterator, bool> insert(K &&key) { return emplace(std::move(key)); }
+
+    template <class... Args>
+    std::pair<const_iterator, bool> emplace(Args &&...args)
+    {
+        K key(std::forward<Args>(args)...);
+        const size_type pos = detail::branchless_lower_bound(data_.data(), data_.size(), key, comp_);
+        if (pos != data_.size() && !comp_(key, data_[pos]))
+        {
+            return std::make_pair(begin() + pos, false);
+        }
+        data_.insert(data_.begin() + pos, std::move(key));
+        return std::make_pair(begin() + pos, true);
+    }
+
+    /**
+     * @brief 批量插入：新元素追加到尾部，单独排序去重后与原有部分做一次原地归并
+     */
+    template <class InputIt>
+    void insert(InputIt first, InputIt last)
+    {
+        const size_type old_size = data_.size();
+        data_.insert(data_.end(), first, last);
+        merge_tail(old_size);
+    }
+
+    void insert(std::initializer_list<K> init) { insert(init.begin(), init.end()); }
+
+    template <class Q>
+    size_type erase(const Q &key)
+    {
+        const_iterator it = find(key);
+        if (it == end())
+        {
+            return 0;
+        }
+        erase(it);
+        return 1;
+    }
+
+    const_iterator erase(const_iterator pos) { return data_.erase(pos); }
+
+private:
+    struct equivalent
+    {
+        const Compare &comp;
+        bool operator()(const K &a, const K &b) const { return !comp(a, b) && !comp(b, a); }
+    };
+
+    void sort_and_unique()
+    {
+        std::stable_sort(data_.begin(), data_.end(), comp_);
+        data_.erase(std::unique(data_.begin(), data_.end(), equivalent{comp_}), data_.end());
+    }
+
+    /* [0, mid) 已有序，[mid, end) 为新追加的元素；原有元素优先于新元素 */
+    void merge_tail(size_type mid)
+    {
+        std::stable_sort(data_.begin() + mid, data_.end(), comp_);
+        std::inplace_merge(data_.begin(), data_.begin() + mid, data_.end(), comp_);
+        data_.erase(std::unique(data_.begin(), data_.end(), equivalent{comp_}), data_.end());
+    }
+
+    container_type data_;
+    Compare comp_;
+};
+
+/**
+ * @brief 有序映射，键与值分别连续存放
+ *  迭代器解引用得到 std::pair<const K&, V&>(代理对象)，与 std::map 的用法基本一致：
+ *      for (auto kv : m) { kv.first; kv.second; }
+ *      it->first / it->second
+ */
+template <class K, class V, class Compare = std::less<K>>
+class flat_map
+{
+public:
+    typedef K key_type;
+    typedef V mapped_type;
+    typedef std::pair<K, V> value_type;
+    typedef Compare key_compare;
+    typedef std::vector<K> key_container_type;
+    typedef std::vector<V> mapped_container_type;
+    typedef std::size_t size_type;
+
+    template <bool Const>
+    class iterator_base
+    {
+        friend class flat_map;
+        typedef typename std::conditional<Const, const flat_map, flat_map>::type owner_t;
+        typedef typename std::conditional<Const, const V, V>::type mapped_t;
+
+    public:
+        typedef std::random_access_iterator_tag iterator_category;
+        typedef std::pair<K, V> value_type;
+        typedef std::ptrdiff_t difference_type;
+        typedef std::pair<const K &, mapped_t &> reference;
+
+        struct pointer
+        {
+            reference ref;
+            const reference *operator->() const { return &ref; }
+        };
+
+        iterator_base() : owner_(nullptr), pos_(0) {}
+
+        template <bool C, class = typename std::enable_if<Const && !C>::type>
+        iterator_base(const iterator_base<C> &other) : owner_(other.owner_), pos_(other.pos_) {}
+
+        reference operator*() const { return reference(owner_->keys_[pos_], owner_->values_[pos_]); }
+        pointer operator->() const { return pointer{**this}; }
+        reference operator[](difference_type n) const { return *(*this + n); }
+
+        iterator_base &operator++() { ++pos_; return *this; }
+        iterator_base &operator--() { --pos_; return *this; }
+        iterator_base operator++(int) { iterator_base tmp(*this); ++pos_; return tmp; }
+        iterator_base operator--(int) { iterator_base tmp(*this); --pos_; return tmp; }
+        iterator_base &operator+=(difference_type n) { pos_ += n; return *this; }
+        iterator_base &operator-=(difference_type n) { pos_ -= n; return *this; }
+        friend iterator_base operator+(iterator_base it, difference_type n) { return it += n; }
+        friend iterator_base operator-(iterator_base it, difference_type n) { return it -= n; }
+        friend difference_type operator-(const iterator_base &a, const iterator_base &b)
+        {
+            return static_cast<difference_type>(a.pos_) - static_cast<difference_type>(b.pos_);
+        }
+        friend bool operator==(const iterator_base &a, const iterator_base &b) { return a.pos_ == b.pos_; }
+        friend bool operator!=(const iterator_base &a, const iterator_base &b) { return a.pos_ != b.pos_; }
+        friend bool operator<(const iterator_base &a, const iterator_base &b) { return a.pos_ < b.pos_; }
+
+    private:
+        template <bool>
+        friend class iterator_base;
+
+        iterator_base(owner_t *owner, size_type pos) : owner_(owner), pos_(pos) {}
+
+        owner_t *owner_;
+        size_type pos_;
+    };
+
+    typedef iterator_base<false> iterator;
+    typedef iterator_base<true> const_iterator;
+
+    flat_map() = default;
+
+    /**
+     * @brief 从无序的 (key, value) 序列批量构造：一次排序 + 去重(保留第一次出现的键)
+     */
+    template <class InputIt>
+    flat_map(InputIt first, InputIt last, const Compare &comp = Compare()) : comp_(comp)
+    {
+        std::vector<value_type> items(first, last);
+        sort_unique(items);
+        split(items);
+    }
+
+    flat_map(std::initializer_list<value_type> init, const Compare &comp = Compare())
+        : flat_map(init.begin(), init.end(), comp) {}
+
+    flat_map(sorted_unique_t, key_container_type keys, mapped_container_type values, const Compare &comp = Compare())
+        : keys_(std::move(keys)), values_(std::move(values)), comp_(comp)
+    {
+        if (keys_.size() != values_.size())
+        {
+            throw std::invalid_argument("flat_map: keys and values size mismatch");
+        }
+    }
+
+    /************************ 迭代器与容量 ************************/
+    iterator begin() { return iterator(this, 0); }
+    iterator end() { return iterator(this, keys_.size()); }
+    const_iterator begin() const { return const_iterator(this, 0); }
+    const_iterator end() const { return const_iterator(this, keys_.size()); }
+    bool empty() const { return keys_.empty(); }
+    size_type size() const { return keys_.size(); }
+    void clear()
+    {
+        keys_.clear();
+        values_.clear();
+    }
+    void reserve(size_type n)
+    {
+        keys_.reserve(n);
+        values_.reserve(n);
+    }
+    const key_container_type &keys() const { return keys_; }
+    const mapped_container_type &values() const { return values_; }
+
+    /************************ 查找 ************************/
+    template <class Q>
+    iterator lower_bound(const Q &key) { return iterator(this, lower_index(key)); }
+    template <class Q>
+    const_iterator lower_bound(const Q &key) const { return const_iterator(this, lower_index(key)); }
+
+    template <class Q>
+    iterator upper_bound(const Q &key)
+    {
+        return iterator(this, detail::branchless_upper_bound(keys_.data(), keys_.size(), key, comp_));
+    }
+    template <class Q>
+    const_iterator upper_bound(const Q &key) const
+    {
+        return const_iterator(this, detail::branchless_upper_bound(keys_.data(), keys_.size(), key, comp_));
+    }
+
+    template <class Q>
+    iterator find(const Q &key) { return iterator(this, find_index(key)); }
+    template <class Q>
+    const_iterator find(const Q &key) const { return const_iterator(this, find_index(key)); }
+
+    template <class Q>
+    bool contains(const Q &key) const { return find_index(key) != keys_.size(); }
+    template <class Q>
+    size_type count(const Q &key) const { return contains(key) ? 1 : 0; }
+
+    V &at(const K &key)
+    {
+        const size_type pos = find_index(key);
+        if (pos == keys_.size())
+        {
+            throw std::out_of_range("flat_map::at");
+        }
+        return values_[pos];
+    }
+    const V &at(const K &key) const { return const_cast<flat_map *>(this)->at(key); }
+
+    V &operator[](const K &key) { return (*try_emplace(key).first).second; }
+
+    /************************ 修改 ************************/
+    template <class KK, class... Args>
+    std::pair<iterator, bool> try_emplace(KK &&key, Args &&...args)
+    {
+        const size_type pos = lower_index(key);
+        if (pos != keys_.size() && !comp_(key, keys_[pos]))
+        {
+            return std::make_pair(iterator(this, pos), false);
+        }
+        /* 先构造值，再依次插入两个数组；值插入失败时撤销已插入的键，保持 keys_ 与 values_ 等长 */
+        V value(std::forward<Args>(args)...);
+        keys_.insert(keys_.begin() + pos, K(std::forward<KK>(key)));
+        try
+        {
+            values_.insert(values_.begin() + pos, std::move(value));
+        }
+        catch (...)
+        {
+            keys_.erase(keys_.begin() + pos);
+            throw;
+        }
+        return std::make_pair(iterator(this, pos), true);
+    }
+
+    std::pair<iterator, bool> insert(const value_type &v) { return try_emplace(v.first, v.second); }
+    std::pair<iterator, bool> insert(value_type &&v) { return try_emplace(std::move(v.first), std::move(v.second)); }
+
+    template <class M>
+    std::pair<iterator, bool> insert_or_assign(const K &key, M &&obj)
+    {
+        std::pair<iterator, bool> res = try_emplace(key, std::forward<M>(obj));
+        if (!res.second)
+        {
+            values_[res.first.pos_] = std::forward<M>(obj);
+        }
+        return res;
+    }
+
+    /**
+     * @brief 批量插入：新元素先排序去重，再与已有数组做一次线性归并；已存在的键保持原值
+     */
+    template <class InputIt>
+    void insert(InputIt first, InputIt last)
+    {
+        std::vector<value_type> items(first, last);
+        if (items.empty())
+        {
+            return;
+        }
+        sort_unique(items);
+
+        key_container_type keys;
+        mapped_container_type values;
+        keys.reserve(keys_.size() + items.size());
+        values.reserve(keys_.size() + items.size());
+
+        size_type i = 0;
+        typename std::vector<value_type>::iterator it = items.begin();
+        while (i < keys_.size() || it != items.end())
+        {
+            if (it == items.end() || (i < keys_.size() && !comp_(it->first, keys_[i])))
+            {
+                /* 键相同时旧元素优先，新元素被丢弃 */
+                if (it != items.end() && !comp_(keys_[i], it->first))
+                {
+                    ++it;
+                }
+                keys.push_back(std::move(keys_[i]));
+                values.push_back(std::move(values_[i]));
+                ++i;
+            }
+            else
+            {
+                keys.push_back(std::move(it->first));
+                values.push_back(std::move(it->second));
+                ++it;
+            }
+        }
+        keys_.swap(keys);
+        values_.swap(values);
+    }
+
+    void insert(std::initializer_list<value_type> init) { insert(init.begin(), init.end()); }
+
+    template <class Q>
+    size_type erase(const Q &key)
+    {
+        const size_type pos = find_index(key);
+        if (pos == keys_.size())
+        {
+            return 0;
+        }
+        erase_at(pos);
+        return 1;
+    }
+
+    iterator erase(const_iterator pos)
+    {
+        erase_at(pos.pos_);
+        return iterator(this, pos.pos_);
+    }
+
+private:
+    template <class Q>
+    size_type lower_index(const Q &key) const
+    {
+        return detail::branchless_lower_bound(keys_.data(), keys_.size(), key, comp_);
+    }
+
+    template <class Q>
+    size_type find_index(const Q &key) const
+    {
+        const size_type pos = lower_index(key);
+        return (pos != keys_.size() && !comp_(key, keys_[pos])) ? pos : keys_.size();
+    }
+
+    void erase_at(size_type pos)
+    {
+        keys_.erase(keys_.begin() + pos);
+        values_.erase(values_.begin() + pos);
+    }
+
+    void sort_unique(std::vector<value_type> &items) const
+    {
+        const Compare &comp = comp_;
+        std::stable_sort(items.begin(), items.end(), [&comp](const value_type &a, const value_type &b)
+                         { return comp(a.first, b.first); });
+        items.erase(std::unique(items.begin(), items.end(), [&comp](const value_type &a, const value_type &b)
+                                { return !comp(a.first, b.first) && !comp(b.first, a.first); }),
+                    items.end());
+    }
+
+    void split(std::vector<value_type> &items)
+    {
+        keys_.reserve(items.size());
+        values_.reserve(items.size());
+        for (value_type &item : items)
+        {
+            keys_.push_back(std::move(item.first));
+            values_.push_back(std::move(item.second));
+        }
+    }
+
+    key_container_type keys_;
+    mapped_container_type values_;
+    Compare comp_;
+};
+
+} // namespace learning
+
+#endif // FLAT_MAP_HPP
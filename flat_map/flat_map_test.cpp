@@ -0,0 +1,106 @@
+/**
+ * @file flat_map_test.cpp
+ * @author Richard Wang
+ * @brief flat_map / flat_set 使用示例
+ *  1. 从 pair_test() 中无序的 (age, name) 数组批量构造 flat_map，一次排序 + 去重；
+ *  2. 有序查找：find / lower_bound / upper_bound / equal_range；
+ *  3. 批量插入与已有数据做一次归并；
+ *  4. flat_set 的构造、查找与删除。
+ *
+ * 编译: g++ -std=c++14 -O2 flat_map_test.cpp -o flat_map_test
+ * @version : 1.0
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c), Richard Wang.
+ *
+ */
+
+#include <iostream>
+#include <string>
+#include <vector>
+#include <algorithm>
+
+#include "flat_map.hpp"
+
+/**
+ * @brief 从无序的 pair 数组构造 flat_map
+ */
+void flat_map_build_test()
+{
+    std::cout << "------------- test flat_map build ------------------" << std::endl;
+    std::vector<std::pair<int, std::string>> info_list = {{12, "Mark"}, {17, "Jack"}, {11, "Jim"}, {14, "Rose"}, {12, "Tom"}};
+
+    /* 键12重复出现，保留第一次出现的 "Mark" */
+    learning::flat_map<int, std::string> age_to_name(info_list.begin(), info_list.end());
+    for (auto kv : age_to_name)
+    {
+        std::cout << "Age:" << kv.first << ", Name: " << kv.second << std::endl;
+    }
+
+    auto iter = age_to_name.find(14);
+    if (iter != age_to_name.end())
+    {
+        std::cout << "find(14): " << iter->second << std::endl;
+    }
+    std::cout << "contains(15): " << age_to_name.contains(15) << std::endl;
+    std::cout << "lower_bound(13): " << age_to_name.lower_bound(13)->first << std::endl;
+    std::cout << "upper_bound(14): " << age_to_name.upper_bound(14)->first << std::endl;
+
+    age_to_name[30] = "Lucy";
+    age_to_name.erase(11);
+    std::cout << "after [30]=Lucy, erase(11), size: " << age_to_name.size() << ", first: " << age_to_name.begin()->first << std::endl;
+}
+
+/**
+ * @brief 批量插入与原有数据归并
+ */
+void flat_map_batch_insert_test()
+{
+    std::cout << "------------- test flat_map batch insert ------------------" << std::endl;
+    learning::flat_map<int, std::string> table = {{1, "one"}, {3, "three"}, {5, "five"}};
+    std::vector<std::pair<int, std::string>> batch = {{4, "four"}, {2, "two"}, {3, "THREE"}, {6, "six"}, {2, "TWO"}};
+
+    table.insert(batch.begin(), batch.end());
+    std::for_each(table.begin(), table.end(), [](std::pair<const int &, std::string &> kv)
+                  { std::cout << kv.first << "=" << kv.second << " "; });
+    std::cout << std::endl;
+}
+
+/**
+ * @brief flat_set 基本使用
+ */
+void flat_set_test()
+{
+    std::cout << "------------- test flat_set ------------------" << std::endl;
+    learning::flat_set<std::string> names = {"Richard", "Jack", "Simth", "Jack", "Mark"};
+    for (const auto &name : names)
+    {
+        std::cout << name << " ";
+    }
+    std::cout << std::endl;
+
+    std::cout << "contains(Jack): " << names.contains(std::string("Jack")) << std::endl;
+    names.insert({"Rose", "Amy", "Mark"});
+    names.erase(std::string("Simth"));
+
+    auto range = names.equal_range(std::string("Mark"));
+    std::cout << "equal_range(Mark) size: " << std::distance(range.first, range.second)
+              << ", total size: " << names.size() << std::endl;
+}
+
+int main()
+{
+    /************** flat_map_build_test() ***********/
+    flat_map_build_test();
+    /************************************************/
+
+    /*********** flat_map_batch_insert_test() *******/
+    flat_map_batch_insert_test();
+    /************************************************/
+
+    /***************** flat_set_test() **************/
+    flat_set_test();
+    /************************************************/
+
+    return 0;
+}
@@ -0,0 +1,804 @@
+/**
+ * @file future.hpp
+ * @author Richard Wang
+ * @brief 带延续(then)的轻量 future / promise，以及 when_all / when_any 组合
+ *  1. 与 std::future 的区别
+ *      std::future 只能 get() 阻塞等待，每等待一个结果就要占用一个线程；
+ *      这里的 future 通过 then(lambda) 注册延续，结果就绪时由完成它的线程或指定的执行器(executor)执行，不阻塞任何线程。
+ *  2. 共享状态
+ *      promise 与 future 共享一个状态对象(allocate_shared 一次分配，来自 object_pool 的线程本地空闲链表)，其中一个原子标志记录“结果已写入”与“延续已注册”两个位：
+ *      双方各自 fetch_or 自己的位，看到对方的位已经置上的一方负责执行延续，不需要互斥锁。
+ *  3. 延续的存储
+ *      延续保存在 small_function 中，捕获不超过 64 字节的 lambda 直接内联存储，常见情况下注册延续不发生堆分配；
+ *      每个 then() 产生的下游状态也从对象池取得，释放后回到池中供下一个 then() 复用，稳态下整条链不向系统申请内存。
+ *  4. 异常
+ *      上游失败时跳过延续，异常沿链条传递到最终的 get()；延续本身抛出的异常同样写入下游 future。
+ *  5. 返回值
+ *      then 的 lambda 返回 void 时得到 future<unit>；返回 future<U> 时自动展开为 future<U>，便于串联异步调用。
+ *  6. 组合
+ *      when_all(f1, f2, ...) -> future<std::tuple<T1, T2, ...>>
+ *      when_all(std::vector<future<T>>) -> future<std::vector<T>>
+ *      when_any(std::vector<future<T>>) -> future<std::pair<std::size_t, T>>   (下标, 值)
+ *
+ *  learning::thread_pool pool(4);
+ *  learning::future<int> f = learning::async(pool, []() { return 20; })
+ *                                .then(pool, [](int v) { return v + 1; })
+ *                                .then([](int v) { return v * 2; });
+ *  int v = f.get(); // 42
+ * @version : 1.0
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c), Richard Wang.
+ *
+ */
+#ifndef FUTURE_HPP
+#define FUTURE_HPP
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "../object_pool/object_pool.hpp"
+#include "small_function.hpp"
+
+namespace learning
+{
+
+/* 代替 void 的空值类型 */
+struct unit
+{
+    friend bool operator==(unit, unit) { return true; }
+    friend bool operator!=(unit, unit) { return false; }
+};
+
+template <class T>
+class future;
+template <class T>
+class promise;
+
+/************************ 执行器 ************************/
+/*
+ * 执行器只需要提供 void execute(small_function<void()> task)。
+ */
+
+/* 在调用线程中立即执行 */
+struct inline_executor
+{
+    void execute(small_function<void()> task) { task(); }
+};
+
+/**
+ * @brief 固定线程数的线程池；析构时执行完队列中剩余的任务再退出
+ */
+class thread_pool
+{
+public:
+    explicit thread_pool(std::size_t threads = std::thread::hardware_concurrency()) : stopping_(false)
+    {
+        if (threads == 0)
+        {
+            threads = 1;
+        }
+        workers_.reserve(threads);
+        for (std::size_t i = 0; i < threads; ++i)
+        {
+            workers_.emplace_back([this]()
+                                  { run(); });
+        }
+    }
+
+    ~thread_pool()
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            stopping_ = true;
+        }
+        cv_.notify_all();
+        for (std::thread &t : workers_)
+        {
+            t.join();
+        }
+    }
+
+    thread_pool(const thread_pool &) = delete;
+    thread_pool &operator=(const thread_pool &) = delete;
+
+    void execute(small_function<void()> task)
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            tasks_.push_back(std::move(task));
+        }
+        cv_.notify_one();
+    }
+
+    std::size_t size() const { return workers_.size(); }
+
+private:
+    void run()
+    {
+        for (;;)
+        {
+            small_function<void()> task;
+            {
+                std::unique_lock<std::mutex> lock(mutex_);
+                cv_.wait(lock, [this]()
+                         { return stopping_ || !tasks_.empty(); });
+                if (tasks_.empty())
+                {
+                    return; // stopping_ 且没有剩余任务
+                }
+                task = std::move(tasks_.front());
+                tasks_.pop_front();
+            }
+            task();
+        }
+    }
+
+    std::mutex mutex_;
+    std::condition_variable cv_;
+    std::deque<small_function<void()>> tasks_;
+    std::vector<std::thread> workers_;
+    bool stopping_;
+};
+
+namespace detail
+{
+
+/**
+ * @brief promise 与 future 的共享状态
+ */
+template <class T>
+class future_state : public std::enable_shared_from_this<future_state<T>>
+{
+public:
+    typedef small_function<void(future_state &)> continuation;
+
+    future_state() : flags_(0), has_value_(false) {}
+
+    ~future_state()
+    {
+        if (has_value_)
+        {
+            value().~T();
+        }
+    }
+
+    future_state(const future_state &) = delete;
+    future_state &operator=(const future_state &) = delete;
+
+    /* 写入结果，但不执行延续；之后须调用 publish() */
+    template <class... A>
+    void store_value(A &&...args)
+    {
+        ::new (static_cast<void *>(&storage_)) T(std::forward<A>(args)...);
+        has_value_ = true;
+    }
+
+    void store_exception(std::exception_ptr error) { error_ = std::move(error); }
+
+    /* 标记结果就绪；延续已注册时在当前线程执行它 */
+    void publish()
+    {
+        if (flags_.fetch_or(kResult, std::memory_order_acq_rel) & kContinuation)
+        {
+            fire();
+        }
+    }
+
+    /* 只能注册一次；结果已就绪时在当前线程立即执行 */
+    void set_continuation(continuation c)
+    {
+        continuation_ = std::move(c);
+        if (flags_.fetch_or(kContinuation, std::memory_order_acq_rel) & kResult)
+        {
+            fire();
+        }
+    }
+
+    bool ready() const { return (flags_.load(std::memory_order_acquire) & kResult) != 0; }
+
+    /* 以下函数只能在结果就绪后调用 */
+    const std::exception_ptr &error() const { return error_; }
+    T &value() { return *reinterpret_cast<T *>(&storage_); }
+
+    T take()
+    {
+        if (error_)
+        {
+            std::rethrow_exception(error_);
+        }
+        return std::move(value());
+    }
+
+private:
+    enum : uint8_t
+    {
+        kResult = 1,
+        kContinuation = 2
+    };
+
+    void fire()
+    {
+        continuation c = std::move(continuation_);
+        c(*this);
+    }
+
+    std::atomic<uint8_t> flags_;
+    bool has_value_;
+    typename std::aligned_storage<sizeof(T), alignof(T)>::type storage_;
+    std::exception_ptr error_;
+    continuation continuation_;
+};
+
+/* 延续返回类型 R 对应的 future 值类型：void -> unit，future<U> -> U */
+template <class R>
+struct future_value
+{
+    typedef R type;
+};
+
+template <>
+struct future_value<void>
+{
+    typedef unit type;
+};
+
+template <class U>
+struct future_value<future<U>>
+{
+    typedef U type;
+};
+
+template <class F, class... A>
+struct is_callable
+{
+    template <class G>
+    static auto test(int) -> decltype(std::declval<G>()(std::declval<A>()...), std::true_type());
+    template <class G>
+    static std::false_type test(...);
+    static const bool value = decltype(test<F>(0))::value;
+};
+
+/* 以上游的值调用 f；future<unit> 的延续也可以不带参数 */
+template <class F, class T, bool = is_callable<F &, T &&>::value>
+struct call_with_value
+{
+    typedef decltype(std::declval<F &>()(std::declval<T &&>())) result_type;
+    static result_type call(F &f, T &value) { return f(std::move(value)); }
+};
+
+template <class F, class T>
+struct call_with_value<F, T, false>
+{
+    static_assert(std::is_same<T, unit>::value, "continuation must accept the value of the future");
+    typedef decltype(std::declval<F &>()()) result_type;
+    static result_type call(F &f, T &) { return f(); }
+};
+
+template <class F, class T>
+struct then_traits
+{
+    typedef typename std::decay<F>::type function_type;
+    typedef typename call_with_value<function_type, T>::result_type result_type;
+    typedef typename std::decay<typename future_value<result_type>::type>::type value_type;
+    typedef future<value_type> future_type;
+};
+
+/* 把 f(value) 的结果写入 p，按返回类型分三种情况 */
+template <class R>
+struct fulfil
+{
+    template <class F, class T, class V>
+    static void run(F &f, T &value, promise<V> &p) { p.set_value(call_with_value<F, T>::call(f, value)); }
+};
+
+template <>
+struct fulfil<void>
+{
+    template <class F, class T, class V>
+    static void run(F &f, T &value, promise<V> &p)
+    {
+        call_with_value<F, T>::call(f, value);
+        p.set_value();
+    }
+};
+
+template <class U>
+struct fulfil<future<U>>
+{
+    template <class F, class T>
+    static void run(F &f, T &value, promise<U> &p);
+};
+
+/* 执行延续：上游失败时直接传递异常；不抛出异常，线程池的工作线程可以直接调用 */
+template <class F, class T, class V>
+void run_continuation(F &f, future_state<T> &state, promise<V> &p) noexcept
+{
+    std::exception_ptr error = state.error();
+    if (!error)
+    {
+        try
+        {
+            fulfil<typename call_with_value<F, T>::result_type>::run(f, state.value(), p);
+            return;
+        }
+        catch (...)
+        {
+            error = std::current_exception();
+        }
+    }
+    /*
+     * 结果已写入、但派发下游延续时失败(例如执行器入队抛出 bad_alloc)，set_exception 会抛出 promise_already_satisfied；
+     * 这时下游的 promise 随未执行的延续一起析构，下游 future 已经收到 broken_promise，这里忽略即可。
+     */
+    try
+    {
+        p.set_exception(error);
+    }
+    catch (...)
+    {
+    }
+}
+
+} // namespace detail
+
+/**
+ * @brief 只移动；then() / get() 会消耗 future，之后 valid() 为 false
+ */
+template <class T>
+class future
+{
+public:
+    typedef T value_type;
+
+    future() {}
+    future(future &&) = default;
+    future &operator=(future &&) = default;
+
+    future(const future &) = delete;
+    future &operator=(const future &) = delete;
+
+    bool valid() const { return static_cast<bool>(state_); }
+    bool is_ready() const { return state_ && state_->ready(); }
+
+    /**
+     * @brief 结果就绪后在完成它的线程中执行 f(value)；调用时已就绪则在当前线程立即执行
+     */
+    template <class F>
+    typename detail::then_traits<F, T>::future_type then(F &&f)
+    {
+        return then_impl(static_cast<inline_executor *>(nullptr), std::forward<F>(f));
+    }
+
+    /**
+     * @brief 结果就绪后把 f(value) 提交给执行器 ex；ex 的生命周期须长于这条链
+     */
+    template <class Executor, class F>
+    typename detail::then_traits<F, T>::future_type then(Executor &ex, F &&f)
+    {
+        return then_impl(&ex, std::forward<F>(f));
+    }
+
+    /**
+     * @brief 阻塞等待结果(只应在链条的末端使用)；失败时重新抛出异常
+     */
+    T get()
+    {
+        std::shared_ptr<detail::future_state<T>> state = take_state();
+        if (!state->ready())
+        {
+            struct waiter
+            {
+                std::mutex m;
+                std::condition_variable cv;
+                bool done = false;
+            } w;
+            waiter *pw = &w;
+            state->set_continuation([pw](detail::future_state<T> &)
+                                    {
+                                        std::lock_guard<std::mutex> lock(pw->m);
+                                        pw->done = true;
+                                        pw->cv.notify_one();
+                                    });
+            std::unique_lock<std::mutex> lock(w.m);
+            w.cv.wait(lock, [&w]()
+                      { return w.done; });
+        }
+        return state->take();
+    }
+
+private:
+    template <class U>
+    friend class future;
+    template <class U>
+    friend class promise;
+    template <class... U>
+    friend future<std::tuple<U...>> when_all(future<U>... fs);
+    template <class U>
+    friend future<std::vector<U>> when_all(std::vector<future<U>> fs);
+    template <class U>
+    friend future<std::pair<std::size_t, U>> when_any(std::vector<future<U>> fs);
+    template <class R>
+    friend struct detail::fulfil;
+
+    explicit future(std::shared_ptr<detail::future_state<T>> state) : state_(std::move(state)) {}
+
+    std::shared_ptr<detail::future_state<T>> take_state()
+    {
+        if (!state_)
+        {
+            throw std::future_error(std::future_errc::no_state);
+        }
+        return std::move(state_);
+    }
+
+    template <class Executor, class F>
+    typename detail::then_traits<F, T>::future_type then_impl(Executor *ex, F &&f)
+    {
+        typedef detail::then_traits<F, T> traits;
+        typedef typename traits::function_type function_type;
+        typedef typename traits::value_type value_type;
+
+        std::shared_ptr<detail::future_state<T>> state = take_state();
+        promise<value_type> p;
+        future<value_type> result = p.get_future();
+        state->set_continuation(
+            [ex, f = function_type(std::forward<F>(f)), p = std::move(p)](detail::future_state<T> &s) mutable
+            {
+                if (ex == nullptr)
+                {
+                    detail::run_continuation(f, s, p);
+                    return;
+                }
+                /* 转交执行器时持有共享状态的引用，保证任务执行前结果不被释放 */
+                ex->execute([st = s.shared_from_this(), f = std::move(f), p = std::move(p)]() mutable
+                            { detail::run_continuation(f, *st, p); });
+            });
+        return result;
+    }
+
+    std::shared_ptr<detail::future_state<T>> state_;
+};
+
+/**
+ * @brief 只移动；析构时若仍未写入结果，future 收到 std::future_errc::broken_promise
+ */
+template <class T>
+class promise
+{
+public:
+    promise()
+        : state_(std::allocate_shared<detail::future_state<T>>(pool_allocator<detail::future_state<T>>())), retrieved_(false),
+          satisfied_(false)
+    {
+    }
+    promise(promise &&other) noexcept
+        : state_(std::move(other.state_)), retrieved_(other.retrieved_), satisfied_(other.satisfied_) {}
+
+    promise &operator=(promise &&other) noexcept
+    {
+        if (this != &other)
+        {
+            abandon();
+            state_ = std::move(other.state_);
+            retrieved_ = other.retrieved_;
+            satisfied_ = other.satisfied_;
+        }
+        return *this;
+    }
+
+    ~promise() { abandon(); }
+
+    promise(const promise &) = delete;
+    promise &operator=(const promise &) = delete;
+
+    future<T> get_future()
+    {
+        if (!state_)
+        {
+            throw std::future_error(std::future_errc::no_state);
+        }
+        if (retrieved_)
+        {
+            throw std::future_error(std::future_errc::future_already_retrieved);
+        }
+        retrieved_ = true;
+        return future<T>(state_);
+    }
+
+    /* 用参数原地构造结果；构造 T 抛出异常时 promise 仍未满足，可以改为 set_exception */
+    template <class... A>
+    void set_value(A &&...args)
+    {
+        check_unsatisfied();
+        state_->store_value(std::forward<A>(args)...);
+        satisfied_ = true;
+        state_->publish();
+    }
+
+    void set_exception(std::exception_ptr error)
+    {
+        check_unsatisfied();
+        state_->store_exception(std::move(error));
+        satisfied_ = true;
+        state_->publish();
+    }
+
+private:
+    void check_unsatisfied() const
+    {
+        if (!state_)
+        {
+            throw std::future_error(std::future_errc::no_state);
+        }
+        if (satisfied_)
+        {
+            throw std::future_error(std::future_errc::promise_already_satisfied);
+        }
+    }
+
+    void abandon()
+    {
+        if (state_ && !satisfied_)
+        {
+            state_->store_exception(std::make_exception_ptr(std::future_error(std::future_errc::broken_promise)));
+            satisfied_ = true;
+            /* 在析构函数中调用：派发延续失败时下游同样收到 broken_promise，不再向外抛出 */
+            try
+            {
+                state_->publish();
+            }
+            catch (...)
+            {
+            }
+        }
+    }
+
+    std::shared_ptr<detail::future_state<T>> state_;
+    bool retrieved_;
+    bool satisfied_;
+};
+
+namespace detail
+{
+
+/* 延续返回 future<U>：等内层 future 完成后再写入 p */
+template <class U>
+template <class F, class T>
+void fulfil<future<U>>::run(F &f, T &value, promise<U> &p)
+{
+    future<U> inner = call_with_value<F, T>::call(f, value);
+    std::shared_ptr<future_state<U>> state = inner.take_state();
+    state->set_continuation([p = std::move(p)](future_state<U> &s) mutable
+                            {
+                                if (s.error())
+                                {
+                                    p.set_exception(s.error());
+                                }
+                                else
+                                {
+                                    p.set_value(std::move(s.value()));
+                                }
+                            });
+}
+
+} // namespace detail
+
+/************************ 工厂函数 ************************/
+
+template <class T>
+future<typename std::decay<T>::type> make_ready_future(T &&value)
+{
+    promise<typename std::decay<T>::type> p;
+    p.set_value(std::forward<T>(value));
+    return p.get_future();
+}
+
+inline future<unit> make_ready_future()
+{
+    return make_ready_future(unit());
+}
+
+template <class T>
+future<T> make_exceptional_future(std::exception_ptr error)
+{
+    promise<T> p;
+    p.set_exception(std::move(error));
+    return p.get_future();
+}
+
+/**
+ * @brief 在执行器上运行 f()，返回其结果的 future
+ */
+template <class Executor, class F>
+typename detail::then_traits<F, unit>::future_type async(Executor &ex, F &&f)
+{
+    return make_ready_future().then(ex, std::forward<F>(f));
+}
+
+/************************ 组合 ************************/
+
+namespace detail
+{
+
+template <class... T>
+struct when_all_tuple_context
+{
+    std::tuple<std::shared_ptr<future_state<T>>...> states;
+    std::atomic<std::size_t> remaining;
+    promise<std::tuple<T...>> p;
+
+    when_all_tuple_context() : remaining(sizeof...(T)) {}
+
+    template <std::size_t... I>
+    void finish(std::index_sequence<I...>)
+    {
+        std::exception_ptr error;
+        int expand[] = {0, (error = error ? error : std::get<I>(states)->error(), 0)...};
+        (void)expand;
+        if (error)
+        {
+            p.set_exception(error);
+        }
+        else
+        {
+            p.set_value(std::move(std::get<I>(states)->value())...);
+        }
+    }
+
+    void arrive()
+    {
+        if (remaining.fetch_sub(1, std::memory_order_acq_rel) == 1)
+        {
+            finish(std::index_sequence_for<T...>());
+        }
+    }
+
+    /* 每个延续持有 self，最后一个延续执行完后上下文才被释放 */
+    template <std::size_t... I>
+    void attach(const std::shared_ptr<when_all_tuple_context> &self, std::index_sequence<I...>)
+    {
+        int expand[] = {0, (std::get<I>(states)->set_continuation([self](auto &)
+                                                                  { self->arrive(); }),
+                            0)...};
+        (void)expand;
+    }
+};
+
+template <class T>
+struct when_all_vector_context
+{
+    std::vector<std::shared_ptr<future_state<T>>> states;
+    std::atomic<std::size_t> remaining;
+    promise<std::vector<T>> p;
+
+    explicit when_all_vector_context(std::size_t n) : remaining(n) { states.reserve(n); }
+
+    void arrive()
+    {
+        if (remaining.fetch_sub(1, std::memory_order_acq_rel) != 1)
+        {
+            return;
+        }
+        std::vector<T> values;
+        values.reserve(states.size());
+        for (std::shared_ptr<future_state<T>> &s : states)
+        {
+            if (s->error())
+            {
+                p.set_exception(s->error());
+                return;
+            }
+            values.push_back(std::move(s->value()));
+        }
+        p.set_value(std::move(values));
+    }
+};
+
+template <class T>
+struct when_any_context
+{
+    std::atomic<bool> done;
+    promise<std::pair<std::size_t, T>> p;
+
+    when_any_context() : done(false) {}
+};
+
+} // namespace detail
+
+/**
+ * @brief 所有 future 完成后得到各自结果组成的 tuple；任一失败时得到(按参数顺序)第一个异常
+ */
+template <class... T>
+future<std::tuple<T...>> when_all(future<T>... fs)
+{
+    typedef detail::when_all_tuple_context<T...> context;
+    std::shared_ptr<context> ctx = std::make_shared<context>();
+    future<std::tuple<T...>> result = ctx->p.get_future();
+    ctx->states = std::make_tuple(fs.take_state()...);
+    if (sizeof...(T) == 0)
+    {
+        ctx->finish(std::index_sequence_for<T...>());
+        return result;
+    }
+    ctx->attach(ctx, std::index_sequence_for<T...>());
+    return result;
+}
+
+/**
+ * @brief 所有 future 完成后按原顺序得到结果数组；任一失败时得到(按下标顺序)第一个异常
+ */
+template <class T>
+future<std::vector<T>> when_all(std::vector<future<T>> fs)
+{
+    typedef detail::when_all_vector_context<T> context;
+    std::shared_ptr<context> ctx = std::make_shared<context>(fs.size());
+    future<std::vector<T>> result = ctx->p.get_future();
+    if (fs.empty())
+    {
+        ctx->p.set_value();
+        return result;
+    }
+    for (future<T> &f : fs)
+    {
+        ctx->states.push_back(f.take_state());
+    }
+    /* 先收集全部状态再注册延续，arrive() 中遍历 states 时不会与这里的 push_back 冲突 */
+    for (std::size_t i = 0; i < ctx->states.size(); ++i)
+    {
+        ctx->states[i]->set_continuation([ctx](detail::future_state<T> &)
+                                         { ctx->arrive(); });
+    }
+    return result;
+}
+
+/**
+ * @brief 第一个完成的 future 决定结果：(下标, 值)；若它失败则得到它的异常
+ */
+template <class T>
+future<std::pair<std::size_t, T>> when_any(std::vector<future<T>> fs)
+{
+    if (fs.empty())
+    {
+        throw std::invalid_argument("when_any: no futures");
+    }
+    typedef detail::when_any_context<T> context;
+    std::shared_ptr<context> ctx = std::make_shared<context>();
+    future<std::pair<std::size_t, T>> result = ctx->p.get_future();
+    for (std::size_t i = 0; i < fs.size(); ++i)
+    {
+        fs[i].take_state()->set_continuation([ctx, i](detail::future_state<T> &s)
+                                             {
+                                                 if (ctx->done.exchange(true, std::memory_order_acq_rel))
+                                                 {
+                                                     return;
+                                                 }
+                                                 if (s.error())
+                                                 {
+                                                     ctx->p.set_exception(s.error());
+                                                 }
+                                                 else
+                                                 {
+                                                     ctx->p.set_value(i, std::move(s.value()));
+                                                 }
+                                             });
+    }
+    return result;
+}
+
+} // namespace learning
+
+#endif // FUTURE_HPP
@@ -0,0 +1,254 @@
+/**
+ * @file future_test.cpp
+ * @author Richard Wang
+ * @brief future / promise 延续示例
+ *  1. then 链：在线程池上依次执行多个 lambda，中间不阻塞任何线程；
+ *  2. 扇出/扇入：并行查询姓名与年龄，when_all 汇总成 std::pair；
+ *  3. when_all(vector) 与 when_any；
+ *  4. 异常沿链条传递；延续返回 future 时自动展开；
+ *  5. 统计堆分配次数：共享状态来自对象池，注册延续本身不分配；对象池预热后整条 then 链没有堆分配。
+ *
+ * 编译: g++ -std=c++14 -O2 -pthread future_test.cpp -o future_test
+ * @version : 1.0
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c), Richard Wang.
+ *
+ */
+
+#include <iostream>
+#include <atomic>
+#include <cassert>
+#include <chrono>
+#include <cstdlib>
+#include <new>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#include "future.hpp"
+
+/* 统计全局 operator new 的调用次数 */
+static std::atomic<long> g_allocations(0);
+
+void *operator new(std::size_t size)
+{
+    ++g_allocations;
+    void *p = std::malloc(size == 0 ? 1 : size);
+    if (p == nullptr)
+    {
+        throw std::bad_alloc();
+    }
+    return p;
+}
+
+/* GCC 内联 operator delete 后会把 free 与 operator new 配对检查，这里的配对是有意的 */
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wmismatched-new-delete"
+#endif
+void operator delete(void *p) noexcept
+{
+    std::free(p);
+}
+
+void operator delete(void *p, std::size_t) noexcept
+{
+    std::free(p);
+}
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic pop
+#endif
+
+typedef std::pair<int, std::string> record_t;
+
+/**
+ * @brief then 链
+ */
+void then_test(learning::thread_pool &pool)
+{
+    std::cout << "------------- test then ------------------" << std::endl;
+    learning::future<int> f = learning::async(pool, []()
+                                              { return 20; })
+                                  .then(pool, [](int v)
+                                        { return v + 1; })
+                                  .then([](int v)
+                                        { return v * 2; });
+    std::cout << "result: " << f.get() << std::endl;
+
+    learning::future<learning::unit> done = learning::async(pool, []()
+                                                            { std::cout << "void task runs on pool" << std::endl; })
+                                                .then([]()
+                                                      { std::cout << "then without argument" << std::endl; });
+    done.get();
+}
+
+/**
+ * @brief 模拟两个独立的远程查询，when_all 汇总结果
+ */
+void fan_out_test(learning::thread_pool &pool)
+{
+    std::cout << "------------- test fan-out / fan-in ------------------" << std::endl;
+    const char *names[] = {"Mark", "Jack", "Jim", "Rose"};
+    std::vector<learning::future<record_t>> requests;
+    for (int id = 0; id < 4; ++id)
+    {
+        learning::future<std::string> name = learning::async(pool, [id, &names]()
+                                                             {
+                                                                 std::this_thread::sleep_for(std::chrono::milliseconds(20));
+                                                                 return std::string(names[id]);
+                                                             });
+        learning::future<int> age = learning::async(pool, [id]()
+                                                    {
+                                                        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+                                                        return 11 + id * 3;
+                                                    });
+        requests.push_back(learning::when_all(std::move(age), std::move(name))
+                               .then([](std::tuple<int, std::string> t)
+                                     { return record_t(std::get<0>(t), std::move(std::get<1>(t))); }));
+    }
+
+    std::vector<record_t> records = learning::when_all(std::move(requests)).get();
+    for (const record_t &r : records)
+    {
+        std::cout << "Name: " << r.second << ", Age:" << r.first << std::endl;
+    }
+}
+
+/**
+ * @brief 多个副本中最快返回的那个
+ */
+void when_any_test(learning::thread_pool &pool)
+{
+    std::cout << "------------- test when_any ------------------" << std::endl;
+    std::vector<learning::future<std::string>> replicas;
+    const int delays[] = {60, 10, 40};
+    for (int i = 0; i < 3; ++i)
+    {
+        const int delay = delays[i];
+        replicas.push_back(learning::async(pool, [delay]()
+                                           {
+                                               std::this_thread::sleep_for(std::chrono::milliseconds(delay));
+                                               return "answer after " + std::to_string(delay) + " ms";
+                                           }));
+    }
+    std::pair<std::size_t, std::string> first = learning::when_any(std::move(replicas)).get();
+    std::cout << "replica " << first.first << ": " << first.second << std::endl;
+}
+
+/**
+ * @brief 异常传递与 future 展开
+ */
+void error_test(learning::thread_pool &pool)
+{
+    std::cout << "------------- test error / unwrap ------------------" << std::endl;
+    learning::future<int> failed = learning::async(pool, []() -> int
+                                                   { throw std::runtime_error("lookup failed"); })
+                                       .then([](int v)
+                                             {
+                                                 std::cout << "never printed" << std::endl;
+                                                 return v;
+                                             });
+    try
+    {
+        failed.get();
+    }
+    catch (const std::exception &e)
+    {
+        std::cout << "caught: " << e.what() << std::endl;
+    }
+
+    learning::future<int> nested = learning::async(pool, [&pool]()
+                                                   { return learning::async(pool, []()
+                                                                            { return 7; }); })
+                                       .then([](int v)
+                                             { return v * 6; });
+    std::cout << "unwrapped: " << nested.get() << std::endl;
+
+    learning::future<int> broken;
+    {
+        learning::promise<int> p;
+        broken = p.get_future();
+    }
+    try
+    {
+        broken.get();
+    }
+    catch (const std::future_error &e)
+    {
+        std::cout << "caught: " << e.what() << std::endl;
+    }
+}
+
+/**
+ * @brief 在已就绪的 future 上串联 3 个延续：只有 4 个共享状态的分配
+ */
+void allocation_test()
+{
+    std::cout << "------------- test allocations ------------------" << std::endl;
+    std::string suffix = " years";
+    auto add_one = [](int v)
+    { return v + 1; };
+    auto to_text = [suffix](int v)
+    { return std::to_string(v) + suffix; };
+    std::cout << "add_one stored inline: "
+              << learning::small_function<void()>::stores_inline<decltype(add_one)>::value << std::endl;
+    std::cout << "to_text stored inline: "
+              << learning::small_function<void()>::stores_inline<decltype(to_text)>::value << std::endl;
+
+    auto run_chain = []()
+    {
+        return learning::make_ready_future(17)
+            .then([](int v)
+                  { return v + 1; })
+            .then([](int v)
+                  { return v + 1; })
+            .then([](int v)
+                  { return static_cast<std::size_t>(v); })
+            .get();
+    };
+    long before = g_allocations.load();
+    std::size_t v = run_chain();
+    std::cout << "first chain: value " << v << ", heap allocations " << (g_allocations.load() - before) << " (object pool refills)" << std::endl;
+
+    /* 第一条链用完的共享状态已回到本线程的空闲链表，之后的链直接复用 */
+    before = g_allocations.load();
+    for (int i = 0; i < 1000; ++i)
+    {
+        v = run_chain();
+    }
+    const long steady = g_allocations.load() - before;
+    std::cout << "1000 more chains: value " << v << ", heap allocations " << steady << std::endl;
+    assert(steady == 0);
+    (void)steady;
+}
+
+int main()
+{
+    learning::thread_pool pool(8);
+
+    /********************* then_test() **************/
+    then_test(pool);
+    /************************************************/
+
+    /******************* fan_out_test() *************/
+    fan_out_test(pool);
+    /************************************************/
+
+    /******************* when_any_test() ************/
+    when_any_test(pool);
+    /************************************************/
+
+    /******************** error_test() **************/
+    error_test(pool);
+    /************************************************/
+
+    /***************** allocation_test() ************/
+    allocation_test();
+    /************************************************/
+
+    return 0;
+}
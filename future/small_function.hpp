@@ -0,0 +1,173 @@
+/**
+ * @file small_function.hpp
+ * @author Richard Wang
+ * @brief 带小对象优化(SBO)的只移动函数包装器
+ *  1. 与 std::function 的区别
+ *      std::function 要求可拷贝，捕获了 promise / unique_ptr 的 lambda 无法放入；
+ *      libstdc++ 的 std::function 只有 16 字节内联空间，捕获稍多一点就会在堆上分配。
+ *  2. 存储
+ *      可调用对象不超过 Capacity 字节、对齐不超过 max_align_t 且移动构造不抛异常时，直接构造在内部缓冲区中；
+ *      否则在堆上分配，缓冲区中只保存指针。
+ *  3. 调用
+ *      通过一张静态函数表(调用/移动/析构)分派，没有虚函数，也没有 RTTI。
+ * @version : 1.0
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c), Richard Wang.
+ *
+ */
+#ifndef SMALL_FUNCTION_HPP
+#define SMALL_FUNCTION_HPP
+
+#include <cstddef>
+#include <functional>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace learning
+{
+
+template <class Signature, std::size_t Capacity = 64>
+class small_function;
+
+template <class R, class... Args, std::size_t Capacity>
+class small_function<R(Args...), Capacity>
+{
+public:
+    /* F 能否内联存储(不发生堆分配) */
+    template <class F>
+    struct stores_inline
+        : std::integral_constant<bool, sizeof(F) <= Capacity && alignof(F) <= alignof(std::max_align_t) &&
+                                           std::is_nothrow_move_constructible<F>::value>
+    {
+    };
+
+    small_function() noexcept : vtable_(nullptr) {}
+    small_function(std::nullptr_t) noexcept : vtable_(nullptr) {}
+
+    template <class F, class D = typename std::decay<F>::type,
+              class = typename std::enable_if<!std::is_same<D, small_function>::value>::type>
+    small_function(F &&f) : vtable_(nullptr)
+    {
+        construct<D>(std::forward<F>(f), stores_inline<D>());
+    }
+
+    small_function(small_function &&other) noexcept : vtable_(other.vtable_)
+    {
+        if (vtable_ != nullptr)
+        {
+            vtable_->move(&other.buffer_, &buffer_);
+            other.vtable_ = nullptr;
+        }
+    }
+
+    small_function &operator=(small_function &&other) noexcept
+    {
+        if (this != &other)
+        {
+            reset();
+            if (other.vtable_ != nullptr)
+            {
+                other.vtable_->move(&other.buffer_, &buffer_);
+                vtable_ = other.vtable_;
+                other.vtable_ = nullptr;
+            }
+        }
+        return *this;
+    }
+
+    small_function &operator=(std::nullptr_t) noexcept
+    {
+        reset();
+        return *this;
+    }
+
+    ~small_function() { reset(); }
+
+    small_function(const small_function &) = delete;
+    small_function &operator=(const small_function &) = delete;
+
+    explicit operator bool() const noexcept { return vtable_ != nullptr; }
+
+    /* 空对象调用时抛出 std::bad_function_call */
+    R operator()(Args... args)
+    {
+        if (vtable_ == nullptr)
+        {
+            throw std::bad_function_call();
+        }
+        return vtable_->invoke(&buffer_, std::forward<Args>(args)...);
+    }
+
+private:
+    typedef typename std::aligned_storage<Capacity, alignof(std::max_align_t)>::type storage_type;
+
+    struct vtable
+    {
+        R (*invoke)(void *, Args &&...);
+        void (*move)(void *, void *) noexcept;
+        void (*destroy)(void *) noexcept;
+    };
+
+    /* 内联存储：对象就在缓冲区中 */
+    template <class F>
+    struct inline_ops
+    {
+        static F *get(void *p) { return static_cast<F *>(p); }
+        static R invoke(void *p, Args &&...args) { return (*get(p))(std::forward<Args>(args)...); }
+        static void move(void *from, void *to) noexcept
+        {
+            ::new (to) F(std::move(*get(from)));
+            get(from)->~F();
+        }
+        static void destroy(void *p) noexcept { get(p)->~F(); }
+    };
+
+    /* 堆存储：缓冲区中只有一个指针，移动时转移指针即可 */
+    template <class F>
+    struct heap_ops
+    {
+        static F *&get(void *p) { return *static_cast<F **>(p); }
+        static R invoke(void *p, Args &&...args) { return (*get(p))(std::forward<Args>(args)...); }
+        static void move(void *from, void *to) noexcept { ::new (to) F *(get(from)); }
+        static void destroy(void *p) noexcept { delete get(p); }
+    };
+
+    template <class Ops>
+    static const vtable *table()
+    {
+        static const vtable t = {&Ops::invoke, &Ops::move, &Ops::destroy};
+        return &t;
+    }
+
+    template <class D, class F>
+    void construct(F &&f, std::true_type)
+    {
+        ::new (static_cast<void *>(&buffer_)) D(std::forward<F>(f));
+        vtable_ = table<inline_ops<D>>();
+    }
+
+    template <class D, class F>
+    void construct(F &&f, std::false_type)
+    {
+        ::new (static_cast<void *>(&buffer_)) D *(new D(std::forward<F>(f)));
+        vtable_ = table<heap_ops<D>>();
+    }
+
+    void reset() noexcept
+    {
+        if (vtable_ != nullptr)
+        {
+            vtable_->destroy(&buffer_);
+            vtable_ = nullptr;
+        }
+    }
+
+    storage_type buffer_;
+    const vtable *vtable_;
+};
+
+} // namespace learning
+
+#endif // SMALL_FUNCTION_HPP
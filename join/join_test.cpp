@@ -0,0 +1,224 @@
+/**
+ * @file join_test.cpp
+ * @author Richard Wang
+ * @brief 连接示例
+ *  1. pair_test() 的 (年龄, 姓名) 与 tuple_test() 的 (年龄, 姓名, 身高) 按 (年龄, 姓名) 连接，再只按姓名连接；
+ *  2. 随机数据上哈希连接、不分区的哈希连接、排序归并连接与 unordered_multimap 的结果对照；
+ *  3. 基准：100 万 x 400 万条记录，基数分区哈希连接、不分区哈希连接、排序归并连接与 unordered_multimap。
+ *
+ * 编译: g++ -std=c++14 -O2 join_test.cpp -o join_test
+ * @version : 1.0
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c), Richard Wang.
+ *
+ */
+
+#include <iostream>
+#include <algorithm>
+#include <list>
+#include <random>
+#include <string>
+#include <tuple>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "../benchmark/benchmark.hpp"
+#include "join.hpp"
+
+typedef std::pair<int, std::string> pair_t;       // (年龄, 姓名)
+typedef std::tuple<int, std::string, int> user_t; // (年龄, 姓名, 身高)
+
+typedef std::pair<int, int> order_t;              // (客户号, 金额)
+typedef std::tuple<int, int, int> visit_t;        // (客户号, 日期, 时长)
+
+/**
+ * @brief pair 与 tuple 连接
+ */
+void record_test()
+{
+    std::cout << "------------- test pair x tuple ------------------" << std::endl;
+    std::vector<pair_t> infos;
+    infos.emplace_back(12, "Mark");
+    infos.emplace_back(11, "Jim");
+    infos.emplace_back(26, "Richard");
+    infos.emplace_back(29, "Jack");
+
+    std::list<user_t> users;
+    users.emplace_back(26, "Richard", 178);
+    users.emplace_back(29, "Jack", 180);
+    users.emplace_back(25, "Simth", 191);
+    users.emplace_back(13, "Mark", 160);
+
+    auto print = [](const pair_t &info, const user_t &user)
+    {
+        std::cout << "Name: " << info.second << ", Age:" << info.first << " <-> Age:" << std::get<0>(user) << ", High: " << std::get<2>(user)
+                  << std::endl;
+    };
+    std::cout << "on (age, name), hash join:" << std::endl;
+    learning::hash_join<learning::key_fields<0, 1>, learning::key_fields<0, 1>>(infos.begin(), infos.end(), users.begin(), users.end(), print);
+    std::cout << "on (age, name), sort-merge join:" << std::endl;
+    learning::sort_merge_join<learning::key_fields<0, 1>, learning::key_fields<0, 1>>(infos.begin(), infos.end(), users.begin(), users.end(), print);
+    std::cout << "on name only:" << std::endl;
+    learning::join_stats stats =
+        learning::hash_join<learning::key_fields<1>, learning::key_fields<1>>(infos.begin(), infos.end(), users.begin(), users.end(), print);
+    std::cout << stats << std::endl;
+}
+
+static std::vector<order_t> make_orders(std::size_t n, int customers, unsigned seed)
+{
+    std::mt19937 rng(seed);
+    std::vector<order_t> orders;
+    orders.reserve(n);
+    for (std::size_t i = 0; i < n; ++i)
+    {
+        orders.emplace_back(static_cast<int>(rng() % customers), static_cast<int>(rng() % 1000));
+    }
+    return orders;
+}
+
+static std::vector<visit_t> make_visits(std::size_t n, int customers, unsigned seed)
+{
+    std::mt19937 rng(seed);
+    std::vector<visit_t> visits;
+    visits.reserve(n);
+    for (std::size_t i = 0; i < n; ++i)
+    {
+        visits.emplace_back(static_cast<int>(rng() % customers), static_cast<int>(rng() % 31), static_cast<int>(rng() % 600));
+    }
+    return visits;
+}
+
+/**
+ * @brief 各种连接方式的结果一致
+ */
+void correctness_test()
+{
+    std::cout << "------------- test correctness ------------------" << std::endl;
+    const std::vector<order_t> orders = make_orders(200000, 150000, 1);
+    const std::vector<visit_t> visits = make_visits(500000, 300000, 2);
+    typedef learning::key_fields<0> by_customer;
+
+    long long checksum[4] = {0, 0, 0, 0};
+    learning::hash_join_options unpartitioned;
+    unpartitioned.radix_bits = 0;
+    learning::join_stats s0 = learning::hash_join<by_customer, by_customer>(orders.begin(), orders.end(), visits.begin(), visits.end(),
+                                                                            [&](const order_t &o, const visit_t &v)
+                                                                            { checksum[0] += o.second * 7 + std::get<2>(v); });
+    learning::join_stats s1 = learning::hash_join<by_customer, by_customer>(orders.begin(), orders.end(), visits.begin(), visits.end(),
+                                                                            [&](const order_t &o, const visit_t &v)
+                                                                            { checksum[1] += o.second * 7 + std::get<2>(v); },
+                                                                            unpartitioned);
+    learning::join_stats s2 = learning::sort_merge_join<by_customer, by_customer>(orders.begin(), orders.end(), visits.begin(), visits.end(),
+                                                                                  [&](const order_t &o, const visit_t &v)
+                                                                                  { checksum[2] += o.second * 7 + std::get<2>(v); });
+    std::unordered_multimap<int, const order_t *> index;
+    for (const order_t &o : orders)
+    {
+        index.emplace(o.first, &o);
+    }
+    std::size_t reference_matches = 0;
+    for (const visit_t &v : visits)
+    {
+        auto range = index.equal_range(std::get<0>(v));
+        for (auto it = range.first; it != range.second; ++it)
+        {
+            checksum[3] += it->second->second * 7 + std::get<2>(v);
+            ++reference_matches;
+        }
+    }
+    std::cout << "radix hash join : " << s0 << ", checksum " << checksum[0] << std::endl;
+    std::cout << "plain hash join : " << s1 << ", checksum " << checksum[1] << std::endl;
+    std::cout << "sort-merge join : " << s2 << ", checksum " << checksum[2] << std::endl;
+    std::cout << "unordered_multimap: matches " << reference_matches << ", checksum " << checksum[3] << std::endl;
+    std::cout << "all equal: " << std::boolalpha
+              << (checksum[0] == checksum[3] && checksum[1] == checksum[3] && checksum[2] == checksum[3] && s0.matches == reference_matches) << std::endl;
+}
+
+/**
+ * @brief 大数据量连接
+ */
+void benchmark_test()
+{
+    std::cout << "------------- test benchmark ------------------" << std::endl;
+    const std::vector<order_t> orders = make_orders(1000000, 1000000, 3);
+    const std::vector<visit_t> visits = make_visits(4000000, 2000000, 4);
+    typedef learning::key_fields<0> by_customer;
+
+    learning::benchmark_options options;
+    options.max_time_ms = 4000;
+    options.min_samples = 5;
+    options.max_samples = 5;
+    learning::benchmark_runner runner(options);
+    auto run_hash = [&orders, &visits](learning::benchmark_state &state, int radix_bits)
+    {
+        learning::hash_join_options join_options;
+        join_options.radix_bits = radix_bits;
+        learning::join_stats stats;
+        while (state.keep_running())
+        {
+            long long sum = 0;
+            stats = learning::hash_join<by_customer, by_customer>(orders.begin(), orders.end(), visits.begin(), visits.end(),
+                                                                  [&sum](const order_t &o, const visit_t &v)
+                                                                  { sum += o.second + std::get<2>(v); },
+                                                                  join_options);
+            learning::do_not_optimize(sum);
+        }
+        state.add_counter("partitions", static_cast<double>(stats.partitions * state.iterations()));
+    };
+    runner.add("join/hash_radix_auto", [run_hash](learning::benchmark_state &state)
+               { run_hash(state, -1); });
+    runner.add("join/hash_unpartitioned", [run_hash](learning::benchmark_state &state)
+               { run_hash(state, 0); });
+    runner.add("join/sort_merge", [&orders, &visits](learning::benchmark_state &state)
+               {
+                   while (state.keep_running())
+                   {
+                       long long sum = 0;
+                       learning::sort_merge_join<by_customer, by_customer>(orders.begin(), orders.end(), visits.begin(), visits.end(),
+                                                                           [&sum](const order_t &o, const visit_t &v)
+                                                                           { sum += o.second + std::get<2>(v); });
+                       learning::do_not_optimize(sum);
+                   }
+               });
+    runner.add("join/unordered_multimap", [&orders, &visits](learning::benchmark_state &state)
+               {
+                   while (state.keep_running())
+                   {
+                       std::unordered_multimap<int, const order_t *> index;
+                       for (const order_t &o : orders)
+                       {
+                           index.emplace(o.first, &o);
+                       }
+                       long long sum = 0;
+                       for (const visit_t &v : visits)
+                       {
+                           auto range = index.equal_range(std::get<0>(v));
+                           for (auto it = range.first; it != range.second; ++it)
+                           {
+                               sum += it->second->second + std::get<2>(v);
+                           }
+                       }
+                       learning::do_not_optimize(sum);
+                   }
+               });
+    runner.run(std::cout);
+}
+
+int main()
+{
+    /******************** record_test() *************/
+    record_test();
+    /************************************************/
+
+    /*************** correctness_test() *************/
+    correctness_test();
+    /************************************************/
+
+    /****************** benchmark_test() ************/
+    benchmark_test();
+    /************************************************/
+
+    return 0;
+}
@@ -39,6 +39,8 @@
 #include <thread>
 #include <chrono>
 
+#include "../stop_token/stop_token.hpp"
+
 bool cmp(int a, int b)
 {
     return a < b;
@@ -233,15 +235,16 @@ void test_with_capture_list()
 
             void init()
             {
-                std::thread([this]()
-                            {
-                                while (1)
-                                {
-                                    std::this_thread::sleep_for(std::chrono::milliseconds(1000));
-                                    std::cout << val << std::endl;
-                                }
-                            })
-                    .join();
+                /* 可取消的 jthread：每秒打印一次 val；request_stop() 后睡眠立即被唤醒，线程退出，jthread 析构时 join */
+                learning::jthread worker([this](learning::stop_token token)
+                                         {
+                                             while (learning::interruptible_sleep_for(token, std::chrono::milliseconds(1000)))
+                                             {
+                                                 std::cout << val << std::endl;
+                                             }
+                                         });
+                std::this_thread::sleep_for(std::chrono::milliseconds(3500));
+                worker.request_stop();
             }
 
         private:
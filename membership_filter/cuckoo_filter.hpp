@@ -0,0 +1,339 @@
+/**
+ * @file cuckoo_filter.hpp
+ * @author Richard Wang
+ * @brief 支持删除的布谷鸟过滤器(Fan et al. 2014)，直接对 pair / tuple / 字符串键求哈希
+ *  1. 结构
+ *      每桶 4 个槽位，每个槽位保存键的指纹(Fingerprint 为 uint8_t 或 uint16_t，0 表示空)；桶数 n 不要求是 2 的幂，按容量精确分配。
+ *      键的两个候选桶：i1 由哈希值低 32 位映射到 [0, n)，i2 = (h(指纹) - i1) mod n；
+ *      i1 = (h(指纹) - i2) mod n 同样成立，由任一候选桶和指纹都能算出另一个，因此搬动指纹时不需要原始键。
+ *      (原论文的 i1 ^ h(指纹) 要求桶数为 2 的幂，容量最多浪费一半。)
+ *  2. 插入 / 查询 / 删除
+ *      插入时两个候选桶都满，就随机踢出一个指纹放到它的另一个桶，最多踢 500 次；仍然失败时最后一个被踢出的指纹
+ *      放进唯一的 "受害者" 槽位，过滤器视为已满，之后的 insert 返回 false(已有的键不会丢失)。
+ *      查询只检查两个桶：一个桶的 4 个指纹正好是一个 32 / 64 位字，用 SWAR(按字节 / 半字找零)一次比较 4 个槽位。
+ *      erase 删除一个相同的指纹；只能删除确实插入过的键，否则可能删掉另一个键的指纹。
+ *  3. 误判率与空间
+ *      误判率约为 2 * 4 / 2^f(f 为指纹位数)：uint8_t 约 3.1%，uint16_t 约 0.012%；
+ *      装载率可达约 95%，每键约 f / 0.95 位。expected_fpr() / bits_per_key() 给出当前实例的数值，
+ *      fingerprint_bits_for(fpr) 给出达到目标误判率需要的指纹位数。
+ *      同样的误判率下，误判率较低(< 0.5% 左右)时布谷鸟过滤器比 Bloom 过滤器省空间，且可以删除。
+ *
+ *  learning::cuckoo_filter<uint16_t> names(1000000);
+ *  names.insert(std::string("Richard"));
+ *  names.contains("Richard");   // true
+ *  names.erase(std::string("Richard"));
+ * @version : 1.0
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c), Richard Wang.
+ *
+ */
+#ifndef CUCKOO_FILTER_HPP
+#define CUCKOO_FILTER_HPP
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "../flat_hash_map/tuple_hash.hpp"
+
+namespace learning
+{
+
+namespace detail
+{
+
+/* 4 个槽位打包为一个字后用 "找零" 位运算比较；Word 为 uint32_t(8 位指纹) 或 uint64_t(16 位指纹) */
+template <class Fingerprint>
+struct cuckoo_word;
+
+template <>
+struct cuckoo_word<uint8_t>
+{
+    typedef uint32_t type;
+    static const type kLow = 0x01010101U;
+    static const type kHigh = 0x80808080U;
+};
+
+template <>
+struct cuckoo_word<uint16_t>
+{
+    typedef uint64_t type;
+    static const type kLow = 0x0001000100010001ULL;
+    static const type kHigh = 0x8000800080008000ULL;
+};
+
+} // namespace detail
+
+template <class Fingerprint = uint16_t>
+class cuckoo_filter
+{
+    static_assert(std::is_same<Fingerprint, uint8_t>::value || std::is_same<Fingerprint, uint16_t>::value,
+                  "cuckoo_filter: fingerprint must be uint8_t or uint16_t");
+
+public:
+    static const std::size_t kSlots = 4;
+    static const int kMaxKicks = 500;
+    static const int kFingerprintBits = static_cast<int>(sizeof(Fingerprint) * 8);
+
+    /* 至少能以 95% 装载率容纳 capacity 个键 */
+    explicit cuckoo_filter(std::size_t capacity)
+        : buckets_(bucket_count(capacity)), size_(0), has_victim_(false), victim_index_(0),
+          victim_fp_(0), rng_(0x9e3779b97f4a7c15ULL)
+    {
+    }
+
+    /* 插入；过滤器已满时返回 false */
+    template <class Key>
+    bool insert(const Key &key)
+    {
+        return insert_hash(key_hasher_t<Key>()(key));
+    }
+
+    template <class Key>
+    bool contains(const Key &key) const
+    {
+        return contains_hash(key_hasher_t<Key>()(key));
+    }
+
+    /* 删除一个之前插入过的键；找不到对应指纹时返回 false */
+    template <class Key>
+    bool erase(const Key &key)
+    {
+        return erase_hash(key_hasher_t<Key>()(key));
+    }
+
+    bool insert_hash(uint64_t hash)
+    {
+        if (has_victim_)
+        {
+            return false;
+        }
+        Fingerprint fp = fingerprint(hash);
+        std::size_t i1 = primary_index(hash);
+        std::size_t i2 = alt_index(i1, fp);
+        if (add(i1, fp) || add(i2, fp))
+        {
+            ++size_;
+            return true;
+        }
+        std::size_t i = (rng() & 1) ? i1 : i2;
+        for (int kick = 0; kick < kMaxKicks; ++kick)
+        {
+            const std::size_t slot = rng() % kSlots;
+            std::swap(fp, buckets_[i].fp[slot]);
+            i = alt_index(i, fp);
+            if (add(i, fp))
+            {
+                ++size_;
+                return true;
+            }
+        }
+        /* 被踢出的最后一个指纹存入受害者槽位，保证不丢失已插入的键 */
+        has_victim_ = true;
+        victim_index_ = i;
+        victim_fp_ = fp;
+        ++size_;
+        return true;
+    }
+
+    bool contains_hash(uint64_t hash) const
+    {
+        const Fingerprint fp = fingerprint(hash);
+        const std::size_t i1 = primary_index(hash);
+        const std::size_t i2 = alt_index(i1, fp);
+        if (has_fingerprint(i1, fp) || has_fingerprint(i2, fp))
+        {
+            return true;
+        }
+        return has_victim_ && victim_fp_ == fp && (victim_index_ == i1 || victim_index_ == i2);
+    }
+
+    bool erase_hash(uint64_t hash)
+    {
+        const Fingerprint fp = fingerprint(hash);
+        const std::size_t i1 = primary_index(hash);
+        const std::size_t i2 = alt_index(i1, fp);
+        if (remove(i1, fp) || remove(i2, fp))
+        {
+            --size_;
+            /* 腾出了位置，尝试把受害者放回桶中 */
+            if (has_victim_)
+            {
+                has_victim_ = false;
+                --size_;
+                reinsert_victim();
+            }
+            return true;
+        }
+        if (has_victim_ && victim_fp_ == fp && (victim_index_ == i1 || victim_index_ == i2))
+        {
+            has_victim_ = false;
+            --size_;
+            return true;
+        }
+        return false;
+    }
+
+    void clear()
+    {
+        std::fill(buckets_.begin(), buckets_.end(), bucket());
+        size_ = 0;
+        has_victim_ = false;
+    }
+
+    /* 达到目标误判率所需的指纹位数 */
+    static int fingerprint_bits_for(double target_fpr)
+    {
+        if (!(target_fpr > 0 && target_fpr < 1))
+        {
+            throw std::invalid_argument("cuckoo_filter: target fpr must be in (0, 1)");
+        }
+        return static_cast<int>(std::ceil(std::log2(2.0 * kSlots / target_fpr)));
+    }
+
+    /* 当前指纹位数下的误判率上界 */
+    static double expected_fpr() { return 2.0 * kSlots / std::pow(2.0, kFingerprintBits); }
+
+    std::size_t size() const { return size_; }
+    std::size_t capacity() const { return buckets_.size() * kSlots; }
+    bool full() const { return has_victim_; }
+    double load_factor() const { return static_cast<double>(size_) / capacity(); }
+    std::size_t size_bytes() const { return buckets_.size() * sizeof(bucket); }
+
+    /* 按当前键数计算的每键位数 */
+    double bits_per_key() const { return size_ == 0 ? 0.0 : 8.0 * size_bytes() / size_; }
+
+private:
+    typedef typename detail::cuckoo_word<Fingerprint>::type word_type;
+
+    struct bucket
+    {
+        Fingerprint fp[kSlots];
+
+        bucket() : fp() {}
+    };
+    static_assert(sizeof(bucket) == sizeof(word_type), "cuckoo_filter: bucket must pack into one word");
+
+    static std::size_t bucket_count(std::size_t capacity)
+    {
+        const double need = std::ceil(static_cast<double>(capacity == 0 ? 1 : capacity) / (kSlots * 0.95));
+        if (need >= 4294967296.0)
+        {
+            throw std::length_error("cuckoo_filter: too many buckets");
+        }
+        return static_cast<std::size_t>(need);
+    }
+
+    /* 32 位值乘以桶数取高 32 位，映射到 [0, n)，不用除法 */
+    std::size_t reduce(uint64_t x) const { return static_cast<std::size_t>(((x & 0xffffffffULL) * buckets_.size()) >> 32); }
+
+    std::size_t primary_index(uint64_t hash) const { return reduce(hash); }
+
+    /* 指纹取哈希值的高位(桶号用低位)；0 表示空槽位，映射为 1 */
+    static Fingerprint fingerprint(uint64_t hash)
+    {
+        const Fingerprint fp = static_cast<Fingerprint>(hash >> (64 - kFingerprintBits));
+        return fp == 0 ? Fingerprint(1) : fp;
+    }
+
+    std::size_t alt_index(std::size_t i, Fingerprint fp) const
+    {
+        const std::size_t h = reduce(hash_mix(fp));
+        return h >= i ? h - i : h + buckets_.size() - i;
+    }
+
+    bool has_fingerprint(std::size_t i, Fingerprint fp) const
+    {
+        typedef detail::cuckoo_word<Fingerprint> w;
+        word_type word;
+        std::memcpy(&word, buckets_[i].fp, sizeof(word));
+        const word_type x = word ^ (w::kLow * fp); // 相同的槽位变为 0
+        return ((x - w::kLow) & ~x & w::kHigh) != 0;
+    }
+
+    bool add(std::size_t i, Fingerprint fp)
+    {
+        for (std::size_t s = 0; s < kSlots; ++s)
+        {
+            if (buckets_[i].fp[s] == 0)
+            {
+                buckets_[i].fp[s] = fp;
+                return true;
+            }
+        }
+        return false;
+    }
+
+    bool remove(std::size_t i, Fingerprint fp)
+    {
+        for (std::size_t s = 0; s < kSlots; ++s)
+        {
+            if (buckets_[i].fp[s] == fp)
+            {
+                buckets_[i].fp[s] = 0;
+                return true;
+            }
+        }
+        return false;
+    }
+
+    void reinsert_victim()
+    {
+        std::size_t i = victim_index_;
+        Fingerprint fp = victim_fp_;
+        if (add(i, fp) || add(alt_index(i, fp), fp))
+        {
+            ++size_;
+            return;
+        }
+        for (int kick = 0; kick < kMaxKicks; ++kick)
+        {
+            const std::size_t slot = rng() % kSlots;
+            std::swap(fp, buckets_[i].fp[slot]);
+            i = alt_index(i, fp);
+            if (add(i, fp))
+            {
+                ++size_;
+                return;
+            }
+        }
+        has_victim_ = true;
+        victim_index_ = i;
+        victim_fp_ = fp;
+        ++size_;
+    }
+
+    /* xorshift64，只用于选择被踢出的槽位 */
+    uint64_t rng()
+    {
+        rng_ ^= rng_ << 13;
+        rng_ ^= rng_ >> 7;
+        rng_ ^= rng_ << 17;
+        return rng_;
+    }
+
+    std::vector<bucket> buckets_;
+    std::size_t size_;
+    bool has_victim_;
+    std::size_t victim_index_;
+    Fingerprint victim_fp_;
+    uint64_t rng_;
+};
+
+template <class Fingerprint>
+const std::size_t cuckoo_filter<Fingerprint>::kSlots;
+template <class Fingerprint>
+const int cuckoo_filter<Fingerprint>::kMaxKicks;
+template <class Fingerprint>
+const int cuckoo_filter<Fingerprint>::kFingerprintBits;
+
+} // namespace learning
+
+#endif // CUCKOO_FILTER_HPP
@@ -0,0 +1,231 @@
+/**
+ * @file membership_filter_test.cpp
+ * @author Richard Wang
+ * @brief Bloom 过滤器与布谷鸟过滤器示例
+ *  1. tie_test() 中的 (日期, 月份, 国家) 记录：按姓名字符串、按 (日期, 月份) 判断是否存在，用 const char* 视图键查询；
+ *  2. 误判率与空间：不同的每键位数 / 指纹位数下，估计值与实测值对照；
+ *  3. 布谷鸟过滤器删除、装满后的行为；
+ *  4. 基准：100 万个键，blocked_bloom_filter / cuckoo_filter / flat_hash_map 查询不存在的键。
+ *
+ * 编译: g++ -std=c++14 -O2 membership_filter_test.cpp -o membership_filter_test
+ *       加 -mavx2 (或 -march=native) 时 Bloom 过滤器使用 AVX2 查询
+ * @version : 1.0
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c), Richard Wang.
+ *
+ */
+
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#include "../benchmark/benchmark.hpp"
+#include "../flat_hash_map/flat_hash_map.hpp"
+#include "bloom_filter.hpp"
+#include "cuckoo_filter.hpp"
+
+typedef std::tuple<int, std::string, std::string> info_t; // (日期, 月份, 国家)
+
+/**
+ * @brief 记录键
+ */
+void record_test()
+{
+    std::cout << "------------- test record keys ------------------" << std::endl;
+    std::vector<info_t> infos;
+    infos.emplace_back(1, "Jan", "China");
+    infos.emplace_back(14, "Feb", "USA");
+    infos.emplace_back(25, "Dec", "UK");
+
+    learning::blocked_bloom_filter by_date = learning::blocked_bloom_filter::for_fpr(infos.size(), 0.01);
+    learning::cuckoo_filter<uint16_t> by_country(infos.size());
+    for (const info_t &info : infos)
+    {
+        by_date.insert(std::make_tuple(std::get<0>(info), std::get<1>(info)));
+        by_country.insert(std::get<2>(info));
+    }
+
+    std::cout << std::boolalpha;
+    std::cout << "(1, Jan)   : " << by_date.may_contain(std::make_tuple(1, "Jan")) << std::endl;
+    std::cout << "(14, Feb)  : " << by_date.may_contain(std::make_pair(14, "Feb")) << std::endl;
+    std::cout << "(2, Jan)   : " << by_date.may_contain(std::make_tuple(2, "Jan")) << std::endl;
+    std::cout << "China      : " << by_country.contains("China") << std::endl;
+    std::cout << "France     : " << by_country.contains("France") << std::endl;
+    by_country.erase(std::string("China"));
+    std::cout << "China after erase: " << by_country.contains("China") << std::endl;
+}
+
+static uint64_t key_of(std::size_t i)
+{
+    return i * 0x9e3779b97f4a7c15ULL + 12345;
+}
+
+template <class Filter, class Probe>
+double measure_fpr(const Filter &filter, std::size_t inserted, Probe probe)
+{
+    const std::size_t trials = 1000000;
+    std::size_t positives = 0;
+    for (std::size_t i = 0; i < trials; ++i)
+    {
+        positives += probe(filter, key_of(inserted + i)) ? 1 : 0;
+    }
+    return static_cast<double>(positives) / trials;
+}
+
+/**
+ * @brief 误判率与空间
+ */
+void tradeoff_test()
+{
+    std::cout << "------------- test fpr / space ------------------" << std::endl;
+    const std::size_t n = 1000000;
+    std::cout << std::fixed << std::setprecision(4);
+    std::cout << "blocked bloom (" << learning::blocked_bloom_filter::probe_kind() << " probe)" << std::endl;
+    const double bits[] = {6, 8, 10, 12, 16, 20};
+    for (double b : bits)
+    {
+        learning::blocked_bloom_filter f(n, b);
+        for (std::size_t i = 0; i < n; ++i)
+        {
+            f.insert(key_of(i));
+        }
+        const double measured = measure_fpr(f, n, [](const learning::blocked_bloom_filter &f, uint64_t k)
+                                            { return f.may_contain(k); });
+        std::cout << "  " << std::setw(5) << b << " bits/key: estimated " << std::setw(7) << 100 * f.expected_fpr() << "%, measured "
+                  << std::setw(7) << 100 * measured << "%, " << f.size_bytes() / 1024 << " KiB" << std::endl;
+    }
+    std::cout << "  bits/key for 1%: " << learning::blocked_bloom_filter::bits_per_key_for(0.01)
+              << ", for 0.1%: " << learning::blocked_bloom_filter::bits_per_key_for(0.001) << std::endl;
+
+    std::cout << "cuckoo" << std::endl;
+    {
+        learning::cuckoo_filter<uint8_t> f(n);
+        for (std::size_t i = 0; i < n; ++i)
+        {
+            f.insert(key_of(i));
+        }
+        const double measured = measure_fpr(f, n, [](const learning::cuckoo_filter<uint8_t> &f, uint64_t k)
+                                            { return f.contains(k); });
+        std::cout << "  uint8_t : bound " << 100 * f.expected_fpr() << "%, measured " << 100 * measured << "%, load " << f.load_factor()
+                  << ", " << f.bits_per_key() << " bits/key" << std::endl;
+    }
+    {
+        learning::cuckoo_filter<uint16_t> f(n);
+        for (std::size_t i = 0; i < n; ++i)
+        {
+            f.insert(key_of(i));
+        }
+        const double measured = measure_fpr(f, n, [](const learning::cuckoo_filter<uint16_t> &f, uint64_t k)
+                                            { return f.contains(k); });
+        std::cout << "  uint16_t: bound " << 100 * f.expected_fpr() << "%, measured " << 100 * measured << "%, load " << f.load_factor()
+                  << ", " << f.bits_per_key() << " bits/key" << std::endl;
+    }
+    std::cout << "  fingerprint bits for 0.1%: " << learning::cuckoo_filter<>::fingerprint_bits_for(0.001) << std::endl;
+    std::cout << std::defaultfloat;
+}
+
+/**
+ * @brief 删除与装满
+ */
+void cuckoo_test()
+{
+    std::cout << "------------- test cuckoo erase / full ------------------" << std::endl;
+    learning::cuckoo_filter<uint16_t> f(100000);
+    std::size_t inserted = 0;
+    while (f.insert(key_of(inserted)))
+    {
+        ++inserted;
+    }
+    std::cout << "capacity " << f.capacity() << ", inserted " << inserted << " before full, load " << f.load_factor() << std::endl;
+
+    std::size_t missing = 0;
+    for (std::size_t i = 0; i < inserted; ++i)
+    {
+        missing += f.contains(key_of(i)) ? 0 : 1;
+    }
+    std::cout << "false negatives: " << missing << std::endl;
+
+    for (std::size_t i = 0; i < inserted; i += 2)
+    {
+        f.erase(key_of(i));
+    }
+    missing = 0;
+    for (std::size_t i = 1; i < inserted; i += 2)
+    {
+        missing += f.contains(key_of(i)) ? 0 : 1;
+    }
+    std::cout << "after erasing half: size " << f.size() << ", full " << std::boolalpha << f.full() << ", false negatives among kept " << missing
+              << std::endl;
+}
+
+/**
+ * @brief 查询不存在的键
+ */
+void benchmark_test()
+{
+    std::cout << "------------- test benchmark ------------------" << std::endl;
+    const std::size_t n = 1000000;
+    learning::blocked_bloom_filter bloom(n, 10);
+    learning::cuckoo_filter<uint16_t> cuckoo(n);
+    learning::flat_hash_map<uint64_t, int> map(n);
+    for (std::size_t i = 0; i < n; ++i)
+    {
+        bloom.insert(key_of(i));
+        cuckoo.insert(key_of(i));
+        map.try_emplace(key_of(i), 0);
+    }
+
+    learning::benchmark_options options;
+    options.max_time_ms = 1000;
+    learning::benchmark_runner runner(options);
+    auto probe_with = [n](learning::benchmark_state &state, auto contains)
+    {
+        std::size_t next = n;
+        while (state.keep_running())
+        {
+            std::size_t hits = 0;
+            for (int i = 0; i < 1000; ++i)
+            {
+                hits += contains(key_of(next++ % (8 * n))) ? 1 : 0;
+            }
+            learning::do_not_optimize(hits);
+        }
+        state.add_counter("lookups", static_cast<double>(state.iterations() * 1000));
+    };
+    runner.add(std::string("lookup/blocked_bloom_") + learning::blocked_bloom_filter::probe_kind(), [&](learning::benchmark_state &state)
+               { probe_with(state, [&bloom](uint64_t k)
+                            { return bloom.may_contain(k); }); });
+    runner.add("lookup/cuckoo_uint16", [&](learning::benchmark_state &state)
+               { probe_with(state, [&cuckoo](uint64_t k)
+                            { return cuckoo.contains(k); }); });
+    runner.add("lookup/flat_hash_map", [&](learning::benchmark_state &state)
+               { probe_with(state, [&map](uint64_t k)
+                            { return map.contains(k); }); });
+    runner.run(std::cout);
+    std::cout << "memory: bloom " << bloom.size_bytes() / 1024 << " KiB, cuckoo " << cuckoo.size_bytes() / 1024 << " KiB" << std::endl;
+}
+
+int main()
+{
+    /******************** record_test() *************/
+    record_test();
+    /************************************************/
+
+    /****************** tradeoff_test() *************/
+    tradeoff_test();
+    /************************************************/
+
+    /******************* cuckoo_test() **************/
+    cuckoo_test();
+    /************************************************/
+
+    /****************** benchmark_test() ************/
+    benchmark_test();
+    /************************************************/
+
+    return 0;
+}
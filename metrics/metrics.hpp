@@ -0,0 +1,406 @@
+/**
+ * @file metrics.hpp
+ * @author Richard Wang
+ * @brief 分片计数器、仪表(gauge)、直方图与指标注册表
+ *  1. 分片
+ *      每个指标把数据分成 kMetricShards 份，每份独占缓存行；线程第一次使用时分到一个固定的分片编号，
+ *      之后只写自己的分片。线程数不超过分片数时，各线程写的缓存行互不相同，没有伪共享，
+ *      fetch_add 总在本核缓存中完成(几个 ns)；读取(scrape)时才把所有分片相加。
+ *  2. 指标类型
+ *      counter   : 单调递增，add(n)；
+ *      gauge     : 当前值，set / add；写入频率通常很低，因此不分片；
+ *      histogram : 固定桶边界，observe(v) 累加所在桶的计数与总和，读取时得到各桶计数、总和与次数。
+ *  3. 注册表
+ *      按名字查找或创建指标，返回的引用在注册表生命周期内一直有效，热路径上应缓存该引用而不是每次按名字查找。
+ *      write_text() 输出 Prometheus 文本格式的快照。
+ *
+ *  learning::counter &processed = learning::metrics_registry::global().counter("records_processed_total", "records seen by for_each");
+ *  for_each(list.begin(), list.end(), [&](const record_t &r) { processed.add(); ... });
+ * @version : 1.0
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c), Richard Wang.
+ *
+ */
+#ifndef METRICS_HPP
+#define METRICS_HPP
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <ostream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace learning
+{
+
+static const std::size_t kMetricShards = 64;
+
+namespace detail
+{
+
+static const std::size_t kMetricCacheLine = 64;
+
+/* 当前线程的分片编号：第一次调用时按顺序分配 */
+inline std::size_t metric_shard_index()
+{
+    static std::atomic<std::size_t> next(0);
+    static thread_local std::size_t index = next.fetch_add(1, std::memory_order_relaxed) % kMetricShards;
+    return index;
+}
+
+/**
+ * @brief kMetricShards 组原子变量，每组 width 个，组与组之间按缓存行对齐
+ */
+class sharded_cells
+{
+public:
+    explicit sharded_cells(std::size_t width)
+        : width_(width),
+          stride_((width * sizeof(std::atomic<uint64_t>) + kMetricCacheLine - 1) / kMetricCacheLine * kMetricCacheLine),
+          buffer_(new unsigned char[stride_ * kMetricShards + kMetricCacheLine])
+    {
+        const std::uintptr_t raw = reinterpret_cast<std::uintptr_t>(buffer_.get());
+        base_ = buffer_.get() + (kMetricCacheLine - raw % kMetricCacheLine) % kMetricCacheLine;
+        for (std::size_t s = 0; s < kMetricShards; ++s)
+        {
+            for (std::size_t i = 0; i < width_; ++i)
+            {
+                new (&shard(s)[i]) std::atomic<uint64_t>(0);
+            }
+        }
+    }
+
+    sharded_cells(const sharded_cells &) = delete;
+    sharded_cells &operator=(const sharded_cells &) = delete;
+
+    std::size_t width() const { return width_; }
+
+    std::atomic<uint64_t> *shard(std::size_t s) const
+    {
+        return reinterpret_cast<std::atomic<uint64_t> *>(base_ + s * stride_);
+    }
+
+    std::atomic<uint64_t> *local() const { return shard(metric_shard_index()); }
+
+    /* 第 i 个变量在所有分片上的和 */
+    uint64_t sum(std::size_t i) const
+    {
+        uint64_t total = 0;
+        for (std::size_t s = 0; s < kMetricShards; ++s)
+        {
+            total += shard(s)[i].load(std::memory_order_relaxed);
+        }
+        return total;
+    }
+
+private:
+    std::size_t width_;
+    std::size_t stride_;
+    std::unique_ptr<unsigned char[]> buffer_;
+    unsigned char *base_;
+};
+
+inline uint64_t double_to_bits(double v)
+{
+    uint64_t bits;
+    std::memcpy(&bits, &v, sizeof(bits));
+    return bits;
+}
+
+inline double bits_to_double(uint64_t bits)
+{
+    double v;
+    std::memcpy(&v, &bits, sizeof(v));
+    return v;
+}
+
+/* 在保存 double 位模式的原子变量上累加；分片通常只有一个写者，CAS 几乎不会失败 */
+inline void atomic_add_double(std::atomic<uint64_t> &cell, double delta)
+{
+    uint64_t expected = cell.load(std::memory_order_relaxed);
+    while (!cell.compare_exchange_weak(expected, double_to_bits(bits_to_double(expected) + delta), std::memory_order_relaxed))
+    {
+    }
+}
+
+/* 输出不带多余零的数字 */
+inline std::string format_number(double v)
+{
+    std::ostringstream os;
+    os.precision(17);
+    os << v;
+    return os.str();
+}
+
+} // namespace detail
+
+/************************ 指标类型 ************************/
+
+class metric
+{
+public:
+    enum kind
+    {
+        kCounter,
+        kGauge,
+        kHistogram
+    };
+
+    metric(std::string name, std::string help, kind k) : name_(std::move(name)), help_(std::move(help)), kind_(k) {}
+    virtual ~metric() {}
+
+    const std::string &name() const { return name_; }
+    const std::string &help() const { return help_; }
+    kind type() const { return kind_; }
+
+    /* 按 Prometheus 文本格式输出当前值(不含 HELP / TYPE 行) */
+    virtual void write_samples(std::ostream &os) const = 0;
+
+private:
+    std::string name_;
+    std::string help_;
+    kind kind_;
+};
+
+class counter : public metric
+{
+public:
+    explicit counter(std::string name, std::string help = "") : metric(std::move(name), std::move(help), kCounter), cells_(1) {}
+
+    void add(uint64_t n = 1) { cells_.local()[0].fetch_add(n, std::memory_order_relaxed); }
+
+    uint64_t value() const { return cells_.sum(0); }
+
+    void write_samples(std::ostream &os) const override { os << name() << " " << value() << "\n"; }
+
+private:
+    detail::sharded_cells cells_;
+};
+
+class gauge : public metric
+{
+public:
+    explicit gauge(std::string name, std::string help = "") : metric(std::move(name), std::move(help), kGauge), bits_(detail::double_to_bits(0.0)) {}
+
+    void set(double v) { bits_.store(detail::double_to_bits(v), std::memory_order_relaxed); }
+    void add(double delta) { detail::atomic_add_double(bits_, delta); }
+    double value() const { return detail::bits_to_double(bits_.load(std::memory_order_relaxed)); }
+
+    void write_samples(std::ostream &os) const override { os << name() << " " << detail::format_number(value()) << "\n"; }
+
+private:
+    std::atomic<uint64_t> bits_;
+};
+
+class histogram : public metric
+{
+public:
+    struct snapshot
+    {
+        std::vector<double> bounds;   // 各桶上界(不含 +Inf)
+        std::vector<uint64_t> counts; // 各桶计数(非累计)，最后一个是 +Inf 桶
+        uint64_t count = 0;
+        double sum = 0;
+
+        /* 按桶线性插值估计分位数，q 取 [0, 1] */
+        double quantile(double q) const
+        {
+            if (count == 0)
+            {
+                return 0;
+            }
+            const double rank = q * static_cast<double>(count);
+            uint64_t seen = 0;
+            for (std::size_t i = 0; i < counts.size(); ++i)
+            {
+                if (counts[i] > 0 && static_cast<double>(seen + counts[i]) >= rank)
+                {
+                    if (i == bounds.size())
+                    {
+                        return bounds.empty() ? 0 : bounds.back();
+                    }
+                    const double lower = i == 0 ? 0 : bounds[i - 1];
+                    return lower + (bounds[i] - lower) * (rank - static_cast<double>(seen)) / static_cast<double>(counts[i]);
+                }
+                seen += counts[i];
+            }
+            return bounds.empty() ? 0 : bounds.back();
+        }
+    };
+
+    /**
+     * @brief bounds 为严格递增的桶上界；值 v 落入第一个满足 v <= bound 的桶
+     */
+    histogram(std::string name, std::vector<double> bounds, std::string help = "")
+        : metric(std::move(name), std::move(help), kHistogram), bounds_(std::move(bounds)), cells_(bounds_.size() + 2)
+    {
+        for (std::size_t i = 1; i < bounds_.size(); ++i)
+        {
+            if (!(bounds_[i - 1] < bounds_[i]))
+            {
+                throw std::invalid_argument("histogram: bounds must be strictly increasing");
+            }
+        }
+        for (std::size_t s = 0; s < kMetricShards; ++s)
+        {
+            cells_.shard(s)[sum_index()].store(detail::double_to_bits(0.0), std::memory_order_relaxed);
+        }
+    }
+
+    /* start, start*factor, start*factor^2, ... 共 count 个上界 */
+    static std::vector<double> exponential_bounds(double start, double factor, std::size_t count)
+    {
+        if (start <= 0 || factor <= 1)
+        {
+            throw std::invalid_argument("histogram: exponential bounds need start > 0 and factor > 1");
+        }
+        std::vector<double> bounds;
+        for (double b = start; bounds.size() < count; b *= factor)
+        {
+            bounds.push_back(b);
+        }
+        return bounds;
+    }
+
+    void observe(double v)
+    {
+        const std::size_t bucket = std::lower_bound(bounds_.begin(), bounds_.end(), v) - bounds_.begin();
+        std::atomic<uint64_t> *cells = cells_.local();
+        cells[bucket].fetch_add(1, std::memory_order_relaxed);
+        detail::atomic_add_double(cells[sum_index()], v);
+    }
+
+    snapshot collect() const
+    {
+        snapshot snap;
+        snap.bounds = bounds_;
+        for (std::size_t i = 0; i <= bounds_.size(); ++i)
+        {
+            snap.counts.push_back(cells_.sum(i));
+            snap.count += snap.counts.back();
+        }
+        for (std::size_t s = 0; s < kMetricShards; ++s)
+        {
+            snap.sum += detail::bits_to_double(cells_.shard(s)[sum_index()].load(std::memory_order_relaxed));
+        }
+        return snap;
+    }
+
+    void write_samples(std::ostream &os) const override
+    {
+        const snapshot snap = collect();
+        uint64_t cumulative = 0;
+        for (std::size_t i = 0; i < snap.bounds.size(); ++i)
+        {
+            cumulative += snap.counts[i];
+            os << name() << "_bucket{le=\"" << detail::format_number(snap.bounds[i]) << "\"} " << cumulative << "\n";
+        }
+        os << name() << "_bucket{le=\"+Inf\"} " << snap.count << "\n";
+        os << name() << "_sum " << detail::format_number(snap.sum) << "\n";
+        os << name() << "_count " << snap.count << "\n";
+    }
+
+private:
+    std::size_t sum_index() const { return bounds_.size() + 1; }
+
+    std::vector<double> bounds_;
+    detail::sharded_cells cells_; // [0, bounds.size()] 为各桶计数，最后一个为总和(double 位模式)
+};
+
+/************************ 注册表 ************************/
+
+class metrics_registry
+{
+public:
+    metrics_registry() {}
+    metrics_registry(const metrics_registry &) = delete;
+    metrics_registry &operator=(const metrics_registry &) = delete;
+
+    /* 进程级默认注册表 */
+    static metrics_registry &global()
+    {
+        static metrics_registry registry;
+        return registry;
+    }
+
+    /**
+     * @brief 查找或创建；同名指标已存在但类型不同时抛出 std::invalid_argument
+     */
+    learning::counter &counter(const std::string &name, const std::string &help = "")
+    {
+        return get_or_create<learning::counter>(name, metric::kCounter, [&]()
+                                                { return new learning::counter(name, help); });
+    }
+
+    learning::gauge &gauge(const std::string &name, const std::string &help = "")
+    {
+        return get_or_create<learning::gauge>(name, metric::kGauge, [&]()
+                                              { return new learning::gauge(name, help); });
+    }
+
+    /* 已存在时忽略 bounds */
+    learning::histogram &histogram(const std::string &name, const std::vector<double> &bounds, const std::string &help = "")
+    {
+        return get_or_create<learning::histogram>(name, metric::kHistogram, [&]()
+                                                  { return new learning::histogram(name, bounds, help); });
+    }
+
+    /* 按名字排序输出所有指标 */
+    void write_text(std::ostream &os) const
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        static const char *type_names[] = {"counter", "gauge", "histogram"};
+        for (const std::map<std::string, std::unique_ptr<metric>>::value_type &kv : metrics_)
+        {
+            const metric &m = *kv.second;
+            if (!m.help().empty())
+            {
+                os << "# HELP " << m.name() << " " << m.help() << "\n";
+            }
+            os << "# TYPE " << m.name() << " " << type_names[m.type()] << "\n";
+            m.write_samples(os);
+        }
+    }
+
+    std::string text() const
+    {
+        std::ostringstream os;
+        write_text(os);
+        return os.str();
+    }
+
+private:
+    template <class M, class Factory>
+    M &get_or_create(const std::string &name, metric::kind k, Factory make)
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        std::map<std::string, std::unique_ptr<metric>>::iterator it = metrics_.find(name);
+        if (it == metrics_.end())
+        {
+            std::unique_ptr<metric> created(make());
+            it = metrics_.emplace(name, std::move(created)).first;
+        }
+        else if (it->second->type() != k)
+        {
+            throw std::invalid_argument("metrics_registry: '" + name + "' already registered with another type");
+        }
+        return static_cast<M &>(*it->second);
+    }
+
+    mutable std::mutex mutex_;
+    std::map<std::string, std::unique_ptr<metric>> metrics_;
+};
+
+} // namespace learning
+
+#endif // METRICS_HPP
@@ -0,0 +1,398 @@
+/**
+ * @file mpmc_queue.hpp
+ * @author Richard Wang
+ * @brief 有界无锁多生产者/多消费者队列(Dmitry Vyukov 序号环形队列)
+ *  1. 原理
+ *      容量为2的幂的环形数组，每个槽位带一个序号 seq：
+ *          seq == pos      槽位空闲，位置为 pos 的生产者可以写入；
+ *          seq == pos + 1  槽位已写入，位置为 pos 的消费者可以读取；
+ *      读取完成后把 seq 置为 pos + capacity，留给下一圈的生产者。
+ *      生产者/消费者只需对各自的位置计数器做一次 CAS，不同槽位之间互不干扰。
+ *  2. 伪共享
+ *      入队位置、出队位置以及两个等待对象各自独占一个缓存行(alignas(64))，避免生产者和消费者互相使缓存行失效。
+ *  3. 批量操作
+ *      try_push_bulk / try_pop_bulk 用一次 CAS 申请连续多个槽位，减少位置计数器上的竞争。
+ *  4. 阻塞等待策略(模板参数 Wait)
+ *      spin_wait  : 忙等(pause 指令)，延迟最低，占满CPU；
+ *      yield_wait : 失败后 std::this_thread::yield()，让出时间片；
+ *      futex_wait : 失败后在 futex 上睡眠，对端操作成功后唤醒；只有存在睡眠线程时才发起系统调用。
+ *  5. 关闭
+ *      close() 之后 push 失败，pop 在队列取空后返回 false，阻塞中的线程全部被唤醒，便于流水线优雅退出。
+ * @version : 1.0
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c), Richard Wang.
+ *
+ */
+#ifndef MPMC_QUEUE_HPP
+#define MPMC_QUEUE_HPP
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <stdexcept>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#if defined(__linux__)
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#endif
+
+namespace learning
+{
+
+static const std::size_t kCacheLineSize = 64;
+
+inline void cpu_relax()
+{
+#if defined(__x86_64__) || defined(__i386__)
+    _mm_pause();
+#elif defined(__aarch64__)
+    asm volatile("yield" ::: "memory");
+#endif
+}
+
+/************************ 等待策略 ************************/
+/*
+ * 每个策略对象提供：
+ *   uint32_t prepare_wait()      操作失败前读取当前“代数”
+ *   void wait(uint32_t token)    代数仍为 token 时等待(允许虚假唤醒)
+ *   void notify_one() / notify_all()
+ */
+
+struct spin_wait
+{
+    uint32_t prepare_wait() const { return 0; }
+    void wait(uint32_t) const
+    {
+        for (int i = 0; i < 16; ++i)
+        {
+            cpu_relax();
+        }
+    }
+    void notify_one() {}
+    void notify_all() {}
+};
+
+struct yield_wait
+{
+    uint32_t prepare_wait() const { return 0; }
+    void wait(uint32_t) const { std::this_thread::yield(); }
+    void notify_one() {}
+    void notify_all() {}
+};
+
+class futex_wait
+{
+public:
+    futex_wait() : word_(0), waiters_(0) {}
+
+    uint32_t prepare_wait() const { return word_.load(); }
+
+    void wait(uint32_t token)
+    {
+        /* 先短暂自旋，对端通常很快就会完成操作 */
+        for (int i = 0; i < 64; ++i)
+        {
+            if (word_.load(std::memory_order_relaxed) != token)
+            {
+                return;
+            }
+            cpu_relax();
+        }
+        waiters_.fetch_add(1);
+#if defined(__linux__)
+        ::syscall(SYS_futex, reinterpret_cast<uint32_t *>(&word_), FUTEX_WAIT_PRIVATE, token, nullptr, nullptr, 0);
+#else
+        while (word_.load() == token)
+        {
+            std::this_thread::yield();
+        }
+#endif
+        waiters_.fetch_sub(1);
+    }
+
+    void notify_one() { notify(1); }
+    void notify_all() { notify(INT32_MAX); }
+
+private:
+    void notify(int count)
+    {
+        word_.fetch_add(1);
+        if (waiters_.load() > 0)
+        {
+#if defined(__linux__)
+            ::syscall(SYS_futex, reinterpret_cast<uint32_t *>(&word_), FUTEX_WAKE_PRIVATE, count, nullptr, nullptr, 0);
+#else
+            (void)count;
+#endif
+        }
+    }
+
+    static_assert(sizeof(std::atomic<uint32_t>) == sizeof(uint32_t), "futex requires a plain 32-bit word");
+    std::atomic<uint32_t> word_;
+    std::atomic<uint32_t> waiters_;
+};
+
+/**
+ * @brief 有界 MPMC 队列；T 需要可默认构造且可移动赋值
+ */
+template <class T, class Wait = yield_wait>
+class mpmc_queue
+{
+public:
+    /**
+     * @brief capacity 必须是2的幂且不小于2
+     */
+    explicit mpmc_queue(std::size_t capacity)
+        : cells_(nullptr), mask_(capacity - 1), enqueue_pos_(0), dequeue_pos_(0), closed_(false)
+    {
+        if (capacity < 2 || (capacity & (capacity - 1)) != 0)
+        {
+            throw std::invalid_argument("mpmc_queue: capacity must be a power of two");
+        }
+        cells_ = static_cast<cell *>(::operator new(sizeof(cell) * capacity));
+        for (std::size_t i = 0; i < capacity; ++i)
+        {
+            new (&cells_[i].seq) std::atomic<std::size_t>(i);
+        }
+    }
+
+    ~mpmc_queue()
+    {
+        T tmp;
+        while (try_pop(tmp))
+        {
+        }
+        ::operator delete(cells_);
+    }
+
+    mpmc_queue(const mpmc_queue &) = delete;
+    mpmc_queue &operator=(const mpmc_queue &) = delete;
+
+    std::size_t capacity() const { return mask_ + 1; }
+
+    /* 近似元素个数(并发修改时仅供参考) */
+    std::size_t size_approx() const
+    {
+        const std::size_t head = dequeue_pos_.value.load(std::memory_order_relaxed);
+        const std::size_t tail = enqueue_pos_.value.load(std::memory_order_relaxed);
+        return tail > head ? tail - head : 0;
+    }
+
+    /************************ 非阻塞接口 ************************/
+
+    /**
+     * @brief 队列满时立即返回 false，此时 value 不会被移动
+     */
+    template <class U>
+    bool try_push(U &&value)
+    {
+        std::size_t pos;
+        cell *c = claim_enqueue(1, pos);
+        if (c == nullptr)
+        {
+            return false;
+        }
+        new (c->storage()) T(std::forward<U>(value));
+        c->seq.store(pos + 1, std::memory_order_release);
+        not_empty_.value.notify_one();
+        return true;
+    }
+
+    bool try_pop(T &out)
+    {
+        std::size_t pos;
+        cell *c = claim_dequeue(1, pos);
+        if (c == nullptr)
+        {
+            return false;
+        }
+        take(*c, pos, out);
+        not_full_.value.notify_one();
+        return true;
+    }
+
+    /**
+     * @brief 从 first 开始最多入队 n 个元素(移动)，返回实际入队个数
+     */
+    template <class It>
+    std::size_t try_push_bulk(It first, std::size_t n)
+    {
+        std::size_t pos;
+        n = claim_range(enqueue_pos_.value, n, 0, pos);
+        for (std::size_t i = 0; i < n; ++i, ++first)
+        {
+            cell &c = cells_[(pos + i) & mask_];
+            new (c.storage()) T(std::move(*first));
+            c.seq.store(pos + i + 1, std::memory_order_release);
+        }
+        if (n > 0)
+        {
+            not_empty_.value.notify_all();
+        }
+        return n;
+    }
+
+    /**
+     * @brief 最多出队 n 个元素写入 out(赋值)，返回实际出队个数
+     */
+    template <class OutIt>
+    std::size_t try_pop_bulk(OutIt out, std::size_t n)
+    {
+        std::size_t pos;
+        n = claim_range(dequeue_pos_.value, n, 1, pos);
+        for (std::size_t i = 0; i < n; ++i, ++out)
+        {
+            cell &c = cells_[(pos + i) & mask_];
+            T tmp;
+            take(c, pos + i, tmp);
+            *out = std::move(tmp);
+        }
+        if (n > 0)
+        {
+            not_full_.value.notify_all();
+        }
+        return n;
+    }
+
+    /************************ 阻塞接口 ************************/
+
+    /**
+     * @brief 队列满时按等待策略等待；队列已关闭时返回 false
+     */
+    template <class U>
+    bool push(U &&value)
+    {
+        for (;;)
+        {
+            const uint32_t token = not_full_.value.prepare_wait();
+            if (closed_.load(std::memory_order_acquire))
+            {
+                return false;
+            }
+            if (try_push(std::forward<U>(value)))
+            {
+                return true;
+            }
+            not_full_.value.wait(token);
+        }
+    }
+
+    /**
+     * @brief 队列空时按等待策略等待；队列已关闭且取空后返回 false
+     */
+    bool pop(T &out)
+    {
+        for (;;)
+        {
+            const uint32_t token = not_empty_.value.prepare_wait();
+            if (try_pop(out))
+            {
+                return true;
+            }
+            if (closed_.load(std::memory_order_acquire))
+            {
+                return try_pop(out);
+            }
+            not_empty_.value.wait(token);
+        }
+    }
+
+    void close()
+    {
+        closed_.store(true, std::memory_order_release);
+        not_empty_.value.notify_all();
+        not_full_.value.notify_all();
+    }
+
+    bool is_closed() const { return closed_.load(std::memory_order_acquire); }
+
+private:
+    struct cell
+    {
+        std::atomic<std::size_t> seq;
+        typename std::aligned_storage<sizeof(T), alignof(T)>::type data;
+
+        T *storage() { return reinterpret_cast<T *>(&data); }
+    };
+
+    /* 单独占用一个缓存行的成员 */
+    template <class V>
+    struct alignas(kCacheLineSize) padded
+    {
+        V value;
+        padded() : value() {}
+        template <class A>
+        explicit padded(A a) : value(a) {}
+    };
+
+    cell *claim_enqueue(std::size_t n, std::size_t &pos) { return claim_range(enqueue_pos_.value, n, 0, pos) ? &cells_[pos & mask_] : nullptr; }
+    cell *claim_dequeue(std::size_t n, std::size_t &pos) { return claim_range(dequeue_pos_.value, n, 1, pos) ? &cells_[pos & mask_] : nullptr; }
+
+    /**
+     * @brief 在 counter 上申请最多 n 个连续位置，返回申请到的个数，起始位置写入 pos
+     *  offset 为0时检查槽位是否空闲(生产者)，为1时检查槽位是否有数据(消费者)。
+     *  先逐个确认从 pos 开始有多少个槽位已就绪，再用一次 CAS 把它们全部占下；
+     *  已就绪的槽位只有占到该位置的线程才能改变其状态，因此 CAS 成功后无需再次检查。
+     */
+    std::size_t claim_range(std::atomic<std::size_t> &counter, std::size_t n, std::size_t offset, std::size_t &pos)
+    {
+        pos = counter.load(std::memory_order_relaxed);
+        for (;;)
+        {
+            std::size_t avail = 0;
+            while (avail < n)
+            {
+                cell &c = cells_[(pos + avail) & mask_];
+                const std::size_t seq = c.seq.load(std::memory_order_acquire);
+                if (seq != pos + avail + offset)
+                {
+                    break;
+                }
+                ++avail;
+            }
+            if (avail == 0)
+            {
+                const std::size_t seq = cells_[pos & mask_].seq.load(std::memory_order_acquire);
+                const std::ptrdiff_t diff = static_cast<std::ptrdiff_t>(seq) - static_cast<std::ptrdiff_t>(pos + offset);
+                if (diff < 0)
+                {
+                    return 0; // 队列满(生产者) 或 队列空(消费者)
+                }
+                pos = counter.load(std::memory_order_relaxed); // 被其他线程抢先，重新读取位置
+                continue;
+            }
+            if (counter.compare_exchange_weak(pos, pos + avail, std::memory_order_relaxed))
+            {
+                return avail;
+            }
+        }
+    }
+
+    void take(cell &c, std::size_t pos, T &out)
+    {
+        T *p = c.storage();
+        out = std::move(*p);
+        p->~T();
+        c.seq.store(pos + mask_ + 1, std::memory_order_release);
+    }
+
+    cell *cells_;
+    const std::size_t mask_;
+    padded<std::atomic<std::size_t>> enqueue_pos_;
+    padded<std::atomic<std::size_t>> dequeue_pos_;
+    padded<Wait> not_empty_;
+    padded<Wait> not_full_;
+    std::atomic<bool> closed_;
+};
+
+} // namespace learning
+
+#endif // MPMC_QUEUE_HPP
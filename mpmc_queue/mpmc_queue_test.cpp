@@ -0,0 +1,127 @@
+/**
+ * @file mpmc_queue_test.cpp
+ * @author Richard Wang
+ * @brief 多生产者/多消费者队列示例
+ *  1. 多个生产者线程产生 std::pair<int, std::string> 记录，多个消费者线程取出并统计；
+ *  2. 分别使用 spin_wait / yield_wait / futex_wait 三种等待策略，比较吞吐量；
+ *  3. 批量入队/出队接口。
+ *
+ * 编译: g++ -std=c++14 -O2 -pthread mpmc_queue_test.cpp -o mpmc_queue_test
+ * @version : 1.0
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c), Richard Wang.
+ *
+ */
+
+#include <iostream>
+#include <atomic>
+#include <chrono>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "mpmc_queue.hpp"
+
+typedef std::pair<int, std::string> record_t;
+
+/**
+ * @brief producers 个线程各写入 per_producer 条记录，consumers 个线程读取直到队列关闭
+ */
+template <class Wait>
+void throughput_test(const char *name, int producers, int consumers, int per_producer)
+{
+    learning::mpmc_queue<record_t, Wait> queue(1024);
+    std::atomic<long long> sum(0);
+    std::atomic<int> received(0);
+
+    std::chrono::steady_clock::time_point begin = std::chrono::steady_clock::now();
+    std::vector<std::thread> consumer_threads;
+    for (int c = 0; c < consumers; ++c)
+    {
+        consumer_threads.emplace_back([&queue, &sum, &received]()
+                                      {
+                                          record_t record;
+                                          long long local_sum = 0;
+                                          int local_count = 0;
+                                          while (queue.pop(record))
+                                          {
+                                              local_sum += record.first;
+                                              ++local_count;
+                                          }
+                                          sum += local_sum;
+                                          received += local_count;
+                                      });
+    }
+
+    std::vector<std::thread> producer_threads;
+    for (int p = 0; p < producers; ++p)
+    {
+        producer_threads.emplace_back([&queue, p, per_producer]()
+                                      {
+                                          for (int i = 0; i < per_producer; ++i)
+                                          {
+                                              queue.push(record_t(i, p % 2 ? "Jack" : "Rose"));
+                                          }
+                                      });
+    }
+    for (std::thread &t : producer_threads)
+    {
+        t.join();
+    }
+    queue.close();
+    for (std::thread &t : consumer_threads)
+    {
+        t.join();
+    }
+    std::chrono::steady_clock::time_point end = std::chrono::steady_clock::now();
+
+    const long long expect = static_cast<long long>(producers) * per_producer * (per_producer - 1) / 2;
+    const double seconds = std::chrono::duration<double>(end - begin).count();
+    std::cout << name << ": " << received << " records, " << static_cast<long long>(received / seconds) << " records/s"
+              << ", checksum ok: " << (sum == expect) << std::endl;
+}
+
+/**
+ * @brief 批量接口
+ */
+void bulk_test()
+{
+    std::cout << "------------- test bulk ------------------" << std::endl;
+    learning::mpmc_queue<record_t> queue(8);
+    std::vector<record_t> info_list = {{12, "Mark"}, {17, "Jack"}, {11, "Jim"}, {14, "Rose"}, {30, "Lucy"}};
+
+    std::size_t pushed = queue.try_push_bulk(info_list.begin(), info_list.size());
+    std::cout << "pushed: " << pushed << ", size: " << queue.size_approx() << std::endl;
+
+    std::vector<record_t> out(8);
+    std::size_t popped = queue.try_pop_bulk(out.begin(), out.size());
+    for (std::size_t i = 0; i < popped; ++i)
+    {
+        std::cout << "Name: " << out[i].second << ", Age:" << out[i].first << std::endl;
+    }
+}
+
+int main()
+{
+    /******************* bulk_test() ****************/
+    bulk_test();
+    /************************************************/
+
+    /**************** throughput_test() *************/
+    std::cout << "------------- test throughput ------------------" << std::endl;
+    /* 忙等只适合每个线程独占一个核心的场景，核心数不足时生产者与消费者会互相抢占时间片 */
+    if (std::thread::hardware_concurrency() >= 4)
+    {
+        throughput_test<learning::spin_wait>("spin_wait ", 2, 2, 500000);
+    }
+    else
+    {
+        std::cout << "spin_wait : skipped, needs at least 4 cores" << std::endl;
+    }
+    throughput_test<learning::yield_wait>("yield_wait", 2, 2, 500000);
+    throughput_test<learning::futex_wait>("futex_wait", 2, 2, 500000);
+    /************************************************/
+
+    return 0;
+}
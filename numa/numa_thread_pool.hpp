@@ -0,0 +1,217 @@
+/**
+ * @file numa_thread_pool.hpp
+ * @author Richard Wang
+ * @brief 按 NUMA 节点分组、工作线程绑核的线程池
+ *  1. 每个节点一个任务队列，节点上每个可用 CPU(或每个物理核)一个工作线程，线程启动时绑定到该 CPU；
+ *  2. execute_on(node, task) 把任务投递到指定节点，处理该节点内存中的数据时不会产生跨节点访问；
+ *     execute(task) 在工作线程中调用时投递到当前节点，否则按轮询分配；
+ *  3. 工作线程只处理本节点的队列(不跨节点窃取)，保证数据局部性；
+ *  4. 绑核失败(例如容器不允许)时线程照常运行，bound_workers() 报告实际绑核成功的线程数。
+ * @version : 1.0
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c), Richard Wang.
+ *
+ */
+#ifndef NUMA_THREAD_POOL_HPP
+#define NUMA_THREAD_POOL_HPP
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "../future/small_function.hpp"
+#include "topology.hpp"
+
+namespace learning
+{
+
+class numa_thread_pool
+{
+public:
+    /**
+     * @brief one_per_core 为 true 时每个物理核只启动一个线程(不使用超线程)
+     */
+    explicit numa_thread_pool(const cpu_topology &topo, bool one_per_core = false)
+        : next_node_(0), bound_(0)
+    {
+        for (const numa_node &node : topo.nodes())
+        {
+            std::vector<int> cpus = topo.usable_cpus(node.id, one_per_core);
+            if (cpus.empty())
+            {
+                continue;
+            }
+            std::unique_ptr<node_queue> q(new node_queue());
+            q->node = node.id;
+            q->cpus = cpus;
+            q->owner = this;
+            queues_.push_back(std::move(q));
+        }
+        if (queues_.empty())
+        {
+            throw std::runtime_error("numa_thread_pool: no usable cpu");
+        }
+        for (std::size_t i = 0; i < queues_.size(); ++i)
+        {
+            for (int cpu : queues_[i]->cpus)
+            {
+                workers_.emplace_back([this, i, cpu]()
+                                      { run(i, cpu); });
+            }
+        }
+    }
+
+    ~numa_thread_pool()
+    {
+        for (std::unique_ptr<node_queue> &q : queues_)
+        {
+            std::lock_guard<std::mutex> lock(q->mutex);
+            q->stopping = true;
+            q->cv.notify_all();
+        }
+        for (std::thread &t : workers_)
+        {
+            t.join();
+        }
+    }
+
+    numa_thread_pool(const numa_thread_pool &) = delete;
+    numa_thread_pool &operator=(const numa_thread_pool &) = delete;
+
+    /* 拥有工作线程的节点编号 */
+    std::vector<int> nodes() const
+    {
+        std::vector<int> result;
+        for (const std::unique_ptr<node_queue> &q : queues_)
+        {
+            result.push_back(q->node);
+        }
+        return result;
+    }
+
+    std::size_t size() const { return workers_.size(); }
+    std::size_t bound_workers() const { return bound_.load(); }
+
+    /**
+     * @brief 投递到节点 node 的队列；该节点没有工作线程时抛出 std::out_of_range
+     */
+    void execute_on(int node, small_function<void()> task)
+    {
+        push(queue_of(node), std::move(task));
+    }
+
+    void execute(small_function<void()> task)
+    {
+        node_queue *q = current_queue();
+        if (q == nullptr)
+        {
+            q = queues_[next_node_.fetch_add(1, std::memory_order_relaxed) % queues_.size()].get();
+        }
+        push(*q, std::move(task));
+    }
+
+    /* 当前工作线程所在的节点；不是本线程池的线程时返回 -1 */
+    int current_node() const
+    {
+        node_queue *q = current_queue();
+        return q == nullptr ? -1 : q->node;
+    }
+
+private:
+    struct node_queue
+    {
+        int node = 0;
+        std::vector<int> cpus;
+        std::mutex mutex;
+        std::condition_variable cv;
+        std::deque<small_function<void()>> tasks;
+        bool stopping = false;
+        const numa_thread_pool *owner = nullptr;
+    };
+
+    static node_queue *&current_slot()
+    {
+        static thread_local node_queue *slot = nullptr;
+        return slot;
+    }
+
+    node_queue *current_queue() const
+    {
+        node_queue *q = current_slot();
+        return q != nullptr && q->owner == this ? q : nullptr;
+    }
+
+    node_queue &queue_of(int node)
+    {
+        for (std::unique_ptr<node_queue> &q : queues_)
+        {
+            if (q->node == node)
+            {
+                return *q;
+            }
+        }
+        throw std::out_of_range("numa_thread_pool: no workers on node " + std::to_string(node));
+    }
+
+    static void push(node_queue &q, small_function<void()> task)
+    {
+        {
+            std::lock_guard<std::mutex> lock(q.mutex);
+            q.tasks.push_back(std::move(task));
+        }
+        q.cv.notify_one();
+    }
+
+    void run(std::size_t index, int cpu)
+    {
+        node_queue &q = *queues_[index];
+        current_slot() = &q;
+#if defined(__linux__)
+        try
+        {
+            pin_current_thread(cpu);
+            ++bound_;
+        }
+        catch (const std::exception &)
+        {
+            /* 没有权限、CPU 不在 cpuset 中或 CPU 编号超出 CPU_SETSIZE，不绑核继续运行 */
+        }
+#else
+        (void)cpu;
+#endif
+        for (;;)
+        {
+            small_function<void()> task;
+            {
+                std::unique_lock<std::mutex> lock(q.mutex);
+                q.cv.wait(lock, [&q]()
+                          { return q.stopping || !q.tasks.empty(); });
+                if (q.tasks.empty())
+                {
+                    return;
+                }
+                task = std::move(q.tasks.front());
+                q.tasks.pop_front();
+            }
+            task();
+        }
+    }
+
+    std::vector<std::unique_ptr<node_queue>> queues_;
+    std::vector<std::thread> workers_;
+    std::atomic<std::size_t> next_node_;
+    std::atomic<std::size_t> bound_;
+};
+
+} // namespace learning
+
+#endif // NUMA_THREAD_POOL_HPP
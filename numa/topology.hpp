@@ -0,0 +1,387 @@
+/**
+ * @file topology.hpp
+ * @author Richard Wang
+ * @brief CPU / NUMA 拓扑发现、线程绑核与节点本地内存分配(Linux)
+ *  1. 拓扑发现
+ *      读取 /sys/devices/system/cpu/online、cpuN/topology/{core_id,physical_package_id}
+ *      以及 /sys/devices/system/node/online、nodeN/cpulist；没有 node 目录的机器视为只有节点 0。
+ *      根目录可以指定，便于用伪造的目录结构演示多路服务器的布局。
+ *  2. 绑核
+ *      pin_current_thread(cpu) / pin_thread(t, cpu) 调用 pthread_setaffinity_np，失败时抛出 std::system_error。
+ *      容器或 taskset 可能限制可用的 CPU，discover() 会读取当前进程的亲和性掩码并标记哪些 CPU 可用。
+ *  3. 节点本地内存
+ *      allocate_on_node 用 mmap 分配匿名内存，再用 mbind(MPOL_PREFERRED) 让页面优先落在指定节点；
+ *      内核不支持或没有权限时退化为“首次访问”策略：由绑定在该节点上的线程首先写入这段内存即可。
+ *      node_allocator<T> 把它包装成标准分配器，可直接用于 std::vector。
+ * @version : 1.0
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c), Richard Wang.
+ *
+ */
+#ifndef TOPOLOGY_HPP
+#define TOPOLOGY_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <fstream>
+#include <map>
+#include <new>
+#include <ostream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <thread>
+#include <vector>
+#if defined(__linux__)
+#include <linux/mempolicy.h>
+#include <pthread.h>
+#include <sched.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace learning
+{
+
+/**
+ * @brief 解析 "0-3,8,10-11" 格式的 CPU / 节点列表
+ */
+inline std::vector<int> parse_cpu_list(const std::string &text)
+{
+    std::vector<int> result;
+    std::istringstream in(text);
+    std::string item;
+    while (std::getline(in, item, ','))
+    {
+        item.erase(std::remove_if(item.begin(), item.end(), [](char c)
+                                  { return c == ' ' || c == '\n' || c == '\t'; }),
+                   item.end());
+        if (item.empty())
+        {
+            continue;
+        }
+        const std::string::size_type dash = item.find('-');
+        try
+        {
+            const int first = std::stoi(item.substr(0, dash));
+            const int last = dash == std::string::npos ? first : std::stoi(item.substr(dash + 1));
+            if (last < first)
+            {
+                throw std::invalid_argument(item);
+            }
+            for (int cpu = first; cpu <= last; ++cpu)
+            {
+                result.push_back(cpu);
+            }
+        }
+        catch (const std::logic_error &)
+        {
+            throw std::invalid_argument("parse_cpu_list: bad range '" + item + "'");
+        }
+    }
+    return result;
+}
+
+struct cpu_info
+{
+    int id = 0;
+    int core_id = 0;    // 同一物理核上的超线程 core_id 相同
+    int package_id = 0; // 所在插槽(socket)
+    int node = 0;       // 所在 NUMA 节点
+    bool allowed = true; // 是否在当前进程的亲和性掩码中
+};
+
+struct numa_node
+{
+    int id = 0;
+    std::vector<int> cpus;
+};
+
+/**
+ * @brief 机器的 CPU 与 NUMA 节点布局
+ */
+class cpu_topology
+{
+public:
+    /**
+     * @brief 读取 sysfs_root 下的 cpu/ 与 node/ 目录；使用其他根目录时所有 CPU 都视为可用
+     */
+    static cpu_topology discover(const std::string &sysfs_root = "/sys/devices/system")
+    {
+        cpu_topology topo;
+        std::string online;
+        if (!read_line(sysfs_root + "/cpu/online", online))
+        {
+            /* 非 Linux 或 sysfs 不可用：按硬件线程数构造单节点拓扑 */
+            const unsigned n = std::max(1u, std::thread::hardware_concurrency());
+            online = "0-" + std::to_string(n - 1);
+        }
+        std::map<int, int> cpu_node;
+        std::string node_list;
+        if (read_line(sysfs_root + "/node/online", node_list))
+        {
+            for (int node : parse_cpu_list(node_list))
+            {
+                std::string cpus;
+                if (read_line(sysfs_root + "/node/node" + std::to_string(node) + "/cpulist", cpus))
+                {
+                    for (int cpu : parse_cpu_list(cpus))
+                    {
+                        cpu_node[cpu] = node;
+                    }
+                }
+            }
+        }
+
+        /* 亲和性掩码只对本机的 sysfs 有意义 */
+        const std::vector<int> allowed = sysfs_root == "/sys/devices/system" ? allowed_cpus() : std::vector<int>();
+        for (int id : parse_cpu_list(online))
+        {
+            cpu_info info;
+            info.id = id;
+            const std::string dir = sysfs_root + "/cpu/cpu" + std::to_string(id) + "/topology/";
+            info.core_id = read_int(dir + "core_id", id);
+            info.package_id = read_int(dir + "physical_package_id", 0);
+            std::map<int, int>::const_iterator it = cpu_node.find(id);
+            info.node = it == cpu_node.end() ? 0 : it->second;
+            info.allowed = allowed.empty() || std::find(allowed.begin(), allowed.end(), id) != allowed.end();
+            topo.cpus_.push_back(info);
+        }
+
+        std::map<int, numa_node> nodes;
+        for (const cpu_info &info : topo.cpus_)
+        {
+            numa_node &node = nodes[info.node];
+            node.id = info.node;
+            node.cpus.push_back(info.id);
+        }
+        for (std::map<int, numa_node>::value_type &kv : nodes)
+        {
+            topo.nodes_.push_back(std::move(kv.second));
+        }
+        return topo;
+    }
+
+    const std::vector<cpu_info> &cpus() const { return cpus_; }
+    const std::vector<numa_node> &nodes() const { return nodes_; }
+
+    /* 未知 CPU 抛出 std::out_of_range */
+    const cpu_info &cpu(int id) const
+    {
+        for (const cpu_info &info : cpus_)
+        {
+            if (info.id == id)
+            {
+                return info;
+            }
+        }
+        throw std::out_of_range("cpu_topology: unknown cpu " + std::to_string(id));
+    }
+
+    int node_of_cpu(int id) const { return cpu(id).node; }
+
+    /* 物理核数(同一插槽内 core_id 相同的超线程只算一个) */
+    std::size_t physical_cores() const
+    {
+        std::vector<std::pair<int, int>> cores;
+        for (const cpu_info &info : cpus_)
+        {
+            cores.emplace_back(info.package_id, info.core_id);
+        }
+        std::sort(cores.begin(), cores.end());
+        return std::unique(cores.begin(), cores.end()) - cores.begin();
+    }
+
+    /**
+     * @brief 节点上当前进程可用的 CPU；每个物理核只取第一个超线程时 one_per_core 为 true
+     */
+    std::vector<int> usable_cpus(int node, bool one_per_core = false) const
+    {
+        std::vector<int> result;
+        std::vector<std::pair<int, int>> seen;
+        for (const cpu_info &info : cpus_)
+        {
+            if (info.node != node || !info.allowed)
+            {
+                continue;
+            }
+            const std::pair<int, int> core(info.package_id, info.core_id);
+            if (one_per_core && std::find(seen.begin(), seen.end(), core) != seen.end())
+            {
+                continue;
+            }
+            seen.push_back(core);
+            result.push_back(info.id);
+        }
+        return result;
+    }
+
+    void describe(std::ostream &os) const
+    {
+        os << cpus_.size() << " cpus, " << physical_cores() << " physical cores, " << nodes_.size() << " numa nodes" << std::endl;
+        for (const numa_node &node : nodes_)
+        {
+            os << "  node " << node.id << ":";
+            for (int id : node.cpus)
+            {
+                const cpu_info &info = cpu(id);
+                os << " " << id << "(pkg " << info.package_id << " core " << info.core_id << (info.allowed ? "" : " disallowed") << ")";
+            }
+            os << std::endl;
+        }
+    }
+
+private:
+    static bool read_line(const std::string &path, std::string &line)
+    {
+        std::ifstream in(path.c_str());
+        return static_cast<bool>(std::getline(in, line));
+    }
+
+    static int read_int(const std::string &path, int fallback)
+    {
+        std::ifstream in(path.c_str());
+        int value;
+        return (in >> value) ? value : fallback;
+    }
+
+    static std::vector<int> allowed_cpus()
+    {
+        std::vector<int> result;
+#if defined(__linux__)
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        if (sched_getaffinity(0, sizeof(set), &set) == 0)
+        {
+            for (int cpu = 0; cpu < CPU_SETSIZE; ++cpu)
+            {
+                if (CPU_ISSET(cpu, &set))
+                {
+                    result.push_back(cpu);
+                }
+            }
+        }
+#endif
+        return result;
+    }
+
+    std::vector<cpu_info> cpus_;
+    std::vector<numa_node> nodes_;
+};
+
+/************************ 绑核 ************************/
+
+#if defined(__linux__)
+/**
+ * @brief 把线程绑定到单个 CPU
+ */
+inline void pin_thread(std::thread::native_handle_type handle, int cpu)
+{
+    if (cpu < 0 || cpu >= CPU_SETSIZE)
+    {
+        throw std::out_of_range("pin_thread: bad cpu " + std::to_string(cpu));
+    }
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(cpu, &set);
+    const int err = pthread_setaffinity_np(handle, sizeof(set), &set);
+    if (err != 0)
+    {
+        throw std::system_error(err, std::generic_category(), "pthread_setaffinity_np");
+    }
+}
+
+inline void pin_thread(std::thread &t, int cpu)
+{
+    pin_thread(t.native_handle(), cpu);
+}
+
+inline void pin_current_thread(int cpu)
+{
+    pin_thread(pthread_self(), cpu);
+}
+
+/* 当前线程正在运行的 CPU */
+inline int current_cpu()
+{
+    return sched_getcpu();
+}
+#endif
+
+/************************ 节点本地内存 ************************/
+
+/**
+ * @brief 分配 bytes 字节、页面优先位于 node 的内存；失败时抛出 std::bad_alloc
+ */
+inline void *allocate_on_node(std::size_t bytes, int node)
+{
+#if defined(__linux__)
+    void *p = ::mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (p == MAP_FAILED)
+    {
+        throw std::bad_alloc();
+    }
+    if (node >= 0 && node < static_cast<int>(sizeof(unsigned long) * 8))
+    {
+        const unsigned long mask = 1UL << node;
+        /* 失败(ENOSYS/EPERM/EINVAL)时保持默认策略，由首次访问决定页面位置 */
+        ::syscall(SYS_mbind, p, bytes, MPOL_PREFERRED, &mask, sizeof(mask) * 8, 0);
+    }
+    return p;
+#else
+    (void)node;
+    return ::operator new(bytes);
+#endif
+}
+
+inline void deallocate_on_node(void *p, std::size_t bytes) noexcept
+{
+#if defined(__linux__)
+    ::munmap(p, bytes);
+#else
+    (void)bytes;
+    ::operator delete(p);
+#endif
+}
+
+/**
+ * @brief 在指定节点上分配的标准分配器；每次分配都是独立的 mmap，适合大块、长寿命的数组
+ */
+template <class T>
+class node_allocator
+{
+public:
+    typedef T value_type;
+
+    explicit node_allocator(int node = 0) noexcept : node_(node) {}
+    template <class U>
+    node_allocator(const node_allocator<U> &other) noexcept : node_(other.node()) {}
+
+    T *allocate(std::size_t n)
+    {
+        if (n > static_cast<std::size_t>(-1) / sizeof(T))
+        {
+            throw std::bad_alloc();
+        }
+        return static_cast<T *>(allocate_on_node(n * sizeof(T), node_));
+    }
+
+    void deallocate(T *p, std::size_t n) noexcept { deallocate_on_node(p, n * sizeof(T)); }
+
+    int node() const noexcept { return node_; }
+
+    template <class U>
+    friend bool operator==(const node_allocator &a, const node_allocator<U> &b) { return a.node() == b.node(); }
+    template <class U>
+    friend bool operator!=(const node_allocator &a, const node_allocator<U> &b) { return a.node() != b.node(); }
+
+private:
+    int node_;
+};
+
+} // namespace learning
+
+#endif // TOPOLOGY_HPP
@@ -0,0 +1,357 @@
+/**
+ * @file object_pool.hpp
+ * @author Richard Wang
+ * @brief 按大小分级的对象池：线程本地空闲链表 + 全局批量仓库，可作为 std::list 等节点容器的分配器
+ *  1. 结构
+ *      每个 (块大小, 对齐) 组合对应一个 size_class_pool 单例，内部是一个由互斥锁保护的 "仓库"，存放整批的空闲块；
+ *      每个线程对每个大小级别有一个 thread_local 缓存(单链表)，分配和释放只操作本线程链表，不加锁、不用原子操作。
+ *  2. 批量补充与归还
+ *      本线程链表为空时从仓库取一整批(仓库也空时向系统申请一个新的内存块，切成一批)；
+ *      本线程链表超过两批时把一批归还仓库；线程退出时全部归还。每次加锁搬运一批，锁的开销被均摊。
+ *  3. 跨线程释放
+ *      A 线程分配、B 线程释放的块进入 B 的本地链表，超出上限后经仓库回到 A 可以取到的地方，
+ *      因此生产者 / 消费者模式下稳态不再向系统申请内存。
+ *  4. 内存块从不归还系统(进程退出时随进程释放)，池本身也不析构，静态对象析构时仍可安全释放块。
+ *  5. pool_allocator<T>：无状态的标准分配器，单个对象走对象池，数组(n > 1)走 ::operator new
+ *     (超过默认对齐的 T 使用 C++17 的 std::align_val_t 版本，C++14 下不支持这样的 T)；
+ *     object_pool<T>::make(args...) / destroy(p) 与 pool_ptr<T> 直接构造单个对象。
+ *
+ *  typedef std::tuple<int, std::string, int> user_t;
+ *  std::list<user_t, learning::pool_allocator<user_t>> userList;   // 链表节点来自对象池
+ *  learning::pool_ptr<user_t> u = learning::object_pool<user_t>::make_unique(26, "Richard", 178);
+ * @version : 1.0
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c), Richard Wang.
+ *
+ */
+#ifndef OBJECT_POOL_HPP
+#define OBJECT_POOL_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <ostream>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace learning
+{
+
+/**
+ * @brief 单个大小级别的统计
+ */
+struct pool_stats
+{
+    std::size_t block_size = 0;
+    std::size_t blocks_per_batch = 0;
+    std::size_t chunks = 0;          // 向系统申请的内存块数
+    std::size_t bytes_reserved = 0;  // 向系统申请的总字节数
+    std::size_t depot_batches = 0;   // 仓库中现有的批数
+    std::size_t refills = 0;         // 线程缓存从仓库取批的次数
+    std::size_t releases = 0;        // 线程缓存向仓库还批的次数
+};
+
+inline std::ostream &operator<<(std::ostream &os, const pool_stats &s)
+{
+    return os << "block " << s.block_size << " B x " << s.blocks_per_batch << "/batch, chunks " << s.chunks << " (" << s.bytes_reserved
+              << " B), depot batches " << s.depot_batches << ", refills " << s.refills << ", releases " << s.releases;
+}
+
+namespace detail
+{
+
+static const std::size_t kPoolBatchBytes = 16 * 1024;
+static const std::size_t kPoolMinBatch = 8;
+static const std::size_t kPoolMaxBatch = 256;
+
+struct free_block
+{
+    free_block *next;
+};
+
+/**
+ * @brief 一个大小级别的全局仓库；Size 已按 Align 向上取整且不小于一个指针
+ */
+template <std::size_t Size, std::size_t Align>
+class size_class_pool
+{
+public:
+    static const std::size_t kBatch = std::min(kPoolMaxBatch, std::max(kPoolMinBatch, kPoolBatchBytes / Size));
+
+    /* 池对象有意不析构：静态容器在程序结束时析构仍会释放块 */
+    static size_class_pool &instance()
+    {
+        static size_class_pool *pool = new size_class_pool();
+        return *pool;
+    }
+
+    void *allocate()
+    {
+        thread_cache &cache = local();
+        if (cache.head == nullptr)
+        {
+            refill(cache);
+        }
+        free_block *b = cache.head;
+        cache.head = b->next;
+        --cache.count;
+        return b;
+    }
+
+    void deallocate(void *p) noexcept
+    {
+        thread_cache &cache = local();
+        free_block *b = static_cast<free_block *>(p);
+        b->next = cache.head;
+        cache.head = b;
+        if (++cache.count >= 2 * kBatch)
+        {
+            release(cache, kBatch);
+        }
+    }
+
+    pool_stats stats()
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        pool_stats s;
+        s.block_size = Size;
+        s.blocks_per_batch = kBatch;
+        s.chunks = chunks_;
+        s.bytes_reserved = chunks_ * (kBatch * Size + Align);
+        s.depot_batches = depot_.size();
+        s.refills = refills_;
+        s.releases = releases_;
+        return s;
+    }
+
+private:
+    struct batch
+    {
+        free_block *head;
+        std::size_t count;
+    };
+
+    struct thread_cache
+    {
+        free_block *head = nullptr;
+        std::size_t count = 0;
+
+        ~thread_cache()
+        {
+            if (count != 0)
+            {
+                instance().release(*this, count);
+            }
+        }
+    };
+
+    size_class_pool() : chunks_(0), refills_(0), releases_(0) {}
+
+    static thread_cache &local()
+    {
+        static thread_local thread_cache cache;
+        return cache;
+    }
+
+    void refill(thread_cache &cache)
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            ++refills_;
+            if (!depot_.empty())
+            {
+                cache.head = depot_.back().head;
+                cache.count = depot_.back().count;
+                depot_.pop_back();
+                return;
+            }
+            ++chunks_;
+        }
+        /* 新内存块在锁外申请和切分；operator new 保证的对齐不够时手动对齐 */
+        char *raw = static_cast<char *>(::operator new(kBatch * Size + Align));
+        char *base = reinterpret_cast<char *>((reinterpret_cast<std::uintptr_t>(raw) + Align - 1) & ~(std::uintptr_t(Align) - 1));
+        free_block *head = nullptr;
+        for (std::size_t i = kBatch; i-- > 0;)
+        {
+            free_block *b = reinterpret_cast<free_block *>(base + i * Size);
+            b->next = head;
+            head = b;
+        }
+        cache.head = head;
+        cache.count = kBatch;
+    }
+
+    /* 从线程缓存头部摘下 n 块作为一批放入仓库 */
+    void release(thread_cache &cache, std::size_t n) noexcept
+    {
+        free_block *head = cache.head;
+        free_block *tail = head;
+        for (std::size_t i = 1; i < n; ++i)
+        {
+            tail = tail->next;
+        }
+        cache.head = tail->next;
+        cache.count -= n;
+        tail->next = nullptr;
+
+        std::lock_guard<std::mutex> lock(mutex_);
+        ++releases_;
+        try
+        {
+            depot_.push_back(batch{head, n});
+        }
+        catch (...)
+        {
+            /* 仓库记录扩容失败时这一批留在原线程，不丢失内存 */
+            tail->next = cache.head;
+            cache.head = head;
+            cache.count += n;
+        }
+    }
+
+    std::mutex mutex_;
+    std::vector<batch> depot_;
+    std::size_t chunks_;
+    std::size_t refills_;
+    std::size_t releases_;
+};
+
+template <std::size_t Size, std::size_t Align>
+const std::size_t size_class_pool<Size, Align>::kBatch;
+
+/* T 对应的大小级别：块大小按对齐向上取整，且能容纳一个链表指针 */
+template <class T>
+struct pool_for
+{
+    static const std::size_t align = alignof(T) > alignof(free_block) ? alignof(T) : alignof(free_block);
+    static const std::size_t size = (std::max(sizeof(T), sizeof(free_block)) + align - 1) / align * align;
+    typedef size_class_pool<size, align> type;
+};
+
+} // namespace detail
+
+/**
+ * @brief 无状态的标准分配器；单个对象来自对象池，所有实例相等，容器之间可以 splice / swap
+ */
+template <class T>
+class pool_allocator
+{
+public:
+    typedef T value_type;
+    typedef std::true_type is_always_equal;
+
+    pool_allocator() noexcept {}
+    template <class U>
+    pool_allocator(const pool_allocator<U> &) noexcept {}
+
+#if !defined(__cpp_aligned_new)
+    static_assert(alignof(T) <= alignof(std::max_align_t), "pool_allocator: over-aligned types need C++17 aligned new");
+#endif
+
+    T *allocate(std::size_t n)
+    {
+        if (n == 1)
+        {
+            return static_cast<T *>(detail::pool_for<T>::type::instance().allocate());
+        }
+        if (n > static_cast<std::size_t>(-1) / sizeof(T))
+        {
+            throw std::bad_alloc();
+        }
+#if defined(__cpp_aligned_new)
+        if (alignof(T) > __STDCPP_DEFAULT_NEW_ALIGNMENT__)
+        {
+            return static_cast<T *>(::operator new(n * sizeof(T), std::align_val_t(alignof(T))));
+        }
+#endif
+        return static_cast<T *>(::operator new(n * sizeof(T)));
+    }
+
+    void deallocate(T *p, std::size_t n) noexcept
+    {
+        if (n == 1)
+        {
+            detail::pool_for<T>::type::instance().deallocate(p);
+        }
+        else
+        {
+#if defined(__cpp_aligned_new)
+            if (alignof(T) > __STDCPP_DEFAULT_NEW_ALIGNMENT__)
+            {
+                ::operator delete(p, std::align_val_t(alignof(T)));
+                return;
+            }
+#endif
+            ::operator delete(p);
+        }
+    }
+
+    /* 当前大小级别的统计(与 T 大小、对齐相同的类型共用一个级别) */
+    static pool_stats stats() { return detail::pool_for<T>::type::instance().stats(); }
+
+    template <class U>
+    friend bool operator==(const pool_allocator &, const pool_allocator<U> &) { return true; }
+    template <class U>
+    friend bool operator!=(const pool_allocator &, const pool_allocator<U> &) { return false; }
+};
+
+/**
+ * @brief 单个对象的构造 / 销毁
+ */
+template <class T>
+class object_pool
+{
+public:
+    struct deleter
+    {
+        void operator()(T *p) const noexcept { object_pool::destroy(p); }
+    };
+    typedef std::unique_ptr<T, deleter> pointer;
+
+    template <class... Args>
+    static T *make(Args &&...args)
+    {
+        pool_allocator<T> alloc;
+        T *p = alloc.allocate(1);
+        try
+        {
+            ::new (static_cast<void *>(p)) T(std::forward<Args>(args)...);
+        }
+        catch (...)
+        {
+            alloc.deallocate(p, 1);
+            throw;
+        }
+        return p;
+    }
+
+    template <class... Args>
+    static pointer make_unique(Args &&...args)
+    {
+        return pointer(make(std::forward<Args>(args)...));
+    }
+
+    /* 可以在任意线程调用，不要求与 make 同一线程 */
+    static void destroy(T *p) noexcept
+    {
+        if (p != nullptr)
+        {
+            p->~T();
+            pool_allocator<T>().deallocate(p, 1);
+        }
+    }
+
+    static pool_stats stats() { return pool_allocator<T>::stats(); }
+};
+
+template <class T>
+using pool_ptr = typename object_pool<T>::pointer;
+
+} // namespace learning
+
+#endif // OBJECT_POOL_HPP
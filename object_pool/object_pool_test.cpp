@@ -0,0 +1,154 @@
+/**
+ * @file object_pool_test.cpp
+ * @author Richard Wang
+ * @brief 对象池示例
+ *  1. tuple_test() 中的 std::list<tuple<int, string, int>> 换成 pool_allocator，节点来自对象池；
+ *  2. 生产者线程 make、消费者线程 destroy(跨线程释放)，稳态下不再申请新的内存块；
+ *  3. 基准：链表节点反复插入删除，std::allocator 与 pool_allocator 的耗时和每次操作的 malloc 次数。
+ *
+ * 编译: g++ -std=c++14 -O2 -pthread object_pool_test.cpp -o object_pool_test
+ * @version : 1.0
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c), Richard Wang.
+ *
+ */
+
+#define LEARNING_ALLOC_TRACKER_IMPLEMENTATION
+
+#include <iostream>
+#include <algorithm>
+#include <list>
+#include <string>
+#include <thread>
+#include <tuple>
+#include <vector>
+
+#include "../alloc_tracker/alloc_tracker.hpp"
+#include "../mpmc_queue/mpmc_queue.hpp"
+#include "object_pool.hpp"
+
+typedef std::tuple<int, std::string, int> user_t; // (年龄, 姓名, 身高)
+typedef std::list<user_t, learning::pool_allocator<user_t>> pool_list;
+
+/**
+ * @brief 以对象池为分配器的 std::list
+ */
+void list_test()
+{
+    std::cout << "------------- test list ------------------" << std::endl;
+    pool_list userList;
+    userList.emplace_back(26, "Richard", 178);
+    userList.emplace_back(29, "Jack", 180);
+    userList.emplace_back(25, "Simth", 191);
+    for_each(userList.begin(), userList.end(), [](const user_t &user)
+             { std::cout << "Age:" << std::get<0>(user) << ", Name: " << std::get<1>(user) << ", High: " << std::get<2>(user) << std::endl; });
+
+    learning::alloc_stats s = learning::count_allocations([&userList]()
+                                                          {
+                                                              for (int i = 0; i < 10000; ++i)
+                                                              {
+                                                                  userList.emplace_back(i % 60, "Mark", 175);
+                                                              }
+                                                              userList.clear();
+                                                          });
+    std::cout << "10000 emplace_back + clear: " << s.allocations << " mallocs" << std::endl;
+
+    /* 所有 pool_allocator 相等，splice 不需要复制节点 */
+    pool_list other;
+    other.emplace_back(33, "Rose", 165);
+    userList.splice(userList.end(), other);
+    std::cout << "after splice: " << userList.size() << " / " << other.size() << std::endl;
+}
+
+/**
+ * @brief 生产者分配、消费者释放
+ */
+void cross_thread_test()
+{
+    std::cout << "------------- test cross-thread free ------------------" << std::endl;
+    typedef learning::object_pool<user_t> pool;
+    const int kRounds = 4;
+    const int kPerRound = 50000;
+
+    for (int round = 0; round < kRounds; ++round)
+    {
+        learning::mpmc_queue<user_t *> queue(1024);
+        std::thread producer([&queue]()
+                             {
+                                 for (int i = 0; i < kPerRound; ++i)
+                                 {
+                                     queue.push(pool::make(i % 60, "Richard", 178));
+                                 }
+                                 queue.close();
+                             });
+        long long ages = 0;
+        std::thread consumer([&queue, &ages]()
+                             {
+                                 user_t *u = nullptr;
+                                 while (queue.pop(u))
+                                 {
+                                     ages += std::get<0>(*u);
+                                     pool::destroy(u);
+                                 }
+                             });
+        producer.join();
+        consumer.join();
+        std::cout << "round " << round << ": sum " << ages << ", " << pool::stats() << std::endl;
+    }
+
+    learning::pool_ptr<user_t> u = pool::make_unique(26, "Richard", 178);
+    std::cout << "pool_ptr: " << std::get<1>(*u) << std::endl;
+}
+
+/**
+ * @brief 节点反复插入删除
+ */
+template <class List>
+void churn(learning::benchmark_state &state)
+{
+    List users;
+    for (int i = 0; i < 1000; ++i)
+    {
+        users.emplace_back(i % 60, "Richard", 178);
+    }
+    while (state.keep_running())
+    {
+        for (int i = 0; i < 100; ++i)
+        {
+            users.pop_front();
+            users.emplace_back(i % 60, "Richard", 178);
+        }
+        learning::do_not_optimize(users);
+    }
+}
+
+void benchmark_test()
+{
+    std::cout << "------------- test benchmark ------------------" << std::endl;
+    learning::benchmark_options options;
+    options.max_time_ms = 300;
+    learning::benchmark_runner runner(options);
+    learning::alloc_probe probe;
+    runner.add_probe(probe);
+    runner.add("churn/std::allocator", churn<std::list<user_t>>);
+    runner.add("churn/pool_allocator", churn<pool_list>);
+    runner.run(std::cout);
+}
+
+int main()
+{
+    /********************* list_test() **************/
+    list_test();
+    /************************************************/
+
+    /*************** cross_thread_test() ************/
+    cross_thread_test();
+    /************************************************/
+
+    /****************** benchmark_test() ************/
+    benchmark_test();
+    /************************************************/
+
+    return 0;
+}
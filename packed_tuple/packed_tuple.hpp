@@ -0,0 +1,428 @@
+/**
+ * @file packed_tuple.hpp
+ * @author Richard Wang
+ * @brief 编译期按对齐重排字段的紧凑记录，按原下标访问，并在编译期给出 sizeof / 填充字节
+ *  1. 问题
+ *      std::tuple<int, std::string, int> 在 libstdc++ 中依次放置 int、string、int：
+ *      两个 int 各自被补齐到 8 字节，sizeof 为 48，其中 8 字节是填充；顺序扫描时每条记录多读 8 字节。
+ *  2. packed_tuple<Ts...>
+ *      编译期把字段按对齐从大到小稳定排序(对齐相同保持原顺序)后依次存放，string(32) + int + int = 40 字节；
+ *      对齐都是 2 的幂时，这一顺序下字段之间不会产生填充，只剩末尾补齐。
+ *  3. 访问
+ *      learning::get<I>(r) 的 I 是原始字段下标，编译期映射到重排后的位置，没有运行期开销；
+ *      提供 std::tuple_size / std::tuple_element，C++17 下可以直接用结构化绑定；
+ *      可以从 std::tuple / std::pair 构造，to_tuple() 转回；比较运算按原始字段顺序进行。
+ *  4. 编译期报告
+ *      packed_layout<Ts...> 给出 payload(字段大小之和)、packed_size / packed_padding、
+ *      tuple_size / tuple_padding(对应 std::tuple 的值)以及每条缓存行能放下的记录数，都可以用在 static_assert 中；
+ *      write_layout() 打印每个字段的大小、对齐和在紧凑布局中的偏移。
+ *
+ *  typedef std::tuple<int, std::string, int> user_t;
+ *  typedef learning::packed_t<user_t> packed_user_t;                // packed_tuple<int, std::string, int>
+ *  static_assert(learning::packed_layout_t<user_t>::packed_padding == 0, "");
+ *  packed_user_t u(26, "Richard", 178);
+ *  learning::get<1>(u) = "Jack";                                      // 仍然按原下标访问
+ * @version : 1.0
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c), Richard Wang.
+ *
+ */
+#ifndef PACKED_TUPLE_HPP
+#define PACKED_TUPLE_HPP
+
+#include <cstddef>
+#include <ostream>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+namespace learning
+{
+
+namespace detail
+{
+
+static const std::size_t kPackedCacheLine = 64;
+
+template <std::size_t N>
+struct index_map
+{
+    std::size_t value[N == 0 ? 1 : N];
+};
+
+/* 字段存放顺序：按对齐从大到小的稳定插入排序，value[k] 为第 k 个存放位置上的原始下标 */
+template <class... Ts>
+constexpr index_map<sizeof...(Ts)> packed_order()
+{
+    const std::size_t align[] = {alignof(Ts)..., 0};
+    index_map<sizeof...(Ts)> m{};
+    for (std::size_t i = 0; i < sizeof...(Ts); ++i)
+    {
+        std::size_t k = i;
+        while (k > 0 && align[m.value[k - 1]] < align[i])
+        {
+            m.value[k] = m.value[k - 1];
+            --k;
+        }
+        m.value[k] = i;
+    }
+    return m;
+}
+
+template <class... Ts>
+constexpr std::size_t order_at(std::size_t k)
+{
+    return packed_order<Ts...>().value[k];
+}
+
+/* 原始下标 i 的字段所在的存放位置 */
+template <class... Ts>
+constexpr std::size_t slot_of(std::size_t i)
+{
+    std::size_t k = 0;
+    while (order_at<Ts...>(k) != i)
+    {
+        ++k;
+    }
+    return k;
+}
+
+/* 原始下标 i 的字段在紧凑布局中的偏移：逐个存放位置累加大小并按下一个字段的对齐取整 */
+template <class... Ts>
+constexpr std::size_t packed_offset(std::size_t i)
+{
+    const std::size_t size[] = {sizeof(Ts)..., 0};
+    const std::size_t align[] = {alignof(Ts)..., 1};
+    const std::size_t slot = slot_of<Ts...>(i);
+    std::size_t offset = 0;
+    for (std::size_t k = 0; k <= slot; ++k)
+    {
+        const std::size_t a = align[order_at<Ts...>(k)];
+        offset = (offset + a - 1) / a * a;
+        if (k != slot)
+        {
+            offset += size[order_at<Ts...>(k)];
+        }
+    }
+    return offset;
+}
+
+/**
+ * @brief 按存放顺序递归保存字段；每一层的尾部对齐不超过头部，因此层与层之间没有填充
+ */
+template <class... Ts>
+struct packed_storage
+{
+    packed_storage() = default;
+
+    template <class Args>
+    packed_storage(std::index_sequence<>, Args &&)
+    {
+    }
+};
+
+template <class T>
+struct packed_storage<T>
+{
+    T head; // 最后一个字段单独特化，避免空的尾部再占一个字节
+
+    packed_storage() : head() {}
+
+    template <class Args, std::size_t P>
+    packed_storage(std::index_sequence<P>, Args &&args) : head(std::get<P>(std::forward<Args>(args)))
+    {
+    }
+};
+
+template <class T, class U, class... Rest>
+struct packed_storage<T, U, Rest...>
+{
+    T head;
+    packed_storage<U, Rest...> tail;
+
+    packed_storage() : head(), tail() {}
+
+    /* Args 是 std::tuple<Us&&...>，存放位置 k 上的字段取第 P 个参数 */
+    template <class Args, std::size_t P, std::size_t... Ps>
+    packed_storage(std::index_sequence<P, Ps...>, Args &&args)
+        : head(std::get<P>(std::forward<Args>(args))), tail(std::index_sequence<Ps...>(), std::forward<Args>(args))
+    {
+    }
+};
+
+template <std::size_t K>
+struct storage_slot
+{
+    template <class S>
+    static auto &get(S &s) { return storage_slot<K - 1>::get(s.tail); }
+    template <class S>
+    static const auto &get(const S &s) { return storage_slot<K - 1>::get(s.tail); }
+};
+
+template <>
+struct storage_slot<0>
+{
+    template <class S>
+    static auto &get(S &s) { return s.head; }
+    template <class S>
+    static const auto &get(const S &s) { return s.head; }
+};
+
+template <class Tuple, class Order>
+struct storage_for;
+
+template <class... Ts, std::size_t... K>
+struct storage_for<std::tuple<Ts...>, std::index_sequence<K...>>
+{
+    typedef packed_storage<typename std::tuple_element<order_at<Ts...>(K), std::tuple<Ts...>>::type...> type;
+    typedef std::index_sequence<order_at<Ts...>(K)...> order;
+};
+
+template <class... Ts>
+constexpr std::size_t sum_sizes()
+{
+    const std::size_t size[] = {sizeof(Ts)..., 0};
+    std::size_t total = 0;
+    for (std::size_t i = 0; i < sizeof...(Ts); ++i)
+    {
+        total += size[i];
+    }
+    return total;
+}
+
+} // namespace detail
+
+template <class... Ts>
+class packed_tuple;
+
+template <std::size_t I, class... Ts>
+typename std::tuple_element<I, std::tuple<Ts...>>::type &get(packed_tuple<Ts...> &t) noexcept;
+template <std::size_t I, class... Ts>
+const typename std::tuple_element<I, std::tuple<Ts...>>::type &get(const packed_tuple<Ts...> &t) noexcept;
+template <std::size_t I, class... Ts>
+typename std::tuple_element<I, std::tuple<Ts...>>::type &&get(packed_tuple<Ts...> &&t) noexcept;
+
+/**
+ * @brief 字段按对齐重排存放的 tuple
+ */
+template <class... Ts>
+class packed_tuple
+{
+    typedef detail::storage_for<std::tuple<Ts...>, std::make_index_sequence<sizeof...(Ts)>> layout;
+
+public:
+    packed_tuple() = default;
+
+    /* 参数按原始字段顺序给出 */
+    template <class... Us, class = typename std::enable_if<sizeof...(Us) == sizeof...(Ts) && sizeof...(Ts) != 0 &&
+                                                           std::is_constructible<std::tuple<Ts...>, Us &&...>::value>::type>
+    explicit packed_tuple(Us &&...args)
+        : storage_(typename layout::order(), std::forward_as_tuple(std::forward<Us>(args)...))
+    {
+    }
+
+    explicit packed_tuple(const std::tuple<Ts...> &t) : storage_(typename layout::order(), t) {}
+    explicit packed_tuple(std::tuple<Ts...> &&t) : storage_(typename layout::order(), std::move(t)) {}
+
+    template <class A, class B, class = typename std::enable_if<std::is_constructible<std::tuple<Ts...>, const A &, const B &>::value>::type>
+    explicit packed_tuple(const std::pair<A, B> &p) : packed_tuple(p.first, p.second)
+    {
+    }
+
+    /* 按原始字段顺序转回 std::tuple */
+    std::tuple<Ts...> to_tuple() const & { return to_tuple(std::index_sequence_for<Ts...>()); }
+    std::tuple<Ts...> to_tuple() && { return std::move(*this).to_tuple(std::index_sequence_for<Ts...>()); }
+
+    /* 按原始字段顺序的引用元组，用于比较 */
+    std::tuple<const Ts &...> as_tie() const { return as_tie(std::index_sequence_for<Ts...>()); }
+
+    friend bool operator==(const packed_tuple &a, const packed_tuple &b) { return a.as_tie() == b.as_tie(); }
+    friend bool operator!=(const packed_tuple &a, const packed_tuple &b) { return !(a == b); }
+    friend bool operator<(const packed_tuple &a, const packed_tuple &b) { return a.as_tie() < b.as_tie(); }
+    friend bool operator>(const packed_tuple &a, const packed_tuple &b) { return b < a; }
+    friend bool operator<=(const packed_tuple &a, const packed_tuple &b) { return !(b < a); }
+    friend bool operator>=(const packed_tuple &a, const packed_tuple &b) { return !(a < b); }
+
+private:
+    template <std::size_t I, class... Us>
+    friend typename std::tuple_element<I, std::tuple<Us...>>::type &get(packed_tuple<Us...> &t) noexcept;
+    template <std::size_t I, class... Us>
+    friend const typename std::tuple_element<I, std::tuple<Us...>>::type &get(const packed_tuple<Us...> &t) noexcept;
+    template <std::size_t I, class... Us>
+    friend typename std::tuple_element<I, std::tuple<Us...>>::type &&get(packed_tuple<Us...> &&t) noexcept;
+
+    template <std::size_t... I>
+    std::tuple<Ts...> to_tuple(std::index_sequence<I...>) const & { return std::tuple<Ts...>(learning::get<I>(*this)...); }
+    template <std::size_t... I>
+    std::tuple<Ts...> to_tuple(std::index_sequence<I...>) && { return std::tuple<Ts...>(learning::get<I>(std::move(*this))...); }
+    template <std::size_t... I>
+    std::tuple<const Ts &...> as_tie(std::index_sequence<I...>) const { return std::tuple<const Ts &...>(learning::get<I>(*this)...); }
+
+    typename layout::type storage_;
+};
+
+/**
+ * @brief 按原始下标访问字段
+ */
+template <std::size_t I, class... Ts>
+typename std::tuple_element<I, std::tuple<Ts...>>::type &get(packed_tuple<Ts...> &t) noexcept
+{
+    return detail::storage_slot<detail::slot_of<Ts...>(I)>::get(t.storage_);
+}
+
+template <std::size_t I, class... Ts>
+const typename std::tuple_element<I, std::tuple<Ts...>>::type &get(const packed_tuple<Ts...> &t) noexcept
+{
+    return detail::storage_slot<detail::slot_of<Ts...>(I)>::get(t.storage_);
+}
+
+template <std::size_t I, class... Ts>
+typename std::tuple_element<I, std::tuple<Ts...>>::type &&get(packed_tuple<Ts...> &&t) noexcept
+{
+    typedef typename std::tuple_element<I, std::tuple<Ts...>>::type field_type;
+    return static_cast<field_type &&>(detail::storage_slot<detail::slot_of<Ts...>(I)>::get(t.storage_));
+}
+
+/**
+ * @brief std::tuple / std::pair 记录对应的紧凑类型
+ */
+template <class Record>
+struct packed_type;
+
+template <class... Ts>
+struct packed_type<std::tuple<Ts...>>
+{
+    typedef packed_tuple<Ts...> type;
+};
+
+template <class A, class B>
+struct packed_type<std::pair<A, B>>
+{
+    typedef packed_tuple<A, B> type;
+};
+
+template <class Record>
+using packed_t = typename packed_type<Record>::type;
+
+template <class Record>
+packed_t<typename std::decay<Record>::type> pack(Record &&r)
+{
+    return packed_t<typename std::decay<Record>::type>(std::forward<Record>(r));
+}
+
+/**
+ * @brief 编译期布局报告
+ */
+template <class... Ts>
+struct packed_layout
+{
+    static constexpr std::size_t fields = sizeof...(Ts);
+    static constexpr std::size_t payload = detail::sum_sizes<Ts...>();
+    static constexpr std::size_t packed_size = sizeof(packed_tuple<Ts...>);
+    static constexpr std::size_t packed_padding = packed_size - payload;
+    static constexpr std::size_t tuple_size = sizeof(std::tuple<Ts...>);
+    static constexpr std::size_t tuple_padding = tuple_size - payload;
+    static constexpr std::size_t records_per_cache_line_packed = detail::kPackedCacheLine / packed_size;
+    static constexpr std::size_t records_per_cache_line_tuple = detail::kPackedCacheLine / tuple_size;
+
+    /* 原始下标 i 的字段在 packed_tuple 中的偏移 */
+    static constexpr std::size_t offset_of(std::size_t i) { return detail::packed_offset<Ts...>(i); }
+};
+
+template <class... Ts>
+constexpr std::size_t packed_layout<Ts...>::fields;
+template <class... Ts>
+constexpr std::size_t packed_layout<Ts...>::payload;
+template <class... Ts>
+constexpr std::size_t packed_layout<Ts...>::packed_size;
+template <class... Ts>
+constexpr std::size_t packed_layout<Ts...>::packed_padding;
+template <class... Ts>
+constexpr std::size_t packed_layout<Ts...>::tuple_size;
+template <class... Ts>
+constexpr std::size_t packed_layout<Ts...>::tuple_padding;
+template <class... Ts>
+constexpr std::size_t packed_layout<Ts...>::records_per_cache_line_packed;
+template <class... Ts>
+constexpr std::size_t packed_layout<Ts...>::records_per_cache_line_tuple;
+
+template <class Record>
+struct packed_layout_of;
+
+template <class... Ts>
+struct packed_layout_of<std::tuple<Ts...>>
+{
+    typedef packed_layout<Ts...> type;
+};
+
+template <class A, class B>
+struct packed_layout_of<std::pair<A, B>>
+{
+    typedef packed_layout<A, B> type;
+};
+
+template <class Record>
+using packed_layout_t = typename packed_layout_of<Record>::type;
+
+namespace detail
+{
+
+template <class... Ts, std::size_t... I>
+void write_fields(std::ostream &os, std::index_sequence<I...>)
+{
+    const std::size_t size[] = {sizeof(Ts)..., 0};
+    const std::size_t align[] = {alignof(Ts)..., 0};
+    const std::size_t offset[] = {packed_layout<Ts...>::offset_of(I)..., 0};
+    for (std::size_t i = 0; i < sizeof...(Ts); ++i)
+    {
+        os << "    field " << i << ": size " << size[i] << ", align " << align[i] << ", packed offset " << offset[i] << std::endl;
+    }
+}
+
+template <class... Ts>
+void write_layout(std::ostream &os, const char *name, std::tuple<Ts...> *)
+{
+    typedef packed_layout<Ts...> L;
+    os << name << ": payload " << L::payload << " B, std::tuple " << L::tuple_size << " B (padding " << L::tuple_padding << "), packed "
+       << L::packed_size << " B (padding " << L::packed_padding << "), per cache line " << L::records_per_cache_line_tuple << " -> "
+       << L::records_per_cache_line_packed << std::endl;
+    write_fields<Ts...>(os, std::index_sequence_for<Ts...>());
+}
+
+template <class A, class B>
+void write_layout(std::ostream &os, const char *name, std::pair<A, B> *)
+{
+    write_layout(os, name, static_cast<std::tuple<A, B> *>(nullptr));
+}
+
+} // namespace detail
+
+/**
+ * @brief 打印 std::tuple / std::pair 记录的布局对比
+ */
+template <class Record>
+void write_layout(std::ostream &os, const char *name)
+{
+    detail::write_layout(os, name, static_cast<Record *>(nullptr));
+}
+
+} // namespace learning
+
+namespace std
+{
+
+template <class... Ts>
+struct tuple_size<learning::packed_tuple<Ts...>> : std::integral_constant<std::size_t, sizeof...(Ts)>
+{
+};
+
+template <std::size_t I, class... Ts>
+struct tuple_element<I, learning::packed_tuple<Ts...>>
+{
+    typedef typename std::tuple_element<I, std::tuple<Ts...>>::type type;
+};
+
+} // namespace std
+
+#endif // PACKED_TUPLE_HPP
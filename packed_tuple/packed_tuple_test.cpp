@@ -0,0 +1,143 @@
+/**
+ * @file packed_tuple_test.cpp
+ * @author Richard Wang
+ * @brief 紧凑记录示例
+ *  1. tuple_test() / pair_test() / tie_test() 中几种记录的布局对比(编译期 static_assert 检查)；
+ *  2. 按原下标读写字段、与 std::tuple 互相转换、排序比较，C++17 下的结构化绑定；
+ *  3. 基准：顺序扫描 100 万条 tuple<int, string, int> 与紧凑记录累加年龄和身高。
+ *
+ * 编译: g++ -std=c++14 -O2 packed_tuple_test.cpp -o packed_tuple_test
+ * @version : 1.0
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c), Richard Wang.
+ *
+ */
+
+#include <iostream>
+#include <algorithm>
+#include <string>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#include "../benchmark/benchmark.hpp"
+#include "packed_tuple.hpp"
+
+typedef std::pair<int, std::string> pair_t;                          // (年龄, 姓名)
+typedef std::tuple<int, std::string, int> user_t;                    // (年龄, 姓名, 身高)
+typedef std::tuple<int, std::string, std::string> info_t;            // (日期, 月份, 国家)
+typedef std::tuple<char, double, short, int, char> mixed_t;
+
+typedef learning::packed_t<user_t> packed_user_t;
+
+/* 重排后没有字段间填充，且不会比 std::tuple 更大 */
+static_assert(learning::packed_layout_t<user_t>::packed_padding == 0, "user_t should pack without padding");
+static_assert(learning::packed_layout_t<user_t>::packed_size <= learning::packed_layout_t<user_t>::tuple_size, "packing must not grow the record");
+static_assert(learning::packed_layout_t<mixed_t>::packed_size <= learning::packed_layout_t<mixed_t>::tuple_size, "packing must not grow the record");
+static_assert(std::tuple_size<packed_user_t>::value == 3, "");
+static_assert(std::is_same<std::tuple_element<1, packed_user_t>::type, std::string>::value, "");
+
+/**
+ * @brief 布局对比
+ */
+void layout_test()
+{
+    std::cout << "------------- test layout ------------------" << std::endl;
+    learning::write_layout<user_t>(std::cout, "tuple<int, string, int>");
+    learning::write_layout<info_t>(std::cout, "tuple<int, string, string>");
+    learning::write_layout<pair_t>(std::cout, "pair<int, string>");
+    learning::write_layout<mixed_t>(std::cout, "tuple<char, double, short, int, char>");
+
+    /* 编译期偏移与实际地址一致 */
+    packed_user_t u(26, "Richard", 178);
+    const char *base = reinterpret_cast<const char *>(&u);
+    std::cout << "offsets (runtime): " << reinterpret_cast<const char *>(&learning::get<0>(u)) - base << ", "
+              << reinterpret_cast<const char *>(&learning::get<1>(u)) - base << ", " << reinterpret_cast<const char *>(&learning::get<2>(u)) - base
+              << std::endl;
+}
+
+/**
+ * @brief 字段访问
+ */
+void access_test()
+{
+    std::cout << "------------- test access ------------------" << std::endl;
+    std::vector<packed_user_t> userList;
+    userList.emplace_back(26, "Richard", 178);
+    userList.emplace_back(user_t(29, "Jack", 180));
+    userList.push_back(learning::pack(user_t(25, "Simth", 191)));
+    learning::get<1>(userList[2]) = "Smith";
+
+    sort(userList.begin(), userList.end());
+    for_each(userList.begin(), userList.end(), [](const packed_user_t &user)
+             { std::cout << "Age:" << learning::get<0>(user) << ", Name: " << learning::get<1>(user) << ", High: " << learning::get<2>(user) << std::endl; });
+
+    user_t back = userList.front().to_tuple();
+    std::cout << "to_tuple: " << std::get<1>(back) << ", round trip equal: " << std::boolalpha << (learning::pack(back) == userList.front())
+              << std::endl;
+
+    learning::packed_t<pair_t> p(pair_t(12, "Mark"));
+    std::cout << "pair: " << learning::get<1>(p) << ", " << learning::get<0>(p) << std::endl;
+
+#if __cplusplus >= 201703L
+    for (const auto &[age, name, height] : userList)
+    {
+        std::cout << "structured binding: " << name << " " << age << " " << height << std::endl;
+    }
+#endif
+}
+
+/**
+ * @brief 顺序扫描
+ */
+template <class Record>
+void scan(learning::benchmark_state &state)
+{
+    std::vector<Record> users;
+    users.reserve(1000000);
+    for (int i = 0; i < 1000000; ++i)
+    {
+        users.emplace_back(i % 60, "Richard", 150 + i % 50);
+    }
+    while (state.keep_running())
+    {
+        long long total = 0;
+        for (const Record &u : users)
+        {
+            using std::get;
+            using learning::get;
+            total += get<0>(u) + get<2>(u);
+        }
+        learning::do_not_optimize(total);
+    }
+    state.add_counter("bytes", static_cast<double>(sizeof(Record) * users.size() * state.iterations()));
+}
+
+void benchmark_test()
+{
+    std::cout << "------------- test scan ------------------" << std::endl;
+    learning::benchmark_options options;
+    options.max_time_ms = 1000;
+    learning::benchmark_runner runner(options);
+    runner.add("scan/std::tuple", scan<user_t>);
+    runner.add("scan/packed_tuple", scan<packed_user_t>);
+    runner.run(std::cout);
+}
+
+int main()
+{
+    /******************** layout_test() *************/
+    layout_test();
+    /************************************************/
+
+    /******************** access_test() *************/
+    access_test();
+    /************************************************/
+
+    /****************** benchmark_test() ************/
+    benchmark_test();
+    /************************************************/
+
+    return 0;
+}
@@ -0,0 +1,457 @@
+/**
+ * @file perf_counters.hpp
+ * @author Richard Wang
+ * @brief 基于 perf_event_open 的硬件性能计数器
+ *  1. perf_counter_group
+ *      打开一组事件(周期、指令、缓存未命中、分支预测失败、dTLB 未命中，以及 task-clock、缺页等软件事件)，
+ *      硬件事件和软件事件各组成一个 group，同组事件同时启停、一次 read 读出，比值(IPC、未命中率)才有意义。
+ *      只统计调用线程自己(pid = 0, cpu = -1)，不含内核态。
+ *      计数器被内核分时复用时，按 time_enabled / time_running 比例放大估算。
+ *  2. 优雅降级
+ *      容器、虚拟机里常常没有 PMU，或者 perf_event_paranoid 不允许；打不开的事件被跳过并记录原因，
+ *      读数里只出现成功打开的事件；非 Linux 平台上所有事件都不可用，接口保持不变。
+ *  3. perf_counters
+ *      RAII 作用域：构造时清零并开始计数，析构时停止，连同 steady_clock 墙钟时间一起写到输出流或 perf_reading。
+ *  4. perf_probe
+ *      接入 benchmark_runner::add_probe()，基准报告中出现每次操作的 cycles / instructions / ... 以及 ipc。
+ *
+ *  learning::perf_counter_group group;
+ *  {
+ *      learning::perf_counters scope(group, "list for_each", std::cout, records.size());
+ *      for_each(list.begin(), list.end(), ...);
+ *  }   // list for_each: 3.1 ms, cycles/op 9.8, instructions/op 6.0, ipc 0.61, cache-misses/op 0.52, ...
+ * @version : 1.0
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c), Richard Wang.
+ *
+ */
+#ifndef PERF_COUNTERS_HPP
+#define PERF_COUNTERS_HPP
+
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <iomanip>
+#include <map>
+#include <ostream>
+#include <sstream>
+#include <string>
+#include <utility>
+#include <vector>
+#if defined(__linux__)
+#include <cerrno>
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+#include "../benchmark/benchmark.hpp"
+
+namespace learning
+{
+
+enum class perf_event
+{
+    cycles,
+    instructions,
+    cache_references,
+    cache_misses,
+    branch_misses,
+    dtlb_misses,
+    task_clock,  // 纳秒
+    page_faults,
+    context_switches
+};
+
+inline const char *perf_event_name(perf_event e)
+{
+    static const char *names[] = {"cycles", "instructions", "cache-references", "cache-misses", "branch-misses",
+                                  "dtlb-misses", "task-clock", "page-faults", "context-switches"};
+    return names[static_cast<int>(e)];
+}
+
+/**
+ * @brief 默认事件：请求中常用的五个硬件事件，外加两个总能打开的软件事件
+ */
+inline std::vector<perf_event> default_perf_events()
+{
+    return {perf_event::cycles, perf_event::instructions, perf_event::cache_misses, perf_event::branch_misses,
+            perf_event::dtlb_misses, perf_event::task_clock, perf_event::page_faults};
+}
+
+/**
+ * @brief 一次读数；只包含成功打开的事件
+ */
+struct perf_reading
+{
+    std::vector<std::pair<perf_event, double>> values;
+    double wall_ns = 0;   // 由 perf_counters 作用域填写
+    bool multiplexed = false; // 至少一个 group 被分时复用，数值是按比例估算的
+
+    bool has(perf_event e) const
+    {
+        for (const std::pair<perf_event, double> &v : values)
+        {
+            if (v.first == e)
+            {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    /* 未打开的事件返回 0 */
+    double get(perf_event e) const
+    {
+        for (const std::pair<perf_event, double> &v : values)
+        {
+            if (v.first == e)
+            {
+                return v.second;
+            }
+        }
+        return 0.0;
+    }
+
+    /* 每周期指令数；没有 cycles / instructions 时返回 0 */
+    double ipc() const
+    {
+        const double c = get(perf_event::cycles);
+        return c > 0 ? get(perf_event::instructions) / c : 0.0;
+    }
+};
+
+/**
+ * @brief 一组一起启停的计数器；只计调用线程，应在同一线程里构造和使用
+ */
+class perf_counter_group
+{
+public:
+    explicit perf_counter_group(const std::vector<perf_event> &events = default_perf_events())
+    {
+        for (perf_event e : events)
+        {
+            open(e);
+        }
+    }
+
+    perf_counter_group(const perf_counter_group &) = delete;
+    perf_counter_group &operator=(const perf_counter_group &) = delete;
+
+    ~perf_counter_group()
+    {
+#if defined(__linux__)
+        for (const group &g : groups_)
+        {
+            for (int fd : g.fds)
+            {
+                ::close(fd);
+            }
+        }
+#endif
+    }
+
+    /* 至少打开了一个事件 */
+    bool available() const
+    {
+        return !opened_.empty();
+    }
+
+    bool hardware_available() const
+    {
+        return !groups_[0].fds.empty();
+    }
+
+    const std::vector<perf_event> &events() const
+    {
+        return opened_;
+    }
+
+    /* 打不开的事件及原因，每行一个；全部成功时为空 */
+    const std::string &errors() const
+    {
+        return errors_;
+    }
+
+    void reset()
+    {
+        control(reset_request);
+    }
+
+    void enable()
+    {
+        control(enable_request);
+    }
+
+    void disable()
+    {
+        control(disable_request);
+    }
+
+    /* 读取自上次 reset 以来(仅 enable 期间)的累计值 */
+    perf_reading read() const
+    {
+        perf_reading reading;
+#if defined(__linux__)
+        for (const group &g : groups_)
+        {
+            if (g.fds.empty())
+            {
+                continue;
+            }
+            /* PERF_FORMAT_GROUP: nr, time_enabled, time_running, value[nr] */
+            std::vector<uint64_t> buffer(3 + g.fds.size());
+            const ssize_t n = ::read(g.fds[0], buffer.data(), buffer.size() * sizeof(uint64_t));
+            if (n < static_cast<ssize_t>(3 * sizeof(uint64_t)) || buffer[0] != g.fds.size())
+            {
+                continue;
+            }
+            const uint64_t enabled = buffer[1];
+            const uint64_t running = buffer[2];
+            const double scale = running > 0 ? static_cast<double>(enabled) / static_cast<double>(running) : 0.0;
+            reading.multiplexed = reading.multiplexed || (running > 0 && running < enabled);
+            for (std::size_t i = 0; i < g.fds.size(); ++i)
+            {
+                reading.values.emplace_back(g.events[i], static_cast<double>(buffer[3 + i]) * scale);
+            }
+        }
+#endif
+        return reading;
+    }
+
+private:
+    struct group
+    {
+        std::vector<int> fds; // fds[0] 是 leader
+        std::vector<perf_event> events;
+    };
+
+    enum request
+    {
+        reset_request,
+        enable_request,
+        disable_request
+    };
+
+    void control(request r)
+    {
+#if defined(__linux__)
+        static const unsigned long codes[] = {PERF_EVENT_IOC_RESET, PERF_EVENT_IOC_ENABLE, PERF_EVENT_IOC_DISABLE};
+        for (const group &g : groups_)
+        {
+            if (!g.fds.empty())
+            {
+                ::ioctl(g.fds[0], codes[r], PERF_IOC_FLAG_GROUP);
+            }
+        }
+#else
+        (void)r;
+#endif
+    }
+
+    void open(perf_event e)
+    {
+#if defined(__linux__)
+        struct perf_event_attr attr;
+        std::memset(&attr, 0, sizeof(attr));
+        attr.size = sizeof(attr);
+        bool hardware = true;
+        switch (e)
+        {
+        case perf_event::cycles:
+            attr.type = PERF_TYPE_HARDWARE;
+            attr.config = PERF_COUNT_HW_CPU_CYCLES;
+            break;
+        case perf_event::instructions:
+            attr.type = PERF_TYPE_HARDWARE;
+            attr.config = PERF_COUNT_HW_INSTRUCTIONS;
+            break;
+        case perf_event::cache_references:
+            attr.type = PERF_TYPE_HARDWARE;
+            attr.config = PERF_COUNT_HW_CACHE_REFERENCES;
+            break;
+        case perf_event::cache_misses:
+            attr.type = PERF_TYPE_HARDWARE;
+            attr.config = PERF_COUNT_HW_CACHE_MISSES;
+            break;
+        case perf_event::branch_misses:
+            attr.type = PERF_TYPE_HARDWARE;
+            attr.config = PERF_COUNT_HW_BRANCH_MISSES;
+            break;
+        case perf_event::dtlb_misses:
+            attr.type = PERF_TYPE_HW_CACHE;
+            attr.config = PERF_COUNT_HW_CACHE_DTLB | (PERF_COUNT_HW_CACHE_OP_READ << 8) | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+            break;
+        case perf_event::task_clock:
+            attr.type = PERF_TYPE_SOFTWARE;
+            attr.config = PERF_COUNT_SW_TASK_CLOCK;
+            hardware = false;
+            break;
+        case perf_event::page_faults:
+            attr.type = PERF_TYPE_SOFTWARE;
+            attr.config = PERF_COUNT_SW_PAGE_FAULTS;
+            hardware = false;
+            break;
+        case perf_event::context_switches:
+            attr.type = PERF_TYPE_SOFTWARE;
+            attr.config = PERF_COUNT_SW_CONTEXT_SWITCHES;
+            hardware = false;
+            break;
+        }
+        attr.exclude_kernel = 1;
+        attr.exclude_hv = 1;
+        attr.read_format = PERF_FORMAT_GROUP | PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+
+        group &g = groups_[hardware ? 0 : 1];
+        const int leader = g.fds.empty() ? -1 : g.fds[0];
+        attr.disabled = leader == -1 ? 1 : 0; // 只有 leader 需要初始为关闭，成员跟随 leader
+        const int fd = static_cast<int>(::syscall(SYS_perf_event_open, &attr, 0, -1, leader, 0));
+        if (fd < 0)
+        {
+            errors_ += std::string(perf_event_name(e)) + ": " + std::strerror(errno) + "\n";
+            return;
+        }
+        g.fds.push_back(fd);
+        g.events.push_back(e);
+        opened_.push_back(e);
+#else
+        errors_ += std::string(perf_event_name(e)) + ": perf_event_open is Linux only\n";
+#endif
+    }
+
+    group groups_[2]; // [0] 硬件事件，[1] 软件事件
+    std::vector<perf_event> opened_;
+    std::string errors_;
+};
+
+/**
+ * @brief 打印一次读数；ops > 1 时按每次操作给出计数
+ */
+inline void write_perf_reading(std::ostream &os, const std::string &label, const perf_reading &reading, double ops = 1)
+{
+    std::ostringstream line;
+    line << std::fixed << std::setprecision(3) << label << ": " << reading.wall_ns / 1e6 << " ms";
+    const char *suffix = ops > 1 ? "/op " : " ";
+    line << std::setprecision(2);
+    for (const std::pair<perf_event, double> &v : reading.values)
+    {
+        line << ", " << perf_event_name(v.first) << suffix << v.second / ops;
+    }
+    if (reading.has(perf_event::cycles) && reading.has(perf_event::instructions))
+    {
+        line << ", ipc " << reading.ipc();
+    }
+    if (reading.multiplexed)
+    {
+        line << " (multiplexed, scaled)";
+    }
+    os << line.str() << std::endl;
+}
+
+/**
+ * @brief RAII 作用域：构造时清零并开始计数，析构时停止并输出
+ */
+class perf_counters
+{
+public:
+    typedef std::chrono::steady_clock clock;
+
+    /* 析构时打印到 os，计数除以 ops 得到每次操作的值 */
+    perf_counters(perf_counter_group &group, const std::string &label, std::ostream &os, double ops = 1)
+        : group_(group), label_(label), os_(&os), ops_(ops), out_(nullptr)
+    {
+        start();
+    }
+
+    /* 析构时写入 result，不打印 */
+    perf_counters(perf_counter_group &group, perf_reading &result)
+        : group_(group), os_(nullptr), ops_(1), out_(&result)
+    {
+        start();
+    }
+
+    perf_counters(const perf_counters &) = delete;
+    perf_counters &operator=(const perf_counters &) = delete;
+
+    ~perf_counters()
+    {
+        const clock::time_point end = clock::now();
+        group_.disable();
+        perf_reading reading = group_.read();
+        reading.wall_ns = std::chrono::duration<double, std::nano>(end - begin_).count();
+        if (out_ != nullptr)
+        {
+            *out_ = std::move(reading);
+        }
+        else
+        {
+            write_perf_reading(*os_, label_, reading, ops_);
+        }
+    }
+
+private:
+    void start()
+    {
+        group_.reset();
+        group_.enable();
+        begin_ = clock::now();
+    }
+
+    perf_counter_group &group_;
+    std::string label_;
+    std::ostream *os_;
+    double ops_;
+    perf_reading *out_;
+    clock::time_point begin_;
+};
+
+/**
+ * @brief benchmark_runner 的采样扩展：计数器只在计时期间开启
+ */
+class perf_probe : public benchmark_probe
+{
+public:
+    explicit perf_probe(perf_counter_group &group) : group_(group)
+    {
+        group_.reset();
+    }
+
+    void start() override
+    {
+        group_.enable();
+    }
+
+    void stop() override
+    {
+        group_.disable();
+    }
+
+    void collect(std::map<std::string, double> &counters) override
+    {
+        const perf_reading reading = group_.read();
+        for (const std::pair<perf_event, double> &v : reading.values)
+        {
+            counters[perf_event_name(v.first)] += v.second;
+        }
+        group_.reset();
+    }
+
+    void finish(benchmark_result &result) override
+    {
+        std::map<std::string, double>::const_iterator cycles = result.counters.find(perf_event_name(perf_event::cycles));
+        std::map<std::string, double>::const_iterator instructions = result.counters.find(perf_event_name(perf_event::instructions));
+        if (cycles != result.counters.end() && instructions != result.counters.end() && cycles->second > 0)
+        {
+            result.counters["ipc"] = instructions->second / cycles->second;
+        }
+    }
+
+private:
+    perf_counter_group &group_;
+};
+
+} // namespace learning
+
+#endif // PERF_COUNTERS_HPP
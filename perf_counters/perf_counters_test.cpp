@@ -0,0 +1,181 @@
+/**
+ * @file perf_counters_test.cpp
+ * @author Richard Wang
+ * @brief 硬件计数器示例：解释 tuple_test() 中 std::list 遍历为什么慢
+ *  1. 打印哪些事件可用(没有 PMU 的虚拟机、容器里只剩软件事件)；
+ *  2. perf_counters 作用域：遍历 vector、按分配顺序排列的 list、节点被打乱的 list，
+ *     对比每条记录的周期数、IPC 和缓存 / dTLB 未命中数；
+ *  3. 同样的三个遍历交给 benchmark_runner，通过 perf_probe 在报告中附上每次操作的计数。
+ *
+ * 编译: g++ -std=c++14 -O2 -pthread perf_counters_test.cpp -o perf_counters_test
+ * @version : 1.0
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c), Richard Wang.
+ *
+ */
+
+#include <iostream>
+#include <algorithm>
+#include <list>
+#include <random>
+#include <string>
+#include <tuple>
+#include <vector>
+
+#include "perf_counters.hpp"
+
+typedef std::tuple<int, std::string, int> user_t; // (年龄, 姓名, 身高)
+
+static const std::size_t kRecords = 1000000;
+
+struct datasets
+{
+    std::vector<user_t> vector;
+    std::list<user_t> sequential; // 按顺序 push_back，节点在堆上基本连续
+    std::list<user_t> shuffled;   // 节点打乱后重新链接，遍历时几乎每一步都跳到新的缓存行
+};
+
+static datasets make_datasets()
+{
+    const char *names[] = {"Richard", "Jack", "Simth", "Mark", "Rose", "Jim", "Amy", "Lucy"};
+    datasets data;
+    data.vector.reserve(kRecords);
+    for (std::size_t i = 0; i < kRecords; ++i)
+    {
+        data.vector.emplace_back(static_cast<int>(i % 60) + 10, names[i % 8], 160 + static_cast<int>(i % 40));
+    }
+    data.sequential.assign(data.vector.begin(), data.vector.end());
+    data.shuffled.assign(data.vector.begin(), data.vector.end());
+
+    /* 只重排节点之间的链接，不移动节点本身 */
+    std::vector<std::list<user_t>::iterator> nodes;
+    for (std::list<user_t>::iterator it = data.shuffled.begin(); it != data.shuffled.end(); ++it)
+    {
+        nodes.push_back(it);
+    }
+    std::shuffle(nodes.begin(), nodes.end(), std::mt19937(3));
+    for (std::list<user_t>::iterator node : nodes)
+    {
+        data.shuffled.splice(data.shuffled.end(), data.shuffled, node);
+    }
+    return data;
+}
+
+template <class Container>
+long long sum_ages(const Container &records)
+{
+    long long ages = 0;
+    for_each(records.begin(), records.end(), [&ages](const user_t &user)
+             { ages += std::get<0>(user); });
+    return ages;
+}
+
+/**
+ * @brief 可用事件
+ */
+void events_test(const learning::perf_counter_group &group)
+{
+    std::cout << "------------- test events ------------------" << std::endl;
+    std::cout << "opened:";
+    for (learning::perf_event e : group.events())
+    {
+        std::cout << " " << learning::perf_event_name(e);
+    }
+    std::cout << std::endl;
+    if (!group.hardware_available())
+    {
+        std::cout << "hardware counters unavailable (no PMU or perf_event_paranoid too high), unavailable events:\n"
+                  << group.errors();
+    }
+}
+
+/**
+ * @brief 作用域计数
+ */
+void scope_test(learning::perf_counter_group &group, const datasets &data)
+{
+    std::cout << "------------- test perf_counters scope ------------------" << std::endl;
+    long long check = 0;
+    {
+        learning::perf_counters scope(group, "vector<tuple>   ", std::cout, kRecords);
+        check += sum_ages(data.vector);
+    }
+    {
+        learning::perf_counters scope(group, "list sequential ", std::cout, kRecords);
+        check += sum_ages(data.sequential);
+    }
+    {
+        learning::perf_counters scope(group, "list shuffled   ", std::cout, kRecords);
+        check += sum_ages(data.shuffled);
+    }
+
+    /* 也可以把读数留给调用者自己处理 */
+    learning::perf_reading reading;
+    {
+        learning::perf_counters scope(group, reading);
+        check += sum_ages(data.shuffled);
+    }
+    std::cout << "shuffled list: " << reading.wall_ns / kRecords << " ns/record";
+    if (reading.has(learning::perf_event::cache_misses))
+    {
+        std::cout << ", " << reading.get(learning::perf_event::cache_misses) / kRecords << " cache misses/record";
+    }
+    std::cout << " (checksum " << check << ")" << std::endl;
+}
+
+/**
+ * @brief 基准报告中附带计数
+ */
+void benchmark_test(learning::perf_counter_group &group, const datasets &data)
+{
+    std::cout << "------------- test perf_probe ------------------" << std::endl;
+    learning::benchmark_options options;
+    options.max_time_ms = 500;
+    learning::benchmark_runner runner(options);
+    learning::perf_probe probe(group);
+    runner.add_probe(probe);
+
+    runner.add("for_each/vector<tuple>", [&data](learning::benchmark_state &state)
+               {
+                   while (state.keep_running())
+                   {
+                       learning::do_not_optimize(sum_ages(data.vector));
+                   }
+               });
+    runner.add("for_each/list<tuple>/sequential", [&data](learning::benchmark_state &state)
+               {
+                   while (state.keep_running())
+                   {
+                       learning::do_not_optimize(sum_ages(data.sequential));
+                   }
+               });
+    runner.add("for_each/list<tuple>/shuffled", [&data](learning::benchmark_state &state)
+               {
+                   while (state.keep_running())
+                   {
+                       learning::do_not_optimize(sum_ages(data.shuffled));
+                   }
+               });
+    runner.run(std::cout);
+}
+
+int main()
+{
+    learning::perf_counter_group group;
+    const datasets data = make_datasets();
+
+    /********************* events_test() ************/
+    events_test(group);
+    /************************************************/
+
+    /********************** scope_test() ************/
+    scope_test(group, data);
+    /************************************************/
+
+    /****************** benchmark_test() ************/
+    benchmark_test(group, data);
+    /************************************************/
+
+    return 0;
+}
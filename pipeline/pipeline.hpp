@@ -0,0 +1,506 @@
+/**
+ * @file pipeline.hpp
+ * @author Richard Wang
+ * @brief 多阶段记录处理流水线
+ *  1. 结构
+ *      source -> transform -> filter -> ... -> sink，每个阶段是一个 lambda，阶段之间用有界 mpmc_queue 连接。
+ *      每个阶段可以指定并行度(线程数)；同一阶段的多个线程从同一个输入队列取数据，因此输出顺序不保证与输入一致。
+ *  2. 反压(backpressure)
+ *      队列有界，下游处理不过来时上游 push 阻塞，最终 source 的 emit 也会阻塞，内存占用不会无限增长。
+ *  3. 结束与异常
+ *      source 函数返回后关闭它的输出队列；某一阶段的最后一个线程退出时关闭下一个队列，结束信号逐级传递。
+ *      任一阶段抛出异常时关闭所有队列，run() 等待所有线程退出后重新抛出第一个异常。
+ *      每个 source / transform / filter 的输出都必须接上下游阶段，最后以 sink 结束：没有消费者的队列填满后
+ *      上游会永远阻塞，因此 run() 在启动前检查，发现这样的阶段时抛出 std::logic_error。
+ *  4. 统计
+ *      每个阶段记录输入/输出条数、处理耗时(单条平均与最大值)、因下游队列满而阻塞的时间，
+ *      run() 结束后可用 report() 打印，或用 stats() 读取。
+ *
+ *  learning::pipeline pl;
+ *  pl.source<record_t>("read", [](learning::emitter<record_t> &out) { ... out(record); ... })
+ *    .transform<int>("age", 4, [](record_t &&r) { return r.first; })
+ *    .filter("adult", 2, [](const int &age) { return age >= 18; })
+ *    .sink("sum", 1, [&](int &&age) { total += age; });
+ *  pl.run();
+ * @version : 1.0
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c), Richard Wang.
+ *
+ */
+#ifndef PIPELINE_HPP
+#define PIPELINE_HPP
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <iomanip>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "../mpmc_queue/mpmc_queue.hpp"
+
+namespace learning
+{
+
+/**
+ * @brief 单个阶段的统计数据(多个线程共同累加)
+ */
+struct stage_stats
+{
+    std::string name;
+    std::size_t parallelism = 1;
+    std::atomic<uint64_t> items_in{0};
+    std::atomic<uint64_t> items_out{0};
+    std::atomic<uint64_t> busy_ns{0};         // 用户函数执行耗时之和
+    std::atomic<uint64_t> blocked_ns{0};      // 因下游队列满而阻塞的时间之和
+    std::atomic<uint64_t> max_latency_ns{0};  // 单条记录的最大处理耗时
+};
+
+namespace detail
+{
+
+typedef std::chrono::steady_clock pipeline_clock;
+
+inline uint64_t elapsed_ns(pipeline_clock::time_point begin, pipeline_clock::time_point end)
+{
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(end - begin).count());
+}
+
+/**
+ * @brief 线程本地累计，每处理 kFlushEvery 条或线程退出时合并到共享的 stage_stats，避免每条记录都写共享原子变量
+ */
+class local_stats
+{
+public:
+    explicit local_stats(stage_stats &shared) : shared_(shared), in_(0), out_(0), busy_(0), blocked_(0), max_(0) {}
+    ~local_stats() { flush(); }
+
+    void record_in() { ++in_; }
+    void record_out() { ++out_; }
+    void record_blocked(uint64_t ns) { blocked_ += ns; }
+
+    void record_busy(uint64_t ns)
+    {
+        busy_ += ns;
+        max_ = std::max(max_, ns);
+        if (in_ % kFlushEvery == 0)
+        {
+            flush();
+        }
+    }
+
+    void flush()
+    {
+        shared_.items_in += in_;
+        shared_.items_out += out_;
+        shared_.busy_ns += busy_;
+        shared_.blocked_ns += blocked_;
+        uint64_t cur = shared_.max_latency_ns.load();
+        while (max_ > cur && !shared_.max_latency_ns.compare_exchange_weak(cur, max_))
+        {
+        }
+        in_ = out_ = busy_ = blocked_ = 0;
+    }
+
+private:
+    static const uint64_t kFlushEvery = 256;
+    stage_stats &shared_;
+    uint64_t in_, out_, busy_, blocked_, max_;
+};
+
+/* 并行度为 0 的阶段没有线程，下游队列永远不会关闭，流水线结束时会一直等待 */
+inline void check_parallelism(std::size_t parallelism, const char *what)
+{
+    if (parallelism == 0)
+    {
+        throw std::invalid_argument(std::string("pipeline: ") + what + " parallelism must be at least 1");
+    }
+}
+
+struct stage_base
+{
+    virtual ~stage_base() {}
+    virtual void start() = 0;
+    virtual void join() = 0;
+    virtual void abort() = 0; // 关闭本阶段的输出队列
+};
+
+} // namespace detail
+
+template <class T>
+using pipeline_queue = mpmc_queue<T, futex_wait>;
+
+/**
+ * @brief source 阶段向下游发送记录的接口；返回 false 表示流水线已中止，source 应尽快返回
+ */
+template <class T>
+class emitter
+{
+public:
+    emitter(pipeline_queue<T> &out, detail::local_stats &stats) : out_(out), stats_(stats) {}
+
+    template <class U>
+    bool operator()(U &&value)
+    {
+        stats_.record_out();
+        detail::pipeline_clock::time_point begin = detail::pipeline_clock::now();
+        const bool ok = out_.push(std::forward<U>(value));
+        stats_.record_blocked(detail::elapsed_ns(begin, detail::pipeline_clock::now()));
+        return ok;
+    }
+
+private:
+    pipeline_queue<T> &out_;
+    detail::local_stats &stats_;
+};
+
+class pipeline;
+
+/**
+ * @brief 构造流水线时的中间结果，记录上一阶段的输出队列
+ */
+template <class T>
+class stage_builder
+{
+public:
+    stage_builder(pipeline &owner, std::shared_ptr<pipeline_queue<T>> queue) : owner_(owner), queue_(std::move(queue)) {}
+
+    /* f: U(T&&)；parallelism 为该阶段的线程数，为 0 时抛出 std::invalid_argument */
+    template <class U, class F>
+    stage_builder<U> transform(std::string name, std::size_t parallelism, F f);
+
+    /* pred: bool(const T&)，返回 false 的记录被丢弃 */
+    template <class Pred>
+    stage_builder<T> filter(std::string name, std::size_t parallelism, Pred pred);
+
+    /* f: void(T&&)，流水线的终点 */
+    template <class F>
+    void sink(std::string name, std::size_t parallelism, F f);
+
+private:
+    pipeline &owner_;
+    std::shared_ptr<pipeline_queue<T>> queue_;
+};
+
+class pipeline
+{
+public:
+    /**
+     * @brief queue_capacity 为阶段之间每个队列的容量(2的幂)，决定反压前能积压多少条记录
+     */
+    explicit pipeline(std::size_t queue_capacity = 1024) : queue_capacity_(queue_capacity), wall_ns_(0) {}
+
+    pipeline(const pipeline &) = delete;
+    pipeline &operator=(const pipeline &) = delete;
+
+    /**
+     * @brief 添加数据源；f 的形式为 void(emitter<T>&)
+     */
+    template <class T, class F>
+    stage_builder<T> source(std::string name, F f)
+    {
+        std::shared_ptr<pipeline_queue<T>> out = std::make_shared<pipeline_queue<T>>(queue_capacity_);
+        stage_stats &stats = add_stats(std::move(name), 1);
+        add_output_queue(stats, out.get());
+        pipeline *self = this;
+        add_stage(std::make_shared<pipeline::generic_stage>(
+            1, [self, out, f, &stats]() mutable
+            {
+                detail::local_stats local(stats);
+                emitter<T> emit(*out, local);
+                self->guard([&]()
+                            { f(emit); });
+            },
+            [out]()
+            { out->close(); }));
+        return stage_builder<T>(*this, out);
+    }
+
+    /**
+     * @brief 启动所有阶段并等待全部结束
+     */
+    void run()
+    {
+        for (const output_queue &q : outputs_)
+        {
+            if (!q.consumed)
+            {
+                throw std::logic_error("pipeline: output of stage '" + q.stage + "' has no consumer; end the pipeline with sink()");
+            }
+        }
+        detail::pipeline_clock::time_point begin = detail::pipeline_clock::now();
+        for (auto &stage : stages_)
+        {
+            stage->start();
+        }
+        for (auto &stage : stages_)
+        {
+            stage->join();
+        }
+        wall_ns_ = detail::elapsed_ns(begin, detail::pipeline_clock::now());
+        if (error_)
+        {
+            std::rethrow_exception(error_);
+        }
+    }
+
+    const std::vector<std::unique_ptr<stage_stats>> &stats() const { return stats_; }
+    uint64_t wall_ns() const { return wall_ns_; }
+
+    /**
+     * @brief 打印每个阶段的吞吐量、平均/最大处理耗时和阻塞时间
+     */
+    void report(std::ostream &os) const
+    {
+        const double wall_s = wall_ns_ > 0 ? wall_ns_ / 1e9 : 1.0;
+        os << std::left << std::setw(12) << "stage" << std::right << std::setw(4) << "par" << std::setw(12) << "in"
+           << std::setw(12) << "out" << std::setw(14) << "out/s" << std::setw(12) << "avg(ns)" << std::setw(12)
+           << "max(ns)" << std::setw(14) << "blocked(ms)" << std::endl;
+        for (const auto &s : stats_)
+        {
+            const uint64_t in = s->items_in.load();
+            os << std::left << std::setw(12) << s->name << std::right << std::setw(4) << s->parallelism
+               << std::setw(12) << in << std::setw(12) << s->items_out.load()
+               << std::setw(14) << static_cast<uint64_t>(s->items_out.load() / wall_s)
+               << std::setw(12) << (in > 0 ? s->busy_ns.load() / in : 0) << std::setw(12) << s->max_latency_ns.load()
+               << std::setw(14) << s->blocked_ns.load() / 1000000 << std::endl;
+        }
+    }
+
+private:
+    template <class T>
+    friend class stage_builder;
+
+    class generic_stage : public detail::stage_base
+    {
+    public:
+        generic_stage(std::size_t parallelism, std::function<void()> body, std::function<void()> close_output)
+            : parallelism_(parallelism), active_(0), body_(std::move(body)), close_output_(std::move(close_output)) {}
+
+        void start() override
+        {
+            active_ = parallelism_;
+            for (std::size_t i = 0; i < parallelism_; ++i)
+            {
+                threads_.emplace_back([this]()
+                                      {
+                                          body_();
+                                          /* 最后一个退出的线程负责通知下游结束 */
+                                          if (--active_ == 0)
+                                          {
+                                              close_output_();
+                                          }
+                                      });
+            }
+        }
+
+        void join() override
+        {
+            for (std::thread &t : threads_)
+            {
+                t.join();
+            }
+            threads_.clear();
+        }
+
+        void abort() override { close_output_(); }
+
+    private:
+        std::size_t parallelism_;
+        std::atomic<std::size_t> active_;
+        std::function<void()> body_;
+        std::function<void()> close_output_;
+        std::vector<std::thread> threads_;
+    };
+
+    stage_stats &add_stats(std::string name, std::size_t parallelism)
+    {
+        stats_.emplace_back(new stage_stats());
+        stats_.back()->name = std::move(name);
+        stats_.back()->parallelism = parallelism;
+        return *stats_.back();
+    }
+
+    void add_stage(std::shared_ptr<detail::stage_base> stage) { stages_.push_back(std::move(stage)); }
+
+    /* 阶段的输出队列；run() 要求每个输出队列都被某个下游阶段读取 */
+    struct output_queue
+    {
+        std::string stage;
+        const void *queue;
+        bool consumed;
+    };
+
+    void add_output_queue(const stage_stats &stats, const void *queue) { outputs_.push_back(output_queue{stats.name, queue, false}); }
+
+    /* 登记下游阶段的输入队列：出错时需要关闭它，同时标记对应的输出已有消费者 */
+    void add_input_queue(const void *queue, std::function<void()> close)
+    {
+        for (output_queue &q : outputs_)
+        {
+            if (q.queue == queue)
+            {
+                q.consumed = true;
+            }
+        }
+        input_closers_.push_back(std::move(close));
+    }
+
+    /* 执行 f，捕获异常后中止整条流水线 */
+    template <class F>
+    void guard(F f)
+    {
+        try
+        {
+            f();
+        }
+        catch (...)
+        {
+            {
+                std::lock_guard<std::mutex> lock(error_mutex_);
+                if (!error_)
+                {
+                    error_ = std::current_exception();
+                }
+            }
+            for (auto &stage : stages_)
+            {
+                stage->abort();
+            }
+            for (auto &close : input_closers_)
+            {
+                close();
+            }
+        }
+    }
+
+    /* 中间阶段与 sink 的通用工作循环：从 in 取记录，交给 handle 处理 */
+    template <class T, class Handle>
+    void consume(pipeline_queue<T> &in, stage_stats &stats, Handle handle)
+    {
+        detail::local_stats local(stats);
+        guard([&]()
+              {
+                  T item;
+                  while (in.pop(item))
+                  {
+                      local.record_in();
+                      detail::pipeline_clock::time_point begin = detail::pipeline_clock::now();
+                      handle(std::move(item), local, begin);
+                  }
+              });
+    }
+
+    std::size_t queue_capacity_;
+    std::vector<std::shared_ptr<detail::stage_base>> stages_;
+    std::vector<std::unique_ptr<stage_stats>> stats_;
+    std::vector<std::function<void()>> input_closers_;
+    std::vector<output_queue> outputs_;
+    std::mutex error_mutex_;
+    std::exception_ptr error_;
+    uint64_t wall_ns_;
+};
+
+template <class T>
+template <class U, class F>
+stage_builder<U> stage_builder<T>::transform(std::string name, std::size_t parallelism, F f)
+{
+    detail::check_parallelism(parallelism, "transform");
+    pipeline &owner = owner_;
+    std::shared_ptr<pipeline_queue<T>> in = queue_;
+    std::shared_ptr<pipeline_queue<U>> out = std::make_shared<pipeline_queue<U>>(owner.queue_capacity_);
+    stage_stats &stats = owner.add_stats(std::move(name), parallelism);
+    owner.add_output_queue(stats, out.get());
+    owner.add_input_queue(in.get(), [in]()
+                          { in->close(); });
+    owner.add_stage(std::make_shared<pipeline::generic_stage>(
+        parallelism, [&owner, in, out, f, &stats]()
+        {
+            F fn(f);
+            owner.consume(*in, stats, [&](T &&item, detail::local_stats &local, detail::pipeline_clock::time_point begin)
+                          {
+                              U result = fn(std::move(item));
+                              detail::pipeline_clock::time_point end = detail::pipeline_clock::now();
+                              local.record_busy(detail::elapsed_ns(begin, end));
+                              local.record_out();
+                              out->push(std::move(result));
+                              local.record_blocked(detail::elapsed_ns(end, detail::pipeline_clock::now()));
+                          });
+        },
+        [out]()
+        { out->close(); }));
+    return stage_builder<U>(owner, out);
+}
+
+template <class T>
+template <class Pred>
+stage_builder<T> stage_builder<T>::filter(std::string name, std::size_t parallelism, Pred pred)
+{
+    detail::check_parallelism(parallelism, "filter");
+    pipeline &owner = owner_;
+    std::shared_ptr<pipeline_queue<T>> in = queue_;
+    std::shared_ptr<pipeline_queue<T>> out = std::make_shared<pipeline_queue<T>>(owner.queue_capacity_);
+    stage_stats &stats = owner.add_stats(std::move(name), parallelism);
+    owner.add_output_queue(stats, out.get());
+    owner.add_input_queue(in.get(), [in]()
+                          { in->close(); });
+    owner.add_stage(std::make_shared<pipeline::generic_stage>(
+        parallelism, [&owner, in, out, pred, &stats]()
+        {
+            Pred fn(pred);
+            owner.consume(*in, stats, [&](T &&item, detail::local_stats &local, detail::pipeline_clock::time_point begin)
+                          {
+                              const bool keep = fn(static_cast<const T &>(item));
+                              detail::pipeline_clock::time_point end = detail::pipeline_clock::now();
+                              local.record_busy(detail::elapsed_ns(begin, end));
+                              if (keep)
+                              {
+                                  local.record_out();
+                                  out->push(std::move(item));
+                                  local.record_blocked(detail::elapsed_ns(end, detail::pipeline_clock::now()));
+                              }
+                          });
+        },
+        [out]()
+        { out->close(); }));
+    return stage_builder<T>(owner, out);
+}
+
+template <class T>
+template <class F>
+void stage_builder<T>::sink(std::string name, std::size_t parallelism, F f)
+{
+    detail::check_parallelism(parallelism, "sink");
+    pipeline &owner = owner_;
+    std::shared_ptr<pipeline_queue<T>> in = queue_;
+    stage_stats &stats = owner.add_stats(std::move(name), parallelism);
+    owner.add_input_queue(in.get(), [in]()
+                          { in->close(); });
+    owner.add_stage(std::make_shared<pipeline::generic_stage>(
+        parallelism, [&owner, in, f, &stats]()
+        {
+            F fn(f);
+            owner.consume(*in, stats, [&](T &&item, detail::local_stats &local, detail::pipeline_clock::time_point begin)
+                          {
+                              fn(std::move(item));
+                              local.record_busy(detail::elapsed_ns(begin, detail::pipeline_clock::now()));
+                              local.record_out();
+                          });
+        },
+        []() {}));
+}
+
+} // namespace learning
+
+#endif // PIPELINE_HPP
@@ -0,0 +1,132 @@
+/**
+ * @file pipeline_test.cpp
+ * @author Richard Wang
+ * @brief 多阶段流水线示例
+ *  tie_test() 中的 解析 -> 解包 -> 打印 原本在一个线程里顺序完成，这里拆成流水线：
+ *      source    : 生成 "日期,月份,国家" 格式的文本行
+ *      parse     : 4个线程把文本解析成 std::tuple<int, std::string, std::string>
+ *      filter    : 2个线程过滤掉日期大于 28 的记录
+ *      sink      : 1个线程用 std::tie 解包并按国家统计
+ *  最后打印每个阶段的统计数据；sink 故意放慢，可以看到上游阶段的 blocked(ms) 明显增加(反压)。
+ *
+ * 编译: g++ -std=c++14 -O2 -pthread pipeline_test.cpp -o pipeline_test
+ * @version : 1.0
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c), Richard Wang.
+ *
+ */
+
+#include <iostream>
+#include <map>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <tuple>
+
+#include "pipeline.hpp"
+
+typedef std::tuple<int, std::string, std::string> info_t;
+
+/**
+ * @brief 解析 -> 过滤 -> 统计
+ */
+void etl_test()
+{
+    std::cout << "------------- test etl pipeline ------------------" << std::endl;
+    const char *months[] = {"Feb", "Jun", "March", "Dec"};
+    const char *countries[] = {"China", "America", "English", "France"};
+    std::map<std::string, int> country_count;
+
+    learning::pipeline pl(256);
+    pl.source<std::string>("source", [&](learning::emitter<std::string> &emit)
+                           {
+                               for (int i = 0; i < 200000; ++i)
+                               {
+                                   std::ostringstream line;
+                                   line << (i % 31 + 1) << "," << months[i % 4] << "," << countries[(i / 4) % 4];
+                                   if (!emit(line.str()))
+                                   {
+                                       return;
+                                   }
+                               }
+                           })
+        .transform<info_t>("parse", 4, [](std::string &&line)
+                           {
+                               std::istringstream in(line);
+                               std::string date, month, country;
+                               std::getline(in, date, ',');
+                               std::getline(in, month, ',');
+                               std::getline(in, country, ',');
+                               return info_t(std::stoi(date), month, country);
+                           })
+        .filter("filter", 2, [](const info_t &info)
+                { return std::get<0>(info) <= 28; })
+        .sink("sink", 1, [&country_count](info_t &&info)
+              {
+                  int i_date;
+                  std::string str_month;
+                  std::string str_country;
+                  std::tie(i_date, str_month, str_country) = info;
+                  ++country_count[str_country];
+                  /* 模拟较慢的下游 */
+                  volatile int spin = 0;
+                  for (int i = 0; i < 500; ++i)
+                  {
+                      spin = spin + i;
+                  }
+              });
+    pl.run();
+
+    for (const auto &kv : country_count)
+    {
+        std::cout << kv.first << ": " << kv.second << std::endl;
+    }
+    pl.report(std::cout);
+}
+
+/**
+ * @brief 某一阶段抛出异常时整条流水线停止，run() 重新抛出该异常
+ */
+void error_test()
+{
+    std::cout << "------------- test error ------------------" << std::endl;
+    learning::pipeline pl;
+    pl.source<int>("source", [](learning::emitter<int> &emit)
+                   {
+                       for (int i = 0; emit(i); ++i)
+                       {
+                       }
+                   })
+        .transform<int>("check", 2, [](int &&v)
+                        {
+                            if (v == 10000)
+                            {
+                                throw std::runtime_error("bad record 10000");
+                            }
+                            return v;
+                        })
+        .sink("sink", 1, [](int &&) {});
+
+    try
+    {
+        pl.run();
+    }
+    catch (const std::exception &e)
+    {
+        std::cout << "pipeline stopped: " << e.what() << std::endl;
+    }
+}
+
+int main()
+{
+    /******************** etl_test() ****************/
+    etl_test();
+    /************************************************/
+
+    /******************* error_test() ***************/
+    error_test();
+    /************************************************/
+
+    return 0;
+}
@@ -0,0 +1,625 @@
+/**
+ * @file query_engine.hpp
+ * @author Richard Wang
+ * @brief 列式存储 + 按批向量化执行的小型查询引擎：过滤、投影、分组聚合
+ *  1. column_table<Ts...>
+ *      每个字段一个 std::vector，可以从 std::list / std::vector 中的 tuple、pair 记录构造；
+ *      只读取查询用到的列，不会把整条记录(包括 std::string)拉进缓存。
+ *  2. 按批执行与选择向量
+ *      每次处理 1024 行，选择向量保存这一批中仍然满足条件的行号(uint16_t)；
+ *      每个过滤条件只对选择向量中的行求值，并原地压缩选择向量(无分支写法：先写入，再按条件推进下标)；
+ *      第一个过滤条件直接顺序读取列数据，不经过选择向量。过滤条件是按批调用的，每批一次间接调用，开销被 1024 行均摊。
+ *  3. 过滤
+ *      where<I>(compare_op::gt, 20)             列与常量比较；
+ *      where<I, J...>(pred)                     pred 接收这些列的值；where(pred) 接收整行所有列的值。
+ *  4. 投影 select<I...>() 把满足条件的行的指定列复制到新的 column_table。
+ *  5. 分组聚合 group_by<K...>().aggregate(agg::count(), agg::sum<I>(), agg::min<I>(), agg::max<I>())
+ *      每批先用 flat_hash_map 把分组键映射为分组号(只有新分组才复制键)，再由每个聚合函数对分组号数组做一次紧凑的循环；
+ *      结果是 column_table<键..., 聚合结果...>，按分组首次出现的顺序排列；aggregate(...) 不分组，结果只有一行。
+ *      sum 的结果类型：整数为 int64_t / uint64_t，浮点为 double；count 为 uint64_t；min / max 与列类型相同。
+ *
+ *  learning::column_table<int, std::string, int> users(userList.begin(), userList.end());
+ *  auto by_age = learning::from(users)
+ *                    .where<2>(learning::compare_op::ge, 170)
+ *                    .group_by<0>()
+ *                    .aggregate(learning::agg::count(), learning::agg::max<2>());
+ * @version : 1.0
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c), Richard Wang.
+ *
+ */
+#ifndef QUERY_ENGINE_HPP
+#define QUERY_ENGINE_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <initializer_list>
+#include <ostream>
+#include <stdexcept>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "../flat_hash_map/flat_hash_map.hpp"
+
+namespace learning
+{
+
+static const std::size_t kQueryBatch = 1024;
+
+enum class compare_op
+{
+    eq,
+    ne,
+    lt,
+    le,
+    gt,
+    ge
+};
+
+/**
+ * @brief 列式表：每个字段一个 vector
+ */
+template <class... Ts>
+class column_table
+{
+public:
+    typedef std::tuple<Ts...> row_type;
+    static const std::size_t column_count = sizeof...(Ts);
+
+    template <std::size_t I>
+    using column_type = typename std::tuple_element<I, row_type>::type;
+
+    column_table() = default;
+
+    /* 从 tuple / pair 记录区间构造 */
+    template <class InputIt>
+    column_table(InputIt first, InputIt last)
+    {
+        for (; first != last; ++first)
+        {
+            push_row(*first);
+        }
+    }
+
+    template <class Row>
+    void push_row(const Row &r)
+    {
+        push_row(r, std::index_sequence_for<Ts...>());
+    }
+
+    template <class... Us>
+    void append(Us &&...values)
+    {
+        static_assert(sizeof...(Us) == sizeof...(Ts), "column_table::append: one value per column");
+        append_values(std::index_sequence_for<Ts...>(), std::forward<Us>(values)...);
+    }
+
+    void reserve(std::size_t n)
+    {
+        reserve(n, std::index_sequence_for<Ts...>());
+    }
+
+    std::size_t size() const { return std::get<0>(columns_).size(); }
+    bool empty() const { return size() == 0; }
+
+    template <std::size_t I>
+    const std::vector<column_type<I>> &column() const { return std::get<I>(columns_); }
+
+    template <std::size_t I>
+    std::vector<column_type<I>> &column() { return std::get<I>(columns_); }
+
+    row_type row(std::size_t i) const { return row(i, std::index_sequence_for<Ts...>()); }
+
+private:
+    template <class Row, std::size_t... I>
+    void push_row(const Row &r, std::index_sequence<I...>)
+    {
+        using std::get;
+        int dummy[] = {0, (std::get<I>(columns_).push_back(get<I>(r)), 0)...};
+        (void)dummy;
+    }
+
+    template <std::size_t... I, class... Us>
+    void append_values(std::index_sequence<I...>, Us &&...values)
+    {
+        int dummy[] = {0, (std::get<I>(columns_).push_back(std::forward<Us>(values)), 0)...};
+        (void)dummy;
+    }
+
+    template <std::size_t... I>
+    void reserve(std::size_t n, std::index_sequence<I...>)
+    {
+        int dummy[] = {0, (std::get<I>(columns_).reserve(n), 0)...};
+        (void)dummy;
+    }
+
+    template <std::size_t... I>
+    row_type row(std::size_t i, std::index_sequence<I...>) const { return row_type(std::get<I>(columns_)[i]...); }
+
+    std::tuple<std::vector<Ts>...> columns_;
+};
+
+template <class... Ts>
+const std::size_t column_table<Ts...>::column_count;
+
+/**
+ * @brief 一批中仍然有效的行号(相对于批起点)
+ */
+struct selection_vector
+{
+    uint16_t index[kQueryBatch];
+    std::size_t size;
+    bool dense; // 为 true 时选中的就是 [0, size) 全部行，index 尚未填写
+
+    void reset(std::size_t n)
+    {
+        size = n;
+        dense = true;
+    }
+
+    /* 把稠密状态展开成显式的行号 */
+    void materialize()
+    {
+        if (dense)
+        {
+            for (std::size_t i = 0; i < size; ++i)
+            {
+                index[i] = static_cast<uint16_t>(i);
+            }
+            dense = false;
+        }
+    }
+};
+
+/**
+ * @brief 一批数据：[offset, offset + length) 范围内被选择向量选中的行
+ */
+template <class Table>
+struct batch_view
+{
+    const Table *table;
+    std::size_t offset;
+    std::size_t length;
+    const selection_vector *sel;
+
+    template <std::size_t I>
+    const typename Table::template column_type<I> *column() const { return table->template column<I>().data() + offset; }
+};
+
+namespace agg
+{
+
+struct count
+{
+};
+
+template <std::size_t I>
+struct sum
+{
+};
+
+template <std::size_t I>
+struct min
+{
+};
+
+template <std::size_t I>
+struct max
+{
+};
+
+} // namespace agg
+
+namespace detail
+{
+
+/* 无分支压缩：每行都写入，条件成立时才推进输出下标 */
+template <class T, class Pred>
+void filter_column(const T *col, selection_vector &sel, Pred pred)
+{
+    std::size_t out = 0;
+    if (sel.dense)
+    {
+        for (std::size_t i = 0; i < sel.size; ++i)
+        {
+            sel.index[out] = static_cast<uint16_t>(i);
+            out += pred(col[i]) ? 1 : 0;
+        }
+        sel.dense = false;
+    }
+    else
+    {
+        for (std::size_t i = 0; i < sel.size; ++i)
+        {
+            const uint16_t r = sel.index[i];
+            sel.index[out] = r;
+            out += pred(col[r]) ? 1 : 0;
+        }
+    }
+    sel.size = out;
+}
+
+template <class T, class V>
+void filter_compare(const T *col, selection_vector &sel, compare_op op, const V &v)
+{
+    switch (op)
+    {
+    case compare_op::eq:
+        filter_column(col, sel, [&v](const T &x) { return x == v; });
+        break;
+    case compare_op::ne:
+        filter_column(col, sel, [&v](const T &x) { return x != v; });
+        break;
+    case compare_op::lt:
+        filter_column(col, sel, [&v](const T &x) { return x < v; });
+        break;
+    case compare_op::le:
+        filter_column(col, sel, [&v](const T &x) { return x <= v; });
+        break;
+    case compare_op::gt:
+        filter_column(col, sel, [&v](const T &x) { return x > v; });
+        break;
+    case compare_op::ge:
+        filter_column(col, sel, [&v](const T &x) { return x >= v; });
+        break;
+    }
+}
+
+template <class Table, class Pred, std::size_t... I>
+void filter_rows(const batch_view<Table> &b, selection_vector &sel, const Pred &pred, std::index_sequence<I...>)
+{
+    sel.materialize();
+    std::size_t out = 0;
+    for (std::size_t i = 0; i < sel.size; ++i)
+    {
+        const uint16_t r = sel.index[i];
+        sel.index[out] = r;
+        out += pred(b.template column<I>()[r]...) ? 1 : 0;
+    }
+    sel.size = out;
+}
+
+template <class T>
+void gather(std::vector<T> &out, const T *col, const selection_vector &sel)
+{
+    for (std::size_t i = 0; i < sel.size; ++i)
+    {
+        out.push_back(col[sel.index[i]]);
+    }
+}
+
+template <class Tag, class Table>
+struct aggregator;
+
+template <class Table>
+struct aggregator<agg::count, Table>
+{
+    typedef uint64_t result_type;
+    std::vector<result_type> values;
+
+    void resize(std::size_t groups) { values.resize(groups, 0); }
+
+    void update(const batch_view<Table> &b, const uint32_t *gid)
+    {
+        for (std::size_t i = 0; i < b.sel->size; ++i)
+        {
+            ++values[gid[i]];
+        }
+    }
+};
+
+template <std::size_t I, class Table>
+struct aggregator<agg::sum<I>, Table>
+{
+    typedef typename Table::template column_type<I> value_type;
+    static_assert(std::is_arithmetic<value_type>::value, "agg::sum requires an arithmetic column");
+    typedef typename std::conditional<std::is_floating_point<value_type>::value, double,
+                                      typename std::conditional<std::is_signed<value_type>::value, int64_t, uint64_t>::type>::type result_type;
+    std::vector<result_type> values;
+
+    void resize(std::size_t groups) { values.resize(groups, 0); }
+
+    void update(const batch_view<Table> &b, const uint32_t *gid)
+    {
+        const value_type *col = b.template column<I>();
+        for (std::size_t i = 0; i < b.sel->size; ++i)
+        {
+            values[gid[i]] += col[b.sel->index[i]];
+        }
+    }
+};
+
+template <std::size_t I, class Table, class Better>
+struct extreme_aggregator
+{
+    typedef typename Table::template column_type<I> result_type;
+    std::vector<result_type> values;
+    std::vector<char> seen;
+
+    void resize(std::size_t groups)
+    {
+        values.resize(groups);
+        seen.resize(groups, 0);
+    }
+
+    void update(const batch_view<Table> &b, const uint32_t *gid)
+    {
+        const result_type *col = b.template column<I>();
+        Better better;
+        for (std::size_t i = 0; i < b.sel->size; ++i)
+        {
+            const result_type &v = col[b.sel->index[i]];
+            const uint32_t g = gid[i];
+            if (!seen[g] || better(v, values[g]))
+            {
+                values[g] = v;
+                seen[g] = 1;
+            }
+        }
+    }
+};
+
+template <std::size_t I, class Table>
+struct aggregator<agg::min<I>, Table> : extreme_aggregator<I, Table, std::less<typename Table::template column_type<I>>>
+{
+};
+
+template <std::size_t I, class Table>
+struct aggregator<agg::max<I>, Table> : extreme_aggregator<I, Table, std::greater<typename Table::template column_type<I>>>
+{
+};
+
+template <class Table, class Keys, class... Aggs>
+struct aggregate_result;
+
+template <class Table, std::size_t... K, class... Aggs>
+struct aggregate_result<Table, std::index_sequence<K...>, Aggs...>
+{
+    typedef column_table<typename Table::template column_type<K>..., typename aggregator<Aggs, Table>::result_type...> type;
+};
+
+} // namespace detail
+
+template <class Table, std::size_t... K>
+class grouped_query;
+
+/**
+ * @brief 对一张 column_table 的查询；过滤条件按批执行
+ */
+template <class... Ts>
+class query
+{
+public:
+    typedef column_table<Ts...> table_type;
+    typedef batch_view<table_type> batch_type;
+    typedef std::function<void(const batch_type &, selection_vector &)> filter_type;
+
+    explicit query(const table_type &table) : table_(&table) {}
+
+    /* 列 I 与常量比较 */
+    template <std::size_t I, class V>
+    query &where(compare_op op, const V &value)
+    {
+        typedef typename table_type::template column_type<I> column_type;
+        const column_type v(value);
+        filters_.push_back([op, v](const batch_type &b, selection_vector &sel)
+                           { detail::filter_compare(b.template column<I>(), sel, op, v); });
+        return *this;
+    }
+
+    /* pred 接收列 I... 的值；不给出列时接收整行 */
+    template <std::size_t... I, class Pred>
+    query &where(Pred pred)
+    {
+        add_filter(pred, typename std::conditional<sizeof...(I) == 0, std::index_sequence_for<Ts...>, std::index_sequence<I...>>::type());
+        return *this;
+    }
+
+    /* 对每个非空的批调用 f(const batch_view &)，选择向量已经展开为显式行号 */
+    template <class F>
+    void for_each_batch(F f) const
+    {
+        selection_vector sel;
+        const std::size_t n = table_->size();
+        for (std::size_t offset = 0; offset < n; offset += kQueryBatch)
+        {
+            batch_type b{table_, offset, std::min(kQueryBatch, n - offset), &sel};
+            sel.reset(b.length);
+            for (const filter_type &filter : filters_)
+            {
+                filter(b, sel);
+                if (sel.size == 0)
+                {
+                    break;
+                }
+            }
+            if (sel.size != 0)
+            {
+                sel.materialize();
+                f(static_cast<const batch_type &>(b));
+            }
+        }
+    }
+
+    std::size_t count() const
+    {
+        std::size_t total = 0;
+        for_each_batch([&total](const batch_type &b)
+                       { total += b.sel->size; });
+        return total;
+    }
+
+    /* 投影：满足条件的行的列 I... */
+    template <std::size_t... I>
+    column_table<typename table_type::template column_type<I>...> select() const
+    {
+        column_table<typename table_type::template column_type<I>...> out;
+        for_each_batch([&out](const batch_type &b)
+                       { project(out, b, std::index_sequence<I...>(), std::make_index_sequence<sizeof...(I)>()); });
+        return out;
+    }
+
+    template <std::size_t... K>
+    grouped_query<table_type, K...> group_by() const { return grouped_query<table_type, K...>(*this); }
+
+    /* 不分组的聚合，结果只有一行 */
+    template <class... Aggs>
+    typename detail::aggregate_result<table_type, std::index_sequence<>, Aggs...>::type aggregate(Aggs... aggs) const
+    {
+        return group_by<>().aggregate(aggs...);
+    }
+
+private:
+    template <class Pred, std::size_t... I>
+    void add_filter(Pred pred, std::index_sequence<I...>)
+    {
+        filters_.push_back([pred](const batch_type &b, selection_vector &sel)
+                           { detail::filter_rows(b, sel, pred, std::index_sequence<I...>()); });
+    }
+
+    template <class Out, std::size_t... I, std::size_t... J>
+    static void project(Out &out, const batch_type &b, std::index_sequence<I...>, std::index_sequence<J...>)
+    {
+        int dummy[] = {0, (detail::gather(out.template column<J>(), b.template column<I>(), *b.sel), 0)...};
+        (void)dummy;
+    }
+
+    const table_type *table_;
+    std::vector<filter_type> filters_;
+};
+
+/**
+ * @brief 按列 K... 分组的查询
+ */
+template <class... Ts, std::size_t... K>
+class grouped_query<column_table<Ts...>, K...>
+{
+public:
+    typedef column_table<Ts...> table_type;
+    typedef batch_view<table_type> batch_type;
+    typedef std::tuple<typename table_type::template column_type<K>...> key_type;
+
+    explicit grouped_query(const query<Ts...> &q) : query_(q) {}
+
+    template <class... Aggs>
+    typename detail::aggregate_result<table_type, std::index_sequence<K...>, Aggs...>::type aggregate(Aggs...) const
+    {
+        std::tuple<detail::aggregator<Aggs, table_type>...> states;
+        std::vector<key_type> keys;
+        flat_hash_map<key_type, uint32_t> groups;
+        uint32_t gid[kQueryBatch];
+
+        if (sizeof...(K) == 0)
+        {
+            keys.emplace_back(); // 不分组时总有一行结果(例如 count 为 0)
+        }
+        query_.for_each_batch([&](const batch_type &b)
+                              {
+                                  assign_groups(b, gid, groups, keys, std::integral_constant<bool, sizeof...(K) == 0>());
+                                  update_all(states, b, gid, keys.size(), std::index_sequence_for<Aggs...>());
+                              });
+        update_all(states, batch_type{nullptr, 0, 0, nullptr}, gid, keys.size(), std::index_sequence_for<Aggs...>());
+
+        typename detail::aggregate_result<table_type, std::index_sequence<K...>, Aggs...>::type out;
+        out.reserve(keys.size());
+        for (std::size_t g = 0; g < keys.size(); ++g)
+        {
+            out.push_row(std::tuple_cat(keys[g], results(states, g, std::index_sequence_for<Aggs...>())));
+        }
+        return out;
+    }
+
+private:
+    static void assign_groups(const batch_type &b, uint32_t *gid, flat_hash_map<key_type, uint32_t> &, std::vector<key_type> &, std::true_type)
+    {
+        std::fill(gid, gid + b.sel->size, 0u);
+    }
+
+    /* 用键列的引用元组查找(异构查找)，只有新分组才复制键 */
+    static void assign_groups(const batch_type &b, uint32_t *gid, flat_hash_map<key_type, uint32_t> &groups, std::vector<key_type> &keys,
+                              std::false_type)
+    {
+        for (std::size_t i = 0; i < b.sel->size; ++i)
+        {
+            const uint16_t r = b.sel->index[i];
+            auto res = groups.try_emplace(std::forward_as_tuple(b.template column<K>()[r]...), static_cast<uint32_t>(keys.size()));
+            if (res.second)
+            {
+                keys.emplace_back(b.template column<K>()[r]...);
+            }
+            gid[i] = res.first->second;
+        }
+    }
+
+    /* b.table 为空时只调整分组数(用于最后一批之后) */
+    template <class States, std::size_t... A>
+    static void update_all(States &states, const batch_type &b, const uint32_t *gid, std::size_t groups, std::index_sequence<A...>)
+    {
+        int dummy[] = {0, (std::get<A>(states).resize(groups), b.table != nullptr ? std::get<A>(states).update(b, gid) : (void)0, 0)...};
+        (void)dummy;
+    }
+
+    template <class States, std::size_t... A>
+    static auto results(const States &states, std::size_t g, std::index_sequence<A...>)
+    {
+        return std::make_tuple(std::get<A>(states).values[g]...);
+    }
+
+    query<Ts...> query_;
+};
+
+template <class... Ts>
+query<Ts...> from(const column_table<Ts...> &table)
+{
+    return query<Ts...>(table);
+}
+
+namespace detail
+{
+
+template <class Table, std::size_t... I>
+void write_row(std::ostream &os, const Table &t, std::size_t r, std::index_sequence<I...>)
+{
+    const char *sep = "";
+    int dummy[] = {0, (os << sep << t.template column<I>()[r], sep = " | ", 0)...};
+    (void)dummy;
+}
+
+} // namespace detail
+
+/**
+ * @brief 打印表格，最多 max_rows 行
+ */
+template <class... Ts>
+void write_table(std::ostream &os, const column_table<Ts...> &t, std::initializer_list<const char *> names, std::size_t max_rows = 20)
+{
+    if (names.size() != sizeof...(Ts))
+    {
+        throw std::invalid_argument("write_table: one name per column is required");
+    }
+    const char *sep = "";
+    for (const char *name : names)
+    {
+        os << sep << name;
+        sep = " | ";
+    }
+    os << std::endl;
+    for (std::size_t r = 0; r < t.size() && r < max_rows; ++r)
+    {
+        detail::write_row(os, t, r, std::index_sequence_for<Ts...>());
+        os << std::endl;
+    }
+    if (t.size() > max_rows)
+    {
+        os << "... (" << t.size() << " rows)" << std::endl;
+    }
+}
+
+} // namespace learning
+
+#endif // QUERY_ENGINE_HPP
@@ -0,0 +1,188 @@
+/**
+ * @file query_engine_test.cpp
+ * @author Richard Wang
+ * @brief 查询引擎示例
+ *  1. tuple_test() 中的 (年龄, 姓名, 身高) 记录转成列式表，按条件过滤并投影；
+ *  2. 按年龄、按姓名分组统计人数、身高总和、最矮和最高，以及不分组的聚合；结果与逐行计算对照；
+ *  3. 基准：100 万条记录，逐行遍历 std::list<tuple> + unordered_map 与按批执行的查询对比。
+ *
+ * 编译: g++ -std=c++14 -O2 query_engine_test.cpp -o query_engine_test
+ * @version : 1.0
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c), Richard Wang.
+ *
+ */
+
+#include <iostream>
+#include <algorithm>
+#include <list>
+#include <string>
+#include <tuple>
+#include <unordered_map>
+#include <vector>
+
+#include "../benchmark/benchmark.hpp"
+#include "query_engine.hpp"
+
+typedef std::tuple<int, std::string, int> user_t; // (年龄, 姓名, 身高)
+typedef learning::column_table<int, std::string, int> user_table;
+
+static const char *kNames[] = {"Richard", "Jack", "Simth", "Mark", "Rose", "Jim", "Amy", "Lucy"};
+
+static std::list<user_t> make_users(std::size_t n)
+{
+    std::list<user_t> users;
+    for (std::size_t i = 0; i < n; ++i)
+    {
+        users.emplace_back(18 + static_cast<int>(i * 7 % 43), kNames[i * 13 % 8], 150 + static_cast<int>(i * 11 % 50));
+    }
+    return users;
+}
+
+/**
+ * @brief 过滤与投影
+ */
+void filter_test()
+{
+    std::cout << "------------- test filter / select ------------------" << std::endl;
+    std::list<user_t> userList;
+    userList.emplace_back(26, "Richard", 178);
+    userList.emplace_back(29, "Jack", 180);
+    userList.emplace_back(25, "Simth", 191);
+    userList.emplace_back(31, "Rose", 165);
+    user_table users(userList.begin(), userList.end());
+
+    learning::write_table(std::cout, learning::from(users).where<0>(learning::compare_op::gt, 25).select<1, 0>(), {"name", "age"});
+    learning::write_table(std::cout,
+                          learning::from(users)
+                              .where<1>([](const std::string &name)
+                                        { return name.find('R') == 0; })
+                              .select<1, 2>(),
+                          {"name", "height"});
+    learning::write_table(std::cout,
+                          learning::from(users)
+                              .where([](int age, const std::string &, int height)
+                                     { return height - age > 150; })
+                              .select<0, 1, 2>(),
+                          {"age", "name", "height"});
+}
+
+/**
+ * @brief 分组聚合
+ */
+void group_test()
+{
+    std::cout << "------------- test group by ------------------" << std::endl;
+    std::list<user_t> userList = make_users(100000);
+    user_table users(userList.begin(), userList.end());
+
+    auto by_name = learning::from(users)
+                       .where<0>(learning::compare_op::ge, 30)
+                       .group_by<1>()
+                       .aggregate(learning::agg::count(), learning::agg::sum<2>(), learning::agg::min<2>(), learning::agg::max<2>());
+    learning::write_table(std::cout, by_name, {"name", "count", "sum(height)", "min(height)", "max(height)"});
+
+    auto total = learning::from(users).aggregate(learning::agg::count(), learning::agg::sum<0>(), learning::agg::max<1>());
+    learning::write_table(std::cout, total, {"count", "sum(age)", "max(name)"});
+
+    auto none = learning::from(users).where<0>(learning::compare_op::lt, 0).aggregate(learning::agg::count());
+    std::cout << "count where age < 0: " << none.column<0>()[0] << std::endl;
+
+    /* 逐行计算同样的分组结果作对照 */
+    std::unordered_map<std::string, std::tuple<uint64_t, int64_t>> expected;
+    for_each(userList.begin(), userList.end(), [&expected](const user_t &u)
+             {
+                 if (std::get<0>(u) >= 30)
+                 {
+                     std::tuple<uint64_t, int64_t> &e = expected[std::get<1>(u)];
+                     ++std::get<0>(e);
+                     std::get<1>(e) += std::get<2>(u);
+                 }
+             });
+    bool match = expected.size() == by_name.size();
+    for (std::size_t g = 0; g < by_name.size(); ++g)
+    {
+        const std::tuple<uint64_t, int64_t> &e = expected[by_name.column<0>()[g]];
+        match = match && std::get<0>(e) == by_name.column<1>()[g] && std::get<1>(e) == by_name.column<2>()[g];
+    }
+    std::cout << "matches row-by-row result: " << std::boolalpha << match << std::endl;
+}
+
+/**
+ * @brief 逐行遍历与按批查询
+ */
+void benchmark_test()
+{
+    std::cout << "------------- test benchmark ------------------" << std::endl;
+    const std::list<user_t> userList = make_users(1000000);
+    const user_table users(userList.begin(), userList.end());
+
+    learning::benchmark_options options;
+    options.max_time_ms = 2000;
+    learning::benchmark_runner runner(options);
+    runner.add("group_by_age/row_by_row_list", [&userList](learning::benchmark_state &state)
+               {
+                   while (state.keep_running())
+                   {
+                       std::unordered_map<int, std::tuple<uint64_t, int64_t, int>> groups;
+                       for_each(userList.begin(), userList.end(), [&groups](const user_t &u)
+                                {
+                                    if (std::get<2>(u) >= 170)
+                                    {
+                                        std::tuple<uint64_t, int64_t, int> &g = groups[std::get<0>(u)];
+                                        ++std::get<0>(g);
+                                        std::get<1>(g) += std::get<2>(u);
+                                        std::get<2>(g) = std::max(std::get<2>(g), std::get<2>(u));
+                                    }
+                                });
+                       learning::do_not_optimize(groups);
+                   }
+               });
+    runner.add("group_by_age/batched_columns", [&users](learning::benchmark_state &state)
+               {
+                   while (state.keep_running())
+                   {
+                       auto groups = learning::from(users)
+                                         .where<2>(learning::compare_op::ge, 170)
+                                         .group_by<0>()
+                                         .aggregate(learning::agg::count(), learning::agg::sum<2>(), learning::agg::max<2>());
+                       learning::do_not_optimize(groups);
+                   }
+               });
+    runner.add("filter_count/row_by_row_list", [&userList](learning::benchmark_state &state)
+               {
+                   while (state.keep_running())
+                   {
+                       std::size_t n = std::count_if(userList.begin(), userList.end(), [](const user_t &u)
+                                                     { return std::get<0>(u) > 40 && std::get<2>(u) < 160; });
+                       learning::do_not_optimize(n);
+                   }
+               });
+    runner.add("filter_count/batched_columns", [&users](learning::benchmark_state &state)
+               {
+                   while (state.keep_running())
+                   {
+                       std::size_t n = learning::from(users).where<0>(learning::compare_op::gt, 40).where<2>(learning::compare_op::lt, 160).count();
+                       learning::do_not_optimize(n);
+                   }
+               });
+    runner.run(std::cout);
+}
+
+int main()
+{
+    /******************** filter_test() *************/
+    filter_test();
+    /************************************************/
+
+    /********************* group_test() *************/
+    group_test();
+    /************************************************/
+
+    /****************** benchmark_test() ************/
+    benchmark_test();
+    /************************************************/
+
+    return 0;
+}
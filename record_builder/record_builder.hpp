@@ -0,0 +1,177 @@
+/**
+ * @file record_builder.hpp
+ * @author Richard Wang
+ * @brief 原地构造 pair / tuple 记录，避免 emplace_back(左值) 带来的整条记录复制
+ *  1. 问题
+ *      info_list.emplace_back(p1) 中 p1 是左值，emplace_back 只能调用拷贝构造，p1 里的字符串被完整复制一次；
+ *      push_back(std::make_tuple(...)) 先构造临时对象再移动，多一次移动。
+ *  2. emplace_record(c, args...)
+ *      把参数原样转发给 emplace_back，记录直接在容器里构造；
+ *      如果传入的是记录类型本身的左值(也就是会发生整条复制)，编译期报错，需要写成 std::move(r) 或 copy_record(r)。
+ *  3. emplace_record(c, std::piecewise_construct, std::forward_as_tuple(...), ...)
+ *      每个字段各用一组参数原地构造：pair 直接使用 pair 的 piecewise 构造函数；
+ *      std::tuple 没有 piecewise 构造函数，这里给每个字段包一个 "延迟构造器"，由 tuple 的逐元素构造函数取出字段值。
+ *      C++17 起字段由构造器的返回值直接初始化(保证的复制消除)；C++14 下标准允许每个字段多一次移动(GCC 通常也会省略)，但都不会复制。
+ *  4. make_record<R>(std::piecewise_construct, ...) 以同样方式返回一条记录。
+ *
+ *  std::vector<std::pair<int, std::string>> info_list;
+ *  learning::emplace_record(info_list, 12, "Mark");                       // 等价于 emplace_back，但拒绝左值记录
+ *  learning::emplace_record(info_list, std::piecewise_construct,
+ *                           std::forward_as_tuple(14), std::forward_as_tuple(4, 'R'));
+ *  learning::emplace_record(info_list, p1);                               // 编译错误：会复制 p1
+ *  learning::emplace_record(info_list, learning::copy_record(p1));        // 明确要复制时这样写
+ * @version : 1.0
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c), Richard Wang.
+ *
+ */
+#ifndef RECORD_BUILDER_HPP
+#define RECORD_BUILDER_HPP
+
+#include <cstddef>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+namespace learning
+{
+
+namespace detail
+{
+
+template <class T>
+struct is_pair : std::false_type
+{
+};
+
+template <class A, class B>
+struct is_pair<std::pair<A, B>> : std::true_type
+{
+};
+
+/* 参数包中的第一个类型，参数包为空时为 void */
+template <class... Args>
+struct first_type
+{
+    typedef void type;
+};
+
+template <class First, class... Rest>
+struct first_type<First, Rest...>
+{
+    typedef First type;
+};
+
+template <class T, class ArgTuple, std::size_t... I>
+T construct_from_tuple(ArgTuple &&args, std::index_sequence<I...>)
+{
+    return T(std::get<I>(std::forward<ArgTuple>(args))...);
+}
+
+/**
+ * @brief 字段的延迟构造器：被转换为 T 时才用保存的参数构造
+ */
+template <class T, class ArgTuple>
+struct field_factory
+{
+    ArgTuple args;
+
+    operator T() &&
+    {
+        return construct_from_tuple<T>(std::move(args), std::make_index_sequence<std::tuple_size<ArgTuple>::value>());
+    }
+};
+
+template <class Record, class... ArgTuples, std::size_t... I>
+Record make_tuple_record(std::index_sequence<I...>, ArgTuples &&...args)
+{
+    return Record(field_factory<typename std::tuple_element<I, Record>::type, typename std::decay<ArgTuples>::type>{
+        std::forward<ArgTuples>(args)}...);
+}
+
+template <class Container, class... ArgTuples, std::size_t... I>
+typename Container::reference emplace_tuple_record(Container &c, std::index_sequence<I...>, ArgTuples &&...args)
+{
+    typedef typename Container::value_type record_type;
+    c.emplace_back(field_factory<typename std::tuple_element<I, record_type>::type, typename std::decay<ArgTuples>::type>{
+        std::forward<ArgTuples>(args)}...);
+    return c.back();
+}
+
+template <class Container, class... ArgTuples>
+typename Container::reference emplace_piecewise(std::true_type, Container &c, ArgTuples &&...args)
+{
+    c.emplace_back(std::piecewise_construct, std::forward<ArgTuples>(args)...);
+    return c.back();
+}
+
+template <class Container, class... ArgTuples>
+typename Container::reference emplace_piecewise(std::false_type, Container &c, ArgTuples &&...args)
+{
+    static_assert(sizeof...(ArgTuples) == std::tuple_size<typename Container::value_type>::value,
+                  "emplace_record: one argument tuple per field is required");
+    return emplace_tuple_record(c, std::index_sequence_for<ArgTuples...>(), std::forward<ArgTuples>(args)...);
+}
+
+template <class Record, class... ArgTuples>
+Record make_piecewise(std::true_type, ArgTuples &&...args)
+{
+    return Record(std::piecewise_construct, std::forward<ArgTuples>(args)...);
+}
+
+template <class Record, class... ArgTuples>
+Record make_piecewise(std::false_type, ArgTuples &&...args)
+{
+    return make_tuple_record<Record>(std::index_sequence_for<ArgTuples...>(), std::forward<ArgTuples>(args)...);
+}
+
+} // namespace detail
+
+/**
+ * @brief 显式复制一条记录；emplace_record 拒绝左值记录，确实需要复制时用它表明意图
+ */
+template <class Record>
+typename std::decay<Record>::type copy_record(const Record &r)
+{
+    return r;
+}
+
+/**
+ * @brief 把参数转发给 emplace_back，返回新记录的引用
+ */
+template <class Container, class... Args>
+typename Container::reference emplace_record(Container &c, Args &&...args)
+{
+    typedef typename Container::value_type record_type;
+    typedef typename detail::first_type<Args...>::type first_arg;
+    static_assert(!(sizeof...(Args) == 1 && std::is_lvalue_reference<first_arg>::value &&
+                    std::is_same<typename std::decay<first_arg>::type, record_type>::value),
+                  "emplace_record: passing a record lvalue copies it; use std::move(record) or learning::copy_record(record)");
+    static_assert(std::is_constructible<record_type, Args &&...>::value, "emplace_record: record is not constructible from these arguments");
+    c.emplace_back(std::forward<Args>(args)...);
+    return c.back();
+}
+
+/**
+ * @brief 每个字段用各自的参数元组原地构造
+ */
+template <class Container, class... ArgTuples>
+typename Container::reference emplace_record(Container &c, std::piecewise_construct_t, ArgTuples &&...field_args)
+{
+    return detail::emplace_piecewise(detail::is_pair<typename Container::value_type>(), c, std::forward<ArgTuples>(field_args)...);
+}
+
+/**
+ * @brief 以字段参数元组构造一条 pair / tuple 记录
+ */
+template <class Record, class... ArgTuples>
+Record make_record(std::piecewise_construct_t, ArgTuples &&...field_args)
+{
+    static_assert(sizeof...(ArgTuples) == std::tuple_size<Record>::value, "make_record: one argument tuple per field is required");
+    return detail::make_piecewise<Record>(detail::is_pair<Record>(), std::forward<ArgTuples>(field_args)...);
+}
+
+} // namespace learning
+
+#endif // RECORD_BUILDER_HPP
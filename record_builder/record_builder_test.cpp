@@ -0,0 +1,191 @@
+/**
+ * @file record_builder_test.cpp
+ * @author Richard Wang
+ * @brief 原地构造记录示例：用分配计数和拷贝计数证明没有多余的复制
+ *  1. pair_test() 的写法：emplace_back(p1) 复制 p1 的字符串(多一次堆分配)；emplace_record 直接构造或移动，只有字符串本身的一次分配；
+ *  2. tuple_test() 的写法：emplace_back(user1) / push_back(user2) 复制整个 tuple；
+ *     用一个会计数的字段类型验证 piecewise 构造的复制次数为 0；
+ *  3. make_record 得到单条记录。
+ *  字符串都超过 15 个字符，避开 libstdc++ 的短字符串优化，每次复制都会体现为一次堆分配。
+ *
+ * 编译: g++ -std=c++14 -O2 record_builder_test.cpp -o record_builder_test
+ * @version : 1.0
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c), Richard Wang.
+ *
+ */
+
+#include <iostream>
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
+#include <list>
+#include <new>
+#include <string>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#include "record_builder.hpp"
+
+static std::atomic<std::size_t> g_allocations(0);
+
+void *operator new(std::size_t size)
+{
+    ++g_allocations;
+    if (void *p = std::malloc(size == 0 ? 1 : size))
+    {
+        return p;
+    }
+    throw std::bad_alloc();
+}
+
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wmismatched-new-delete"
+#endif
+void operator delete(void *p) noexcept
+{
+    std::free(p);
+}
+
+void operator delete(void *p, std::size_t) noexcept
+{
+    std::free(p);
+}
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic pop
+#endif
+
+/**
+ * @brief 统计拷贝 / 移动次数的字段类型
+ */
+struct tracked_name
+{
+    static int copies;
+    static int moves;
+
+    std::string value;
+
+    tracked_name(const char *s) : value(s) {}
+    tracked_name(std::size_t n, char c) : value(n, c) {}
+    tracked_name(const tracked_name &other) : value(other.value) { ++copies; }
+    tracked_name(tracked_name &&other) noexcept : value(std::move(other.value)) { ++moves; }
+};
+
+int tracked_name::copies = 0;
+int tracked_name::moves = 0;
+
+/* 执行 f，返回期间发生的堆分配次数 */
+template <class F>
+std::size_t count_allocations(F f)
+{
+    const std::size_t before = g_allocations.load();
+    f();
+    return g_allocations.load() - before;
+}
+
+static void report(const char *what, std::size_t allocations, std::size_t expected)
+{
+    std::cout << what << ": " << allocations << " allocation(s)" << (allocations == expected ? "" : "  <-- unexpected") << std::endl;
+}
+
+/**
+ * @brief pair_test() 的写法与 emplace_record 对比
+ */
+void pair_test()
+{
+    std::cout << "------------- test pair ------------------" << std::endl;
+    std::vector<std::pair<int, std::string>> info_list;
+    info_list.reserve(8); // 排除扩容
+
+    std::pair<int, std::string> p1(12, "Mark Zuckerberg-Smith");
+    report("emplace_back(p1)          copies the string", count_allocations([&]()
+                                                                             { info_list.emplace_back(p1); }),
+           1);
+    report("emplace_record(12, \"...\")  builds in place", count_allocations([&]()
+                                                                              { learning::emplace_record(info_list, 17, "Jack Dorsey-Johnson"); }),
+           1);
+    report("emplace_record(move(p1))  steals the buffer", count_allocations([&]()
+                                                                              { learning::emplace_record(info_list, std::move(p1)); }),
+           0);
+    report("piecewise (14, (20, 'R')) builds in place", count_allocations([&]()
+                                                                            { learning::emplace_record(info_list, std::piecewise_construct,
+                                                                                                       std::forward_as_tuple(14),
+                                                                                                       std::forward_as_tuple(20, 'R')); }),
+           1);
+    /* learning::emplace_record(info_list, p1);   编译错误：会复制 p1 */
+    std::pair<int, std::string> p2(11, "Jim Morrison-Whitaker");
+    report("copy_record(p2)           explicit copy", count_allocations([&]()
+                                                                         { learning::emplace_record(info_list, learning::copy_record(p2)); }),
+           1);
+
+    for_each(info_list.begin(), info_list.end(), [](const std::pair<int, std::string> &p)
+             { std::cout << "Name: " << p.second << ", Age:" << std::get<0>(p) << std::endl; });
+}
+
+/**
+ * @brief tuple_test() 的写法与 piecewise 构造对比
+ */
+void tuple_test()
+{
+    std::cout << "------------- test tuple ------------------" << std::endl;
+    typedef std::tuple<int, tracked_name, int> user_t;
+    std::list<user_t> userList;
+
+    user_t user1{26, "Richard Wang-Longname", 178};
+    tracked_name::copies = tracked_name::moves = 0;
+    userList.emplace_back(user1);
+    userList.push_back(user1);
+    std::cout << "emplace_back(user1) + push_back(user1): copies " << tracked_name::copies << ", moves " << tracked_name::moves << std::endl;
+
+    tracked_name::copies = tracked_name::moves = 0;
+    learning::emplace_record(userList, std::piecewise_construct, std::forward_as_tuple(29), std::forward_as_tuple("Jack Jackson-Longname"),
+                             std::forward_as_tuple(180));
+    learning::emplace_record(userList, std::piecewise_construct, std::forward_as_tuple(25), std::forward_as_tuple(24, 'S'),
+                             std::forward_as_tuple(191));
+    std::cout << "2 x emplace_record(piecewise):          copies " << tracked_name::copies << ", moves " << tracked_name::moves
+              << (tracked_name::copies == 0 ? "  (no copies)" : "  <-- unexpected copy") << std::endl;
+
+    tracked_name::copies = tracked_name::moves = 0;
+    learning::emplace_record(userList, std::move(user1));
+    std::cout << "emplace_record(std::move(user1)):       copies " << tracked_name::copies << ", moves " << tracked_name::moves << std::endl;
+
+    for_each(userList.begin(), userList.end(), [](const user_t &user)
+             { std::cout << "Age:" << std::get<0>(user) << ", Name: " << std::get<1>(user).value << ", High: " << std::get<2>(user) << std::endl; });
+}
+
+/**
+ * @brief 单条记录
+ */
+void make_record_test()
+{
+    std::cout << "------------- test make_record ------------------" << std::endl;
+    typedef std::tuple<int, std::string, std::string> info_t;
+    std::size_t allocations = 0;
+    info_t info;
+    allocations = count_allocations([&]()
+                                    { info = learning::make_record<info_t>(std::piecewise_construct, std::forward_as_tuple(24),
+                                                                           std::forward_as_tuple("June of the long year"),
+                                                                           std::forward_as_tuple(18, '*')); });
+    report("make_record<tuple<int, string, string>>", allocations, 2);
+    std::cout << std::get<0>(info) << ", " << std::get<1>(info) << ", " << std::get<2>(info) << std::endl;
+}
+
+int main()
+{
+    /******************* pair_test() ****************/
+    pair_test();
+    /************************************************/
+
+    /****************** tuple_test() ****************/
+    tuple_test();
+    /************************************************/
+
+    /*************** make_record_test() *************/
+    make_record_test();
+    /************************************************/
+
+    return 0;
+}
@@ -0,0 +1,320 @@
+/**
+ * @file search_index.hpp
+ * @author Richard Wang
+ * @brief 有序数组上的静态查找索引：Eytzinger 布局与 S-tree(隐式B树) 布局
+ *  std::lower_bound 在有序数组上二分，前几层的访问位置相距很远，每一层几乎都是一次缓存未命中，
+ *  数组达到上亿元素时查找完全受内存延迟限制。下面两种索引把同一份有序数据重新排布，使访问更局部：
+ *
+ *  1. eytzinger_index<T, Compare>
+ *      按二叉堆(BFS)顺序存放：节点k的左右孩子为 2k 和 2k+1。前几层集中在数组开头、常驻缓存；
+ *      每次访问节点k时预取 k*16 处(即4层之后的16个后代所在的缓存行)，把多次内存延迟重叠起来。
+ *      循环体无分支，适用于任意可比较类型。
+ *
+ *  2. stree_index<T>
+ *      每个节点放 B=16 个有序键(int32 时正好一个64字节缓存行)，节点k的第i个孩子为 k*(B+1)+i+1。
+ *      树高只有 log17(n)，每层只访问一个缓存行；节点内用 SSE2 一次比较4个键再统计命中个数。
+ *      仅支持算术类型(空位用 numeric_limits<T>::infinity() 填充，整数用 max())。
+ *
+ *  两种索引的 lower_bound/upper_bound/equal_range 返回的都是元素在原有序数组中的下标(rank)，
+ *  不存在时返回 size()，因此调用方可以继续用下标访问与原数组对齐的其他数据。
+ * @version : 1.0
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c), Richard Wang.
+ *
+ */
+#ifndef SEARCH_INDEX_HPP
+#define SEARCH_INDEX_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <functional>
+#include <limits>
+#include <memory>
+#include <new>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+namespace learning
+{
+
+namespace detail
+{
+
+static const std::size_t kCacheLine = 64;
+
+struct aligned_free
+{
+    void operator()(void *p) const { std::free(p); }
+};
+
+/* 按缓存行对齐分配n个T(未构造，仅用于平凡类型) */
+template <class T>
+std::unique_ptr<T[], aligned_free> aligned_array(std::size_t n)
+{
+    void *p = nullptr;
+    if (posix_memalign(&p, kCacheLine, (n == 0 ? 1 : n) * sizeof(T)) != 0)
+    {
+        throw std::bad_alloc();
+    }
+    return std::unique_ptr<T[], aligned_free>(static_cast<T *>(p));
+}
+
+inline void prefetch(const void *p)
+{
+#if defined(__GNUC__)
+    __builtin_prefetch(p);
+#else
+    (void)p;
+#endif
+}
+
+/* rank 数组使用32位下标以节省内存，超过 2^32-1 个元素时拒绝构造 */
+inline void check_index_size(std::size_t n)
+{
+    if (n >= std::numeric_limits<uint32_t>::max())
+    {
+        throw std::length_error("search index supports at most 2^32-1 elements");
+    }
+}
+
+} // namespace detail
+
+/**
+ * @brief Eytzinger(BFS) 布局索引
+ */
+template <class T, class Compare = std::less<T>>
+class eytzinger_index
+{
+public:
+    typedef std::pair<std::size_t, std::size_t> range_type;
+
+    eytzinger_index() : n_(0) {}
+
+    /**
+     * @brief sorted 必须已按 comp 升序排列；构造后索引不再引用 sorted
+     */
+    explicit eytzinger_index(const std::vector<T> &sorted, const Compare &comp = Compare())
+        : n_(sorted.size()), comp_(comp)
+    {
+        detail::check_index_size(n_);
+        /* 下标0不使用，节点从1开始编号 */
+        keys_.resize(n_ + 1);
+        ranks_.resize(n_ + 1);
+        std::size_t next = 0;
+        build(sorted, next, 1);
+    }
+
+    std::size_t size() const { return n_; }
+
+    template <class Q>
+    std::size_t lower_bound(const Q &x) const
+    {
+        const Compare &comp = comp_;
+        return search(x, [&comp](const T &key, const Q &q)
+                      { return comp(key, q); });
+    }
+
+    template <class Q>
+    std::size_t upper_bound(const Q &x) const
+    {
+        const Compare &comp = comp_;
+        return search(x, [&comp](const T &key, const Q &q)
+                      { return !comp(q, key); });
+    }
+
+    template <class Q>
+    range_type equal_range(const Q &x) const { return range_type(lower_bound(x), upper_bound(x)); }
+
+    template <class Q>
+    bool contains(const Q &x) const
+    {
+        const std::size_t r = lower_bound(x);
+        return r != n_ && !comp_(x, key_at_rank(r));
+    }
+
+private:
+    /* 中序遍历 BFS 树，依次填入有序数据，使中序序列与原数组一致 */
+    void build(const std::vector<T> &sorted, std::size_t &next, std::size_t k)
+    {
+        if (k <= n_)
+        {
+            build(sorted, next, 2 * k);
+            keys_[k] = sorted[next];
+            ranks_[k] = static_cast<uint32_t>(next);
+            ++next;
+            build(sorted, next, 2 * k + 1);
+        }
+    }
+
+    /**
+     * @brief go_right(key, x) 为真表示答案在右子树；
+     *  下降结束后 k 的二进制形如 "答案节点 1 0...0"(最后一次向左之后一直向右)，
+     *  右移 (末尾连续1的个数 + 1) 位即可还原出最后一次向左转的节点。
+     */
+    template <class Q, class GoRight>
+    std::size_t search(const Q &x, GoRight go_right) const
+    {
+        static const std::size_t kPrefetchStride = sizeof(T) <= detail::kCacheLine ? detail::kCacheLine / sizeof(T) : 1;
+        std::size_t k = 1;
+        while (k <= n_)
+        {
+            detail::prefetch(keys_.data() + std::min(k * kPrefetchStride, n_));
+            k = 2 * k + (go_right(keys_[k], x) ? 1 : 0);
+        }
+        k >>= __builtin_ffsll(static_cast<long long>(~k));
+        return k == 0 ? n_ : ranks_[k];
+    }
+
+    const T &key_at_rank(std::size_t r) const
+    {
+        /* 仅 contains 使用：沿树重新定位 rank 为 r 的节点 */
+        std::size_t k = 1;
+        while (ranks_[k] != r)
+        {
+            k = 2 * k + (ranks_[k] < r ? 1 : 0);
+        }
+        return keys_[k];
+    }
+
+    std::size_t n_;
+    std::vector<T> keys_;
+    std::vector<uint32_t> ranks_;
+    Compare comp_;
+};
+
+/**
+ * @brief S-tree：静态隐式B树，每个节点 B 个键，按缓存行对齐
+ */
+template <class T>
+class stree_index
+{
+    static_assert(std::is_arithmetic<T>::value, "stree_index requires an arithmetic key type");
+
+public:
+    static const std::size_t B = detail::kCacheLine / sizeof(T) < 4 ? 4 : detail::kCacheLine / sizeof(T);
+    typedef std::pair<std::size_t, std::size_t> range_type;
+
+    stree_index() : n_(0), nblocks_(0) {}
+
+    explicit stree_index(const std::vector<T> &sorted) : n_(sorted.size()), nblocks_((sorted.size() + B - 1) / B)
+    {
+        detail::check_index_size(n_);
+        keys_ = detail::aligned_array<T>(nblocks_ * B);
+        ranks_.resize(nblocks_ * B);
+        std::size_t next = 0;
+        build(sorted, next, 0);
+    }
+
+    std::size_t size() const { return n_; }
+
+    /* 第一个 >= x 的元素下标 */
+    std::size_t lower_bound(T x) const { return search<false>(x); }
+
+    /* 第一个 > x 的元素下标 */
+    std::size_t upper_bound(T x) const { return search<true>(x); }
+
+    range_type equal_range(T x) const { return range_type(lower_bound(x), upper_bound(x)); }
+
+    bool contains(T x) const { return lower_bound(x) != upper_bound(x); }
+
+private:
+    static std::size_t child(std::size_t k, std::size_t i) { return k * (B + 1) + i + 1; }
+
+    /* 空位必须不小于任何真实键：浮点数用 +inf(数据中可能有 +inf，max() 会排在它前面)，整数用 max() */
+    static T pad_key() { return std::numeric_limits<T>::has_infinity ? std::numeric_limits<T>::infinity() : std::numeric_limits<T>::max(); }
+
+    void build(const std::vector<T> &sorted, std::size_t &next, std::size_t k)
+    {
+        if (k < nblocks_)
+        {
+            for (std::size_t i = 0; i < B; ++i)
+            {
+                build(sorted, next, child(k, i));
+                if (next < n_)
+                {
+                    keys_[k * B + i] = sorted[next];
+                    ranks_[k * B + i] = static_cast<uint32_t>(next);
+                    ++next;
+                }
+                else
+                {
+                    keys_[k * B + i] = pad_key();
+                    ranks_[k * B + i] = static_cast<uint32_t>(n_);
+                }
+            }
+            build(sorted, next, child(k, B));
+        }
+    }
+
+    template <bool Upper>
+    std::size_t search(T x) const
+    {
+        std::size_t k = 0;
+        std::size_t res = n_;
+        while (k < nblocks_)
+        {
+            const std::size_t i = rank_in_node<Upper>(keys_.get() + k * B, x);
+            if (i < B)
+            {
+                res = ranks_[k * B + i];
+            }
+            k = child(k, i);
+            if (k < nblocks_)
+            {
+                detail::prefetch(keys_.get() + k * B);
+            }
+        }
+        return res;
+    }
+
+    /* 节点内有多少个键 < x(Upper 时为 <= x)，即节点内第一个命中位置 */
+    template <bool Upper>
+    static std::size_t rank_in_node(const T *node, T x)
+    {
+        std::size_t cnt = 0;
+        for (std::size_t i = 0; i < B; ++i)
+        {
+            cnt += Upper ? (node[i] <= x) : (node[i] < x);
+        }
+        return cnt;
+    }
+
+    std::size_t n_;
+    std::size_t nblocks_;
+    std::unique_ptr<T[], detail::aligned_free> keys_;
+    std::vector<uint32_t> ranks_;
+};
+
+#if defined(__SSE2__)
+/* int32 节点正好16个键：4次 _mm_cmpgt_epi32 + movemask，统计比特数即为节点内的 rank */
+template <>
+template <bool Upper>
+inline std::size_t stree_index<int32_t>::rank_in_node(const int32_t *node, int32_t x)
+{
+    const __m128i *p = reinterpret_cast<const __m128i *>(node);
+    /* key < x  <=>  x > key；key <= x  <=>  x+1 > key (x 为 INT32_MAX 时全部命中) */
+    if (Upper && x == std::numeric_limits<int32_t>::max())
+    {
+        return B;
+    }
+    const __m128i vx = _mm_set1_epi32(Upper ? x + 1 : x);
+    unsigned mask = 0;
+    for (std::size_t j = 0; j < B / 4; ++j)
+    {
+        const __m128i lt = _mm_cmpgt_epi32(vx, _mm_load_si128(p + j));
+        mask |= static_cast<unsigned>(_mm_movemask_ps(_mm_castsi128_ps(lt))) << (4 * j);
+    }
+    return static_cast<std::size_t>(__builtin_popcount(mask));
+}
+#endif
+
+} // namespace learning
+
+#endif // SEARCH_INDEX_HPP
@@ -0,0 +1,156 @@
+/**
+ * @file search_index_test.cpp
+ * @author Richard Wang
+ * @brief Eytzinger / S-tree 查找索引示例
+ *  1. 与 test_no_capture_list() 一样先对数组 std::sort，然后分别用 std::lower_bound、eytzinger_index、stree_index 查找；
+ *  2. 浮点键包含 +inf 时(S-tree 的空位按 +inf 填充)，与 std::lower_bound / upper_bound 逐个对照；
+ *  3. 校验三者结果一致，并用 steady_clock 统计随机点查的平均耗时。
+ *
+ * 编译: g++ -std=c++14 -O2 -msse2 search_index_test.cpp -o search_index_test
+ * 运行: ./search_index_test [元素个数，默认 4194304]
+ * @version : 1.0
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c), Richard Wang.
+ *
+ */
+
+#include <iostream>
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <limits>
+#include <random>
+#include <vector>
+
+#include "search_index.hpp"
+
+/**
+ * @brief 小数组上展示 lower_bound / upper_bound / equal_range 的返回值
+ */
+void small_index_test()
+{
+    std::cout << "------------- test small index ------------------" << std::endl;
+    std::vector<int32_t> val_list = {3, 2, 1, 5, 4, 6, 4, 9};
+    std::sort(val_list.begin(), val_list.end(), [](int32_t a, int32_t b) -> bool
+              { return a < b; });
+
+    learning::eytzinger_index<int32_t> eyt(val_list);
+    learning::stree_index<int32_t> stree(val_list);
+
+    for (int32_t x : {0, 4, 7, 9, 10})
+    {
+        auto r1 = eyt.equal_range(x);
+        auto r2 = stree.equal_range(x);
+        std::cout << "x=" << x << " eytzinger:[" << r1.first << ", " << r1.second << ")"
+                  << " stree:[" << r2.first << ", " << r2.second << ")"
+                  << " contains:" << eyt.contains(x) << std::endl;
+    }
+}
+
+/**
+ * @brief 含 +inf 的 double 数组，各种长度下(空位数不同)查找 inf 与普通值
+ */
+void infinity_test()
+{
+    std::cout << "------------- test +inf keys ------------------" << std::endl;
+    const double inf = std::numeric_limits<double>::infinity();
+    std::size_t mismatch = 0;
+    for (std::size_t n = 1; n < 200; ++n)
+    {
+        std::vector<double> keys;
+        for (std::size_t i = 0; i + 1 < n; ++i)
+        {
+            keys.push_back(static_cast<double>(i) * 0.5);
+        }
+        keys.push_back(inf);
+
+        learning::eytzinger_index<double> eyt(keys);
+        learning::stree_index<double> stree(keys);
+        for (double x : {-1.0, 0.0, 0.75, 1e300, inf})
+        {
+            const std::size_t lo = std::lower_bound(keys.begin(), keys.end(), x) - keys.begin();
+            const std::size_t hi = std::upper_bound(keys.begin(), keys.end(), x) - keys.begin();
+            mismatch += (eyt.lower_bound(x) != lo) + (eyt.upper_bound(x) != hi);
+            mismatch += (stree.lower_bound(x) != lo) + (stree.upper_bound(x) != hi) + (stree.contains(x) != (lo != hi));
+        }
+    }
+    std::cout << "n = 1..199, last key +inf, mismatch: " << mismatch << std::endl;
+}
+
+template <class F>
+double measure_ns(const std::vector<int32_t> &queries, F search, std::size_t &checksum)
+{
+    std::chrono::steady_clock::time_point begin = std::chrono::steady_clock::now();
+    for (int32_t q : queries)
+    {
+        checksum += search(q);
+    }
+    std::chrono::steady_clock::time_point end = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::nano>(end - begin).count() / queries.size();
+}
+
+/**
+ * @brief 大数组随机点查耗时对比
+ */
+void large_index_test(std::size_t n)
+{
+    std::cout << "------------- test large index (n=" << n << ") ------------------" << std::endl;
+    std::mt19937 rng(42);
+    std::vector<int32_t> ids(n);
+    for (auto &id : ids)
+    {
+        id = static_cast<int32_t>(rng() >> 1);
+    }
+    std::sort(ids.begin(), ids.end());
+
+    learning::eytzinger_index<int32_t> eyt(ids);
+    learning::stree_index<int32_t> stree(ids);
+
+    std::vector<int32_t> queries(1 << 20);
+    for (auto &q : queries)
+    {
+        q = static_cast<int32_t>(rng() >> 1);
+    }
+
+    /* 先校验结果一致 */
+    std::size_t mismatch = 0;
+    for (std::size_t i = 0; i < 10000; ++i)
+    {
+        std::size_t expect = std::lower_bound(ids.begin(), ids.end(), queries[i]) - ids.begin();
+        mismatch += (eyt.lower_bound(queries[i]) != expect) + (stree.lower_bound(queries[i]) != expect);
+    }
+    std::cout << "mismatch: " << mismatch << std::endl;
+
+    std::size_t c1 = 0, c2 = 0, c3 = 0;
+    double t1 = measure_ns(queries, [&ids](int32_t q)
+                           { return static_cast<std::size_t>(std::lower_bound(ids.begin(), ids.end(), q) - ids.begin()); }, c1);
+    double t2 = measure_ns(queries, [&eyt](int32_t q)
+                           { return eyt.lower_bound(q); }, c2);
+    double t3 = measure_ns(queries, [&stree](int32_t q)
+                           { return stree.lower_bound(q); }, c3);
+
+    std::cout << "std::lower_bound : " << t1 << " ns/query" << std::endl;
+    std::cout << "eytzinger_index  : " << t2 << " ns/query" << std::endl;
+    std::cout << "stree_index      : " << t3 << " ns/query" << std::endl;
+    std::cout << "checksum equal: " << (c1 == c2 && c2 == c3) << std::endl;
+}
+
+int main(int argc, char *argv[])
+{
+    /**************** small_index_test() ************/
+    small_index_test();
+    /************************************************/
+
+    /***************** infinity_test() **************/
+    infinity_test();
+    /************************************************/
+
+    /**************** large_index_test() ************/
+    std::size_t n = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : (1u << 22);
+    large_index_test(n);
+    /************************************************/
+
+    return 0;
+}
@@ -0,0 +1,363 @@
+/**
+ * @file sort_key.hpp
+ * @author Richard Wang
+ * @brief 元组排序键规范化(key normalization)
+ *  std::tuple 的 operator< 逐字段比较：每个字段一次分支，字符串字段还要调用一次 compare。
+ *  规范化的思路是把参与排序的字段按顺序编码成一段字节串，使得“字节串的 memcmp 顺序 == 元组的排序顺序”，
+ *  之后的排序只需比较字节，可以直接做基数排序。
+ *
+ *  1. 字段编码规则
+ *      无符号整数 : 大端字节序
+ *      有符号整数 : 翻转符号位后按大端写出(负数排在正数前面)
+ *      浮点数     : 正数翻转符号位，负数翻转全部比特，再按大端写出
+ *      字符串     : 原始字节中的 0x00 转义为 0x00 0xFF，末尾追加 0x00 0x00 作为结束符，保证 "ab" < "abc"
+ *      降序字段   : 把该字段编码后的所有字节取反
+ *
+ *  2. 字段选择
+ *      sort_key<field<2>, field<0, sort_order::desc>> 表示先按第2个字段升序、再按第0个字段降序；
+ *      ascending_key<Tuple> 表示按元组字段的自然顺序全部升序，与 operator< 等价。
+ *
+ *  3. 排序
+ *      每条记录生成 {前8字节(uint64), 完整键的位置} 的条目。先对8字节前缀做 LSD 基数排序
+ *      (某一字节在所有记录中都相同时跳过该轮)，再只对前缀相同的小段用 memcmp 比较完整键。
+ *      整个过程是稳定的。
+ * @version : 1.0
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c), Richard Wang.
+ *
+ */
+#ifndef SORT_KEY_HPP
+#define SORT_KEY_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <iterator>
+#include <list>
+#include <string>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace learning
+{
+
+enum class sort_order
+{
+    asc,
+    desc
+};
+
+/**
+ * @brief 排序键中的一个字段：元组下标 I 和排序方向
+ */
+template <std::size_t I, sort_order Order = sort_order::asc>
+struct field
+{
+    static const std::size_t index = I;
+    static const sort_order order = Order;
+};
+
+namespace detail
+{
+
+inline void append_big_endian(std::string &out, uint64_t v, std::size_t bytes)
+{
+    for (std::size_t i = bytes; i-- > 0;)
+    {
+        out.push_back(static_cast<char>((v >> (8 * i)) & 0xFF));
+    }
+}
+
+template <class T, class Enable = void>
+struct field_encoder;
+
+template <class T>
+struct field_encoder<T, typename std::enable_if<std::is_integral<T>::value && std::is_unsigned<T>::value>::type>
+{
+    static void encode(T v, std::string &out) { append_big_endian(out, static_cast<uint64_t>(v), sizeof(T)); }
+};
+
+template <class T>
+struct field_encoder<T, typename std::enable_if<std::is_integral<T>::value && std::is_signed<T>::value>::type>
+{
+    static void encode(T v, std::string &out)
+    {
+        typedef typename std::make_unsigned<T>::type U;
+        const U sign = static_cast<U>(U(1) << (8 * sizeof(T) - 1));
+        append_big_endian(out, static_cast<uint64_t>(static_cast<U>(static_cast<U>(v) ^ sign)), sizeof(T));
+    }
+};
+
+template <class T>
+struct field_encoder<T, typename std::enable_if<std::is_enum<T>::value>::type>
+{
+    static void encode(T v, std::string &out)
+    {
+        field_encoder<typename std::underlying_type<T>::type>::encode(static_cast<typename std::underlying_type<T>::type>(v), out);
+    }
+};
+
+template <class T>
+struct field_encoder<T, typename std::enable_if<std::is_floating_point<T>::value>::type>
+{
+    static void encode(T v, std::string &out)
+    {
+        /* 统一按 double 编码，-0.0 规范为 +0.0 */
+        double d = (v == 0) ? 0.0 : static_cast<double>(v);
+        uint64_t bits;
+        std::memcpy(&bits, &d, sizeof(bits));
+        bits = (bits >> 63) ? ~bits : (bits | (uint64_t(1) << 63));
+        append_big_endian(out, bits, sizeof(bits));
+    }
+};
+
+inline void encode_bytes(const char *s, std::size_t len, std::string &out)
+{
+    for (std::size_t i = 0; i < len; ++i)
+    {
+        out.push_back(s[i]);
+        if (s[i] == '\0')
+        {
+            out.push_back(static_cast<char>(0xFF));
+        }
+    }
+    out.push_back('\0');
+    out.push_back('\0');
+}
+
+template <>
+struct field_encoder<std::string>
+{
+    static void encode(const std::string &s, std::string &out) { encode_bytes(s.data(), s.size(), out); }
+};
+
+template <>
+struct field_encoder<const char *>
+{
+    static void encode(const char *s, std::string &out) { encode_bytes(s, std::strlen(s), out); }
+};
+
+template <>
+struct field_encoder<char *> : field_encoder<const char *>
+{
+};
+
+/**
+ * @brief 排序用的条目：8字节前缀 + 完整键在 arena 中的位置 + 原记录下标
+ */
+struct key_entry
+{
+    uint64_t prefix;
+    std::size_t offset;
+    std::size_t length;
+    std::size_t index;
+};
+
+inline uint64_t load_prefix(const char *p, std::size_t len)
+{
+    uint64_t v = 0;
+    const std::size_t n = len < 8 ? len : 8;
+    for (std::size_t i = 0; i < n; ++i)
+    {
+        v |= static_cast<uint64_t>(static_cast<unsigned char>(p[i])) << (8 * (7 - i));
+    }
+    return v;
+}
+
+/* 对8字节前缀做稳定的 LSD 基数排序；一次遍历统计全部8个字节的直方图 */
+inline void radix_sort_prefix(std::vector<key_entry> &entries)
+{
+    const std::size_t n = entries.size();
+    std::vector<std::size_t> counts(8 * 256, 0);
+    for (const key_entry &e : entries)
+    {
+        for (std::size_t b = 0; b < 8; ++b)
+        {
+            ++counts[b * 256 + ((e.prefix >> (8 * b)) & 0xFF)];
+        }
+    }
+
+    std::vector<key_entry> buffer(n);
+    for (std::size_t b = 0; b < 8; ++b)
+    {
+        std::size_t *cnt = &counts[b * 256];
+        /* 该字节在所有条目中都相同，本轮不会改变顺序 */
+        if (cnt[(entries[0].prefix >> (8 * b)) & 0xFF] == n)
+        {
+            continue;
+        }
+        std::size_t sum = 0;
+        for (std::size_t i = 0; i < 256; ++i)
+        {
+            const std::size_t c = cnt[i];
+            cnt[i] = sum;
+            sum += c;
+        }
+        for (const key_entry &e : entries)
+        {
+            buffer[cnt[(e.prefix >> (8 * b)) & 0xFF]++] = e;
+        }
+        entries.swap(buffer);
+    }
+}
+
+} // namespace detail
+
+/**
+ * @brief 由若干 field<> 组成的排序键
+ */
+template <class... Fields>
+struct sort_key
+{
+    /**
+     * @brief 把 record 中选中的字段依次编码追加到 out
+     */
+    template <class Record>
+    static void encode(const Record &record, std::string &out)
+    {
+        int expand[] = {0, (encode_field<Fields>(record, out), 0)...};
+        (void)expand;
+    }
+
+    template <class Record>
+    static std::string encode(const Record &record)
+    {
+        std::string out;
+        encode(record, out);
+        return out;
+    }
+
+private:
+    template <class F, class Record>
+    static void encode_field(const Record &record, std::string &out)
+    {
+        typedef typename std::decay<typename std::tuple_element<F::index, Record>::type>::type elem_t;
+        const std::size_t start = out.size();
+        detail::field_encoder<elem_t>::encode(std::get<F::index>(record), out);
+        if (F::order == sort_order::desc)
+        {
+            for (std::size_t i = start; i < out.size(); ++i)
+            {
+                out[i] = static_cast<char>(~out[i]);
+            }
+        }
+    }
+};
+
+namespace detail
+{
+
+template <class Tuple, class Seq>
+struct ascending_key_impl;
+
+template <class Tuple, std::size_t... I>
+struct ascending_key_impl<Tuple, std::index_sequence<I...>>
+{
+    typedef sort_key<field<I>...> type;
+};
+
+} // namespace detail
+
+/**
+ * @brief 全部字段按原顺序升序，等价于元组的 operator<
+ */
+template <class Tuple>
+using ascending_key = typename detail::ascending_key_impl<
+    Tuple, std::make_index_sequence<std::tuple_size<Tuple>::value>>::type;
+
+/**
+ * @brief 计算 [first, last) 按 Key 排序后的下标序列(稳定)
+ */
+template <class Key, class InputIt>
+std::vector<std::size_t> sorted_permutation(InputIt first, InputIt last)
+{
+    std::string arena;
+    std::vector<detail::key_entry> entries;
+    for (std::size_t i = 0; first != last; ++first, ++i)
+    {
+        const std::size_t offset = arena.size();
+        Key::encode(*first, arena);
+        entries.push_back(detail::key_entry{0, offset, arena.size() - offset, i});
+    }
+    for (detail::key_entry &e : entries)
+    {
+        e.prefix = detail::load_prefix(arena.data() + e.offset, e.length);
+    }
+
+    if (!entries.empty())
+    {
+        detail::radix_sort_prefix(entries);
+    }
+
+    /* 前缀相同的段再按完整键比较 */
+    const char *base = arena.data();
+    auto full_less = [base](const detail::key_entry &a, const detail::key_entry &b)
+    {
+        const int c = std::memcmp(base + a.offset, base + b.offset, std::min(a.length, b.length));
+        return c != 0 ? c < 0 : a.length < b.length;
+    };
+    for (std::size_t i = 0; i < entries.size();)
+    {
+        std::size_t j = i + 1;
+        while (j < entries.size() && entries[j].prefix == entries[i].prefix)
+        {
+            ++j;
+        }
+        if (j - i > 1)
+        {
+            std::stable_sort(entries.begin() + i, entries.begin() + j, full_less);
+        }
+        i = j;
+    }
+
+    std::vector<std::size_t> order;
+    order.reserve(entries.size());
+    for (const detail::key_entry &e : entries)
+    {
+        order.push_back(e.index);
+    }
+    return order;
+}
+
+/**
+ * @brief 按 Key 对 vector 中的记录排序(稳定)
+ */
+template <class Key, class T, class Alloc>
+void normalized_sort(std::vector<T, Alloc> &records)
+{
+    const std::vector<std::size_t> order = sorted_permutation<Key>(records.begin(), records.end());
+    std::vector<T, Alloc> sorted;
+    sorted.reserve(records.size());
+    for (std::size_t idx : order)
+    {
+        sorted.push_back(std::move(records[idx]));
+    }
+    records.swap(sorted);
+}
+
+/**
+ * @brief 按 Key 对 list 中的记录排序(稳定)；只重排节点，不移动元素
+ */
+template <class Key, class T, class Alloc>
+void normalized_sort(std::list<T, Alloc> &records)
+{
+    std::vector<typename std::list<T, Alloc>::iterator> nodes;
+    nodes.reserve(records.size());
+    for (auto it = records.begin(); it != records.end(); ++it)
+    {
+        nodes.push_back(it);
+    }
+    const std::vector<std::size_t> order = sorted_permutation<Key>(records.begin(), records.end());
+    for (std::size_t idx : order)
+    {
+        records.splice(records.end(), records, nodes[idx]);
+    }
+}
+
+} // namespace learning
+
+#endif // SORT_KEY_HPP
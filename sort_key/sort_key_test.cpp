@@ -0,0 +1,113 @@
+/**
+ * @file sort_key_test.cpp
+ * @author Richard Wang
+ * @brief 排序键规范化示例
+ *  1. 对 tuple_test() 中的 std::list<std::tuple<int, std::string, int>> 按 (身高降序, 姓名升序) 排序；
+ *  2. 查看编码后的字节串，验证 memcmp 顺序与字段顺序一致；
+ *  3. 100万条随机元组：std::sort + operator< 与 normalized_sort 的耗时对比。
+ *
+ * 编译: g++ -std=c++14 -O2 sort_key_test.cpp -o sort_key_test
+ * @version : 1.0
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c), Richard Wang.
+ *
+ */
+
+#include <iostream>
+#include <iomanip>
+#include <algorithm>
+#include <chrono>
+#include <list>
+#include <random>
+#include <string>
+#include <tuple>
+#include <vector>
+
+#include "sort_key.hpp"
+
+typedef std::tuple<int, std::string, int> user_t;
+
+/**
+ * @brief 多字段、混合升降序排序
+ */
+void list_sort_test()
+{
+    std::cout << "------------- test list sort ------------------" << std::endl;
+    std::list<user_t> userList;
+    userList.emplace_back(26, "Richard", 178);
+    userList.emplace_back(29, "Jack", 180);
+    userList.emplace_back(25, "Simth", 191);
+    userList.emplace_back(-3, "Amy", 180);
+
+    /* ORDER BY High DESC, Name ASC */
+    typedef learning::sort_key<learning::field<2, learning::sort_order::desc>, learning::field<1>> key_t;
+    learning::normalized_sort<key_t>(userList);
+
+    for_each(userList.begin(), userList.end(), [](const user_t &user)
+             { std::cout << "Age:" << std::get<0>(user) << ", Name: " << std::get<1>(user) << ", High: " << std::get<2>(user) << std::endl; });
+}
+
+/**
+ * @brief 打印编码后的字节
+ */
+void encode_test()
+{
+    std::cout << "------------- test encode ------------------" << std::endl;
+    typedef learning::ascending_key<user_t> key_t;
+    for (const user_t &user : {user_t(-1, "ab", 0), user_t(1, "ab", 0), user_t(1, "abc", 0)})
+    {
+        std::string key = key_t::encode(user);
+        std::cout << std::get<0>(user) << "," << std::get<1>(user) << "," << std::get<2>(user) << " -> ";
+        for (unsigned char c : key)
+        {
+            std::cout << std::hex << std::setw(2) << std::setfill('0') << static_cast<int>(c) << " ";
+        }
+        std::cout << std::dec << std::endl;
+    }
+}
+
+/**
+ * @brief 大量记录的排序耗时对比
+ */
+void performance_test()
+{
+    std::cout << "------------- test performance ------------------" << std::endl;
+    const char *names[] = {"Richard", "Jack", "Simth", "Mark", "Rose", "Jim", "Amy", "Lucy"};
+    std::mt19937 rng(7);
+    std::vector<user_t> records;
+    records.reserve(1000000);
+    for (std::size_t i = 0; i < 1000000; ++i)
+    {
+        records.emplace_back(static_cast<int>(rng() % 100), std::string(names[rng() % 8]) + std::to_string(rng() % 1000),
+                             static_cast<int>(150 + rng() % 60));
+    }
+    std::vector<user_t> records2(records);
+
+    std::chrono::steady_clock::time_point t0 = std::chrono::steady_clock::now();
+    std::stable_sort(records.begin(), records.end());
+    std::chrono::steady_clock::time_point t1 = std::chrono::steady_clock::now();
+    learning::normalized_sort<learning::ascending_key<user_t>>(records2);
+    std::chrono::steady_clock::time_point t2 = std::chrono::steady_clock::now();
+
+    std::cout << "std::stable_sort + operator< : " << std::chrono::duration_cast<std::chrono::milliseconds>(t1 - t0).count() << " ms" << std::endl;
+    std::cout << "normalized_sort             : " << std::chrono::duration_cast<std::chrono::milliseconds>(t2 - t1).count() << " ms" << std::endl;
+    std::cout << "same result: " << (records == records2) << std::endl;
+}
+
+int main()
+{
+    /***************** list_sort_test() *************/
+    list_sort_test();
+    /************************************************/
+
+    /****************** encode_test() ***************/
+    encode_test();
+    /************************************************/
+
+    /**************** performance_test() ************/
+    performance_test();
+    /************************************************/
+
+    return 0;
+}
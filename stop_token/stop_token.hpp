@@ -0,0 +1,376 @@
+/**
+ * @file stop_token.hpp
+ * @author Richard Wang
+ * @brief C++11/14 下的协作式取消：stop_source / stop_token / stop_callback / jthread
+ *  用法与 C++20 的同名设施一致：
+ *  1. stop_source 发出停止请求(request_stop)，stop_token 是它的只读视图，可以拷贝给任意多个工作线程；
+ *  2. 工作线程轮询 token.stop_requested()，或者在 stop_condition / interruptible_sleep_for 上等待，
+ *     停止请求会立即唤醒正在等待的线程，不需要等睡眠时间结束；
+ *  3. stop_callback 在停止请求发生时执行一次回调(若注册时已经请求停止，则在构造函数中立即执行)；
+ *  4. jthread 析构时自动 request_stop() + join()；线程函数的第一个参数若为 stop_token，会自动传入。
+ * @version : 1.0
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c), Richard Wang.
+ *
+ */
+#ifndef STOP_TOKEN_HPP
+#define STOP_TOKEN_HPP
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <utility>
+
+namespace learning
+{
+
+namespace detail
+{
+
+/**
+ * @brief stop_source 与所有 stop_token 共享的状态
+ */
+class stop_state
+{
+public:
+    typedef uint64_t callback_id;
+
+    stop_state() : requested_(false), next_id_(0), running_(false), running_id_(0) {}
+
+    bool stop_requested() const { return requested_.load(std::memory_order_acquire); }
+
+    /* 只有第一次请求返回 true；回调在调用线程中按注册顺序依次执行 */
+    bool request_stop()
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        if (requested_.load(std::memory_order_relaxed))
+        {
+            return false;
+        }
+        requested_.store(true, std::memory_order_release);
+        runner_ = std::this_thread::get_id();
+        while (!callbacks_.empty())
+        {
+            std::map<callback_id, std::function<void()>>::iterator it = callbacks_.begin();
+            std::function<void()> cb = std::move(it->second);
+            running_ = true;
+            running_id_ = it->first;
+            callbacks_.erase(it);
+            lock.unlock();
+            cb();
+            lock.lock();
+            running_ = false;
+            done_.notify_all();
+        }
+        return true;
+    }
+
+    /* 已请求停止时不注册，返回 false，由调用方直接执行回调 */
+    bool add_callback(std::function<void()> cb, callback_id &id)
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (requested_.load(std::memory_order_relaxed))
+        {
+            return false;
+        }
+        id = next_id_++;
+        callbacks_.emplace(id, std::move(cb));
+        return true;
+    }
+
+    /* 注销回调；若它正在其他线程中执行，等待其执行完毕(回调中注销自己时不等待) */
+    void remove_callback(callback_id id)
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        if (callbacks_.erase(id) > 0)
+        {
+            return;
+        }
+        if (running_ && running_id_ == id && runner_ != std::this_thread::get_id())
+        {
+            done_.wait(lock, [this, id]()
+                       { return !running_ || running_id_ != id; });
+        }
+    }
+
+private:
+    std::atomic<bool> requested_;
+    std::mutex mutex_;
+    std::condition_variable done_;
+    std::map<callback_id, std::function<void()>> callbacks_;
+    callback_id next_id_;
+    bool running_;
+    callback_id running_id_;
+    std::thread::id runner_;
+};
+
+} // namespace detail
+
+class stop_source;
+
+/**
+ * @brief 停止请求的只读视图，可以廉价拷贝
+ */
+class stop_token
+{
+public:
+    stop_token() {}
+
+    bool stop_requested() const { return state_ && state_->stop_requested(); }
+
+    /* 默认构造的 token 永远不会收到停止请求 */
+    bool stop_possible() const { return static_cast<bool>(state_); }
+
+    friend bool operator==(const stop_token &a, const stop_token &b) { return a.state_ == b.state_; }
+    friend bool operator!=(const stop_token &a, const stop_token &b) { return a.state_ != b.state_; }
+
+private:
+    friend class stop_source;
+    template <class F>
+    friend class stop_callback;
+
+    explicit stop_token(std::shared_ptr<detail::stop_state> state) : state_(std::move(state)) {}
+
+    std::shared_ptr<detail::stop_state> state_;
+};
+
+class stop_source
+{
+public:
+    stop_source() : state_(std::make_shared<detail::stop_state>()) {}
+
+    stop_token get_token() const { return stop_token(state_); }
+    bool stop_requested() const { return state_ && state_->stop_requested(); }
+
+    /* 返回 true 表示本次调用发出了停止请求(之前没有人请求过)；被移走的 stop_source 没有状态，返回 false */
+    bool request_stop() { return state_ && state_->request_stop(); }
+
+private:
+    std::shared_ptr<detail::stop_state> state_;
+};
+
+/**
+ * @brief 在停止请求发生时执行 f，析构时自动注销
+ */
+template <class F>
+class stop_callback
+{
+public:
+    template <class C>
+    stop_callback(const stop_token &token, C &&cb) : state_(token.state_), registered_(false)
+    {
+        std::shared_ptr<F> fn = std::make_shared<F>(std::forward<C>(cb));
+        if (state_)
+        {
+            registered_ = state_->add_callback([fn]()
+                                               { (*fn)(); },
+                                               id_);
+            if (!registered_ && state_->stop_requested())
+            {
+                (*fn)();
+            }
+        }
+    }
+
+    ~stop_callback()
+    {
+        if (registered_)
+        {
+            state_->remove_callback(id_);
+        }
+    }
+
+    stop_callback(const stop_callback &) = delete;
+    stop_callback &operator=(const stop_callback &) = delete;
+
+private:
+    std::shared_ptr<detail::stop_state> state_;
+    detail::stop_state::callback_id id_;
+    bool registered_;
+};
+
+/**
+ * @brief 可被停止请求打断的条件变量(类似 C++20 std::condition_variable_any 的 stop_token 重载)
+ *  wait 系列函数在谓词满足或收到停止请求时返回，返回值为谓词的最终结果。
+ *  内部使用自己的互斥量完成“检查-等待”，停止回调只需要获取这个内部互斥量，
+ *  因此持有用户互斥量时调用 request_stop() 也不会死锁。
+ */
+class stop_condition
+{
+public:
+    void notify_one()
+    {
+        std::lock_guard<std::mutex> guard(internal_);
+        cv_.notify_one();
+    }
+
+    void notify_all()
+    {
+        std::lock_guard<std::mutex> guard(internal_);
+        cv_.notify_all();
+    }
+
+    template <class Lock, class Pred>
+    bool wait(Lock &lock, const stop_token &token, Pred pred)
+    {
+        return wait_impl(lock, token, pred, static_cast<const std::chrono::steady_clock::time_point *>(nullptr));
+    }
+
+    template <class Lock, class Clock, class Duration, class Pred>
+    bool wait_until(Lock &lock, const stop_token &token, const std::chrono::time_point<Clock, Duration> &deadline, Pred pred)
+    {
+        return wait_impl(lock, token, pred, &deadline);
+    }
+
+    template <class Lock, class Rep, class Period, class Pred>
+    bool wait_for(Lock &lock, const stop_token &token, const std::chrono::duration<Rep, Period> &rel_time, Pred pred)
+    {
+        return wait_until(lock, token, std::chrono::steady_clock::now() + rel_time, pred);
+    }
+
+private:
+    /*
+     * 先在持有用户锁的情况下取得内部锁，再释放用户锁进入等待：
+     * 通知方(修改状态后调用 notify，或停止回调)必须取得内部锁，因此不会在“检查谓词”与“进入等待”之间发出通知。
+     */
+    template <class Lock, class Pred, class TimePoint>
+    bool wait_impl(Lock &lock, const stop_token &token, Pred &pred, const TimePoint *deadline)
+    {
+        stop_condition *self = this;
+        stop_callback<std::function<void()>> cb(token, [self]()
+                                                { self->notify_all(); });
+        while (!pred())
+        {
+            std::unique_lock<std::mutex> inner(internal_);
+            if (token.stop_requested())
+            {
+                return false;
+            }
+            lock.unlock();
+            bool timeout = false;
+            if (deadline != nullptr)
+            {
+                timeout = cv_.wait_until(inner, *deadline) == std::cv_status::timeout;
+            }
+            else
+            {
+                cv_.wait(inner);
+            }
+            inner.unlock();
+            lock.lock();
+            if (timeout)
+            {
+                return pred();
+            }
+        }
+        return true;
+    }
+
+    std::mutex internal_;
+    std::condition_variable cv_;
+};
+
+/**
+ * @brief 可被打断的睡眠；睡满 rel_time 返回 true，被停止请求提前唤醒返回 false
+ */
+template <class Rep, class Period>
+bool interruptible_sleep_for(const stop_token &token, const std::chrono::duration<Rep, Period> &rel_time)
+{
+    std::mutex m;
+    stop_condition cv;
+    std::unique_lock<std::mutex> lock(m);
+    cv.wait_for(lock, token, rel_time, []()
+                { return false; });
+    return !token.stop_requested();
+}
+
+/**
+ * @brief 析构时自动请求停止并 join 的线程
+ */
+class jthread
+{
+public:
+    jthread() {}
+
+    template <class F, class... Args,
+              class = typename std::enable_if<!std::is_same<typename std::decay<F>::type, jthread>::value>::type>
+    explicit jthread(F &&f, Args &&...args)
+    {
+        start(std::integral_constant<bool, accepts_token<F, Args...>::value>(), std::forward<F>(f), std::forward<Args>(args)...);
+    }
+
+    jthread(jthread &&other) : source_(std::move(other.source_)), thread_(std::move(other.thread_)) {}
+
+    jthread &operator=(jthread &&other)
+    {
+        if (this != &other)
+        {
+            stop_and_join();
+            source_ = std::move(other.source_);
+            thread_ = std::move(other.thread_);
+        }
+        return *this;
+    }
+
+    ~jthread() { stop_and_join(); }
+
+    jthread(const jthread &) = delete;
+    jthread &operator=(const jthread &) = delete;
+
+    bool joinable() const { return thread_.joinable(); }
+    void join() { thread_.join(); }
+    void detach() { thread_.detach(); }
+    std::thread::id get_id() const { return thread_.get_id(); }
+
+    stop_source get_stop_source() const { return source_; }
+    stop_token get_stop_token() const { return source_.get_token(); }
+    bool request_stop() { return source_.request_stop(); }
+
+private:
+    /* 判断 f 能否以 (stop_token, args...) 调用 */
+    template <class F, class... Args>
+    struct accepts_token
+    {
+        template <class G>
+        static auto test(int) -> decltype(std::declval<G>()(std::declval<stop_token>(), std::declval<Args>()...), std::true_type());
+        template <class G>
+        static std::false_type test(...);
+        static const bool value = decltype(test<F>(0))::value;
+    };
+
+    template <class F, class... Args>
+    void start(std::true_type, F &&f, Args &&...args)
+    {
+        thread_ = std::thread(std::forward<F>(f), source_.get_token(), std::forward<Args>(args)...);
+    }
+
+    template <class F, class... Args>
+    void start(std::false_type, F &&f, Args &&...args)
+    {
+        thread_ = std::thread(std::forward<F>(f), std::forward<Args>(args)...);
+    }
+
+    void stop_and_join()
+    {
+        if (thread_.joinable())
+        {
+            source_.request_stop();
+            thread_.join();
+        }
+    }
+
+    stop_source source_;
+    std::thread thread_;
+};
+
+} // namespace learning
+
+#endif // STOP_TOKEN_HPP
@@ -0,0 +1,184 @@
+/**
+ * @file stop_token_test.cpp
+ * @author Richard Wang
+ * @brief 协作式取消示例
+ *  1. 多个工作线程轮询 stop_token，主线程 request_stop() 后全部退出；
+ *  2. 在 stop_condition 上等待的线程被停止请求立即唤醒，不需要等到超时；
+ *  3. stop_callback 的注册、执行与注销；
+ *  4. jthread 析构时自动停止并 join，睡眠中的线程立即退出。
+ *
+ * 编译: g++ -std=c++11 -O2 -pthread stop_token_test.cpp -o stop_token_test
+ * @version : 1.0
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c), Richard Wang.
+ *
+ */
+
+#include <iostream>
+#include <atomic>
+#include <chrono>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "stop_token.hpp"
+
+typedef std::chrono::steady_clock clock_type;
+
+static long long elapsed_ms(clock_type::time_point begin)
+{
+    return std::chrono::duration_cast<std::chrono::milliseconds>(clock_type::now() - begin).count();
+}
+
+/**
+ * @brief 工作线程轮询 stop_requested()
+ */
+void poll_test()
+{
+    std::cout << "------------- test poll ------------------" << std::endl;
+    learning::stop_source source;
+    std::atomic<long long> total(0);
+    std::vector<std::thread> workers;
+    for (int i = 0; i < 4; ++i)
+    {
+        learning::stop_token token = source.get_token();
+        workers.emplace_back([token, &total]()
+                             {
+                                 long long count = 0;
+                                 while (!token.stop_requested())
+                                 {
+                                     ++count;
+                                 }
+                                 total += count;
+                             });
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    std::cout << "first request_stop: " << source.request_stop() << std::endl;
+    std::cout << "second request_stop: " << source.request_stop() << std::endl;
+    for (std::thread &t : workers)
+    {
+        t.join();
+    }
+    std::cout << "all workers stopped, iterations > 0: " << (total > 0) << std::endl;
+}
+
+/**
+ * @brief 消费者在条件变量上等待任务，停止请求立即把它唤醒
+ */
+void condition_test()
+{
+    std::cout << "------------- test stop_condition ------------------" << std::endl;
+    std::mutex m;
+    learning::stop_condition cv;
+    std::deque<std::string> tasks;
+    learning::stop_source source;
+
+    std::thread consumer([&]()
+                         {
+                             learning::stop_token token = source.get_token();
+                             std::unique_lock<std::mutex> lock(m);
+                             for (;;)
+                             {
+                                 /* 超时时间设为 10 秒，被停止请求唤醒时远远不到这个时间 */
+                                 if (!cv.wait_for(lock, token, std::chrono::seconds(10), [&tasks]()
+                                                  { return !tasks.empty(); }))
+                                 {
+                                     break;
+                                 }
+                                 std::cout << "task: " << tasks.front() << std::endl;
+                                 tasks.pop_front();
+                             }
+                         });
+
+    const char *names[] = {"Mark", "Jack", "Rose"};
+    for (const char *name : names)
+    {
+        {
+            std::lock_guard<std::mutex> lock(m);
+            tasks.push_back(name);
+        }
+        cv.notify_one();
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    }
+
+    clock_type::time_point begin = clock_type::now();
+    source.request_stop();
+    consumer.join();
+    std::cout << "consumer woke up after " << elapsed_ms(begin) << " ms" << std::endl;
+}
+
+/**
+ * @brief stop_callback：请求停止时执行；注册时已停止则立即执行；析构后不再执行
+ */
+void callback_test()
+{
+    std::cout << "------------- test stop_callback ------------------" << std::endl;
+    learning::stop_source source;
+    learning::stop_token token = source.get_token();
+    {
+        learning::stop_callback<std::function<void()>> removed(token, []()
+                                                               { std::cout << "never printed" << std::endl; });
+    }
+    learning::stop_callback<std::function<void()>> first(token, []()
+                                                         { std::cout << "callback 1" << std::endl; });
+    learning::stop_callback<std::function<void()>> second(token, []()
+                                                          { std::cout << "callback 2" << std::endl; });
+    source.request_stop();
+    learning::stop_callback<std::function<void()>> late(token, []()
+                                                        { std::cout << "callback 3 (registered after stop)" << std::endl; });
+
+    learning::stop_token empty;
+    std::cout << "default token stop_possible: " << empty.stop_possible() << std::endl;
+}
+
+/**
+ * @brief jthread 析构时自动 request_stop() + join()
+ */
+void jthread_test()
+{
+    std::cout << "------------- test jthread ------------------" << std::endl;
+    clock_type::time_point begin = clock_type::now();
+    {
+        learning::jthread worker([](learning::stop_token token, std::string name)
+                                 {
+                                     int ticks = 0;
+                                     while (learning::interruptible_sleep_for(token, std::chrono::milliseconds(100)))
+                                     {
+                                         ++ticks;
+                                     }
+                                     std::cout << name << " stopped after " << ticks << " ticks" << std::endl;
+                                 },
+                                 std::string("worker"));
+        std::this_thread::sleep_for(std::chrono::milliseconds(350));
+    }
+    std::cout << "scope left after " << elapsed_ms(begin) << " ms" << std::endl;
+
+    /* 不接收 stop_token 的线程函数也可以使用，析构时仅 join */
+    learning::jthread plain([](int v)
+                            { std::cout << "plain jthread: " << v << std::endl; },
+                            123);
+}
+
+int main()
+{
+    /********************* poll_test() **************/
+    poll_test();
+    /************************************************/
+
+    /****************** condition_test() ************/
+    condition_test();
+    /************************************************/
+
+    /****************** callback_test() *************/
+    callback_test();
+    /************************************************/
+
+    /******************* jthread_test() *************/
+    jthread_test();
+    /************************************************/
+
+    return 0;
+}
@@ -20,6 +20,7 @@
 #include <vector>
 #include <tuple>
 #include <algorithm>
+#include <utility>
 
 /**
  * @brief 介绍std::pair的使用
@@ -68,9 +69,9 @@ void pair_test()
     auto p2 = std::make_pair<int, std::string>(17, "Jack");
     auto p3 = std::make_pair(11, "Jim");
 
-    info_list.emplace_back(p1);
-    info_list.emplace_back(p2);
-    info_list.emplace_back(p3);
+    info_list.emplace_back(std::move(p1));
+    info_list.emplace_back(std::move(p2));
+    info_list.emplace_back(std::move(p3));
     info_list.emplace_back(std::make_pair(14, "Rose"));
 
     for_each(info_list.begin(), info_list.end(), [](const std::pair<int, std::string> &p)
@@ -121,9 +122,9 @@ void tuple_test()
     auto user3 = std::make_tuple(25, "Simth", 191);
 
     std::list<std::tuple<int, std::string, int>> userList;
-    userList.emplace_back(user1);
-    userList.push_back(user2);
-    userList.push_back(user3);
+    userList.emplace_back(std::move(user1));
+    userList.push_back(std::move(user2));
+    userList.push_back(std::move(user3));
 
     for_each(userList.begin(), userList.end(), [](const std::tuple<int, std::string, int> &user)
              { std::cout << "Age:" << std::get<0>(user) << ", Name: " << std::get<1>(user) << ", High: " << std::get<2>(user) << std::endl; });
@@ -152,9 +153,9 @@ void tie_test()
     auto info3 = std::make_tuple(31, "March", "English");
 
     std::list<std::tuple<int, std::string, std::string>> info_list;
-    info_list.emplace_back(info1);
-    info_list.emplace_back(info2);
-    info_list.emplace_back(info3);
+    info_list.emplace_back(std::move(info1));
+    info_list.emplace_back(std::move(info2));
+    info_list.emplace_back(std::move(info3));
     info_list.emplace_back(std::make_tuple<int, std::string, std::string>(18, "Dec", "France"));
 
     for_each(info_list.begin(), info_list.end(), [](const std::tuple<int, std::string, std::string> &info)
@@ -0,0 +1,286 @@
+/**
+ * @file top_k.hpp
+ * @author Richard Wang
+ * @brief Top-K / 部分排序
+ *  只需要排序结果的前K个元素时，没有必要把全部数据排好序。这里的“前K个”沿用 std::sort 的约定：
+ *  comp(a, b) 为真表示 a 排在 b 前面，因此 std::less 得到最小的K个，std::greater 得到最大的K个，
+ *  lamba_test.cpp 中的 [](int a, int b) -> bool { return a < b; } 之类的 lambda 也可以直接传入。
+ *
+ *  1. top_k_heap
+ *      容量为K的堆，堆顶是当前保留元素中“最差”的一个(阈值)。新元素只有排在阈值之前才会入堆，
+ *      每个元素 O(log K)，适合K很小的场景。
+ *  2. top_k_buffer
+ *      容量为 2K 的缓冲区。缓冲区满时用 std::nth_element(快速选择) 找出第K个元素作为新阈值并丢弃后半部分；
+ *      之后的输入先与阈值比较，绝大多数元素一次比较就被过滤掉。均摊每个元素 O(1)，适合K较大的场景。
+ *  3. top_k(first, last, k, comp)
+ *      根据K的大小自动选择上面两种实现，返回排好序的前K个元素。
+ *  4. parallel_top_k(first, last, k, comp, threads)
+ *      每个线程对自己的分段求 top-K，再把各线程结果合并求一次 top-K。
+ * @version : 1.0
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c), Richard Wang.
+ *
+ */
+#ifndef TOP_K_HPP
+#define TOP_K_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <exception>
+#include <functional>
+#include <iterator>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace learning
+{
+
+/**
+ * @brief K 不超过该值时使用堆，否则使用快速选择缓冲区
+ */
+static const std::size_t kTopKHeapLimit = 256;
+
+/**
+ * @brief 基于有界堆的流式 top-K
+ */
+template <class T, class Compare = std::less<T>>
+class top_k_heap
+{
+public:
+    explicit top_k_heap(std::size_t k, Compare comp = Compare()) : k_(k), comp_(comp)
+    {
+        heap_.reserve(k);
+    }
+
+    /**
+     * @brief 输入一个元素；返回该元素是否被保留
+     */
+    template <class U>
+    bool push(U &&value)
+    {
+        if (k_ == 0)
+        {
+            return false;
+        }
+        if (heap_.size() < k_)
+        {
+            heap_.push_back(std::forward<U>(value));
+            std::push_heap(heap_.begin(), heap_.end(), comp_);
+            return true;
+        }
+        /* comp 作为堆比较器时堆顶为“最大”元素，也就是排在最后、最先被淘汰的那个 */
+        if (!comp_(value, heap_.front()))
+        {
+            return false;
+        }
+        std::pop_heap(heap_.begin(), heap_.end(), comp_);
+        heap_.back() = std::forward<U>(value);
+        std::push_heap(heap_.begin(), heap_.end(), comp_);
+        return true;
+    }
+
+    template <class InputIt>
+    void push(InputIt first, InputIt last)
+    {
+        for (; first != last; ++first)
+        {
+            push(*first);
+        }
+    }
+
+    /* 已满K个时返回阈值元素(当前第K名)，新元素必须排在它前面才能入选 */
+    bool full() const { return heap_.size() == k_; }
+    const T &threshold() const { return heap_.front(); }
+    std::size_t size() const { return heap_.size(); }
+    std::size_t k() const { return k_; }
+
+    void merge(const top_k_heap &other) { push(other.heap_.begin(), other.heap_.end()); }
+
+    /**
+     * @brief 取出结果(按 comp 排好序)，之后对象为空
+     */
+    std::vector<T> take()
+    {
+        std::sort_heap(heap_.begin(), heap_.end(), comp_);
+        std::vector<T> out;
+        out.swap(heap_);
+        return out;
+    }
+
+private:
+    std::size_t k_;
+    Compare comp_;
+    std::vector<T> heap_;
+};
+
+/**
+ * @brief 基于快速选择 + 阈值过滤的流式 top-K
+ */
+template <class T, class Compare = std::less<T>>
+class top_k_buffer
+{
+public:
+    explicit top_k_buffer(std::size_t k, Compare comp = Compare()) : k_(k), comp_(comp), has_threshold_(false)
+    {
+        buffer_.reserve(2 * k);
+    }
+
+    template <class U>
+    bool push(U &&value)
+    {
+        if (k_ == 0 || (has_threshold_ && !comp_(value, buffer_[k_ - 1])))
+        {
+            return false;
+        }
+        buffer_.push_back(std::forward<U>(value));
+        if (buffer_.size() == 2 * k_)
+        {
+            shrink();
+        }
+        return true;
+    }
+
+    template <class InputIt>
+    void push(InputIt first, InputIt last)
+    {
+        for (; first != last; ++first)
+        {
+            push(*first);
+        }
+    }
+
+    std::size_t k() const { return k_; }
+
+    void merge(const top_k_buffer &other) { push(other.buffer_.begin(), other.buffer_.end()); }
+
+    std::vector<T> take()
+    {
+        if (buffer_.size() > k_)
+        {
+            shrink();
+        }
+        std::sort(buffer_.begin(), buffer_.end(), comp_);
+        std::vector<T> out;
+        out.swap(buffer_);
+        has_threshold_ = false;
+        return out;
+    }
+
+private:
+    /* 快速选择出前K个，第K个元素成为新的阈值；追加新元素不会移动它 */
+    void shrink()
+    {
+        std::nth_element(buffer_.begin(), buffer_.begin() + (k_ - 1), buffer_.end(), comp_);
+        buffer_.resize(k_);
+        has_threshold_ = true;
+    }
+
+    std::size_t k_;
+    Compare comp_;
+    std::vector<T> buffer_; // 前K个位置是已选出的元素，buffer_[k_ - 1] 为阈值，之后是新追加的候选
+    bool has_threshold_;
+};
+
+/**
+ * @brief 求 [first, last) 中按 comp 排序的前k个元素，返回值已排序
+ */
+template <class InputIt, class Compare>
+std::vector<typename std::iterator_traits<InputIt>::value_type>
+top_k(InputIt first, InputIt last, std::size_t k, Compare comp)
+{
+    typedef typename std::iterator_traits<InputIt>::value_type value_t;
+    if (k <= kTopKHeapLimit)
+    {
+        top_k_heap<value_t, Compare> heap(k, comp);
+        heap.push(first, last);
+        return heap.take();
+    }
+    top_k_buffer<value_t, Compare> buffer(k, comp);
+    buffer.push(first, last);
+    return buffer.take();
+}
+
+template <class InputIt>
+std::vector<typename std::iterator_traits<InputIt>::value_type>
+top_k(InputIt first, InputIt last, std::size_t k)
+{
+    return top_k(first, last, k, std::less<typename std::iterator_traits<InputIt>::value_type>());
+}
+
+/**
+ * @brief 多线程 top-K：[first, last) 平均切分给 threads 个线程，各自求 top-K 后合并
+ *  要求随机访问迭代器；comp 会被每个线程各拷贝一份，因此有状态的 lambda 需要自行保证线程安全。
+ *  任一线程抛出异常(比较器抛出、复制元素时 bad_alloc 等)时，等所有线程结束后向调用者重新抛出。
+ */
+template <class RandomIt, class Compare>
+std::vector<typename std::iterator_traits<RandomIt>::value_type>
+parallel_top_k(RandomIt first, RandomIt last, std::size_t k, Compare comp,
+               std::size_t threads = std::thread::hardware_concurrency())
+{
+    typedef typename std::iterator_traits<RandomIt>::value_type value_t;
+    const std::size_t n = static_cast<std::size_t>(last - first);
+    if (threads <= 1 || n < 2 * threads * (k + 1))
+    {
+        return top_k(first, last, k, comp);
+    }
+
+    /* 每个线程的异常先存下来，全部线程结束后按线程顺序重新抛出第一个，与串行 top_k 一样向调用者传递 */
+    std::vector<std::vector<value_t>> partial(threads);
+    std::vector<std::exception_ptr> errors(threads);
+    std::vector<std::thread> workers;
+    workers.reserve(threads);
+    try
+    {
+        for (std::size_t t = 0; t < threads; ++t)
+        {
+            RandomIt begin = first + n * t / threads;
+            RandomIt end = first + n * (t + 1) / threads;
+            workers.emplace_back([begin, end, k, comp, t, &partial, &errors]()
+                                 {
+                                     try
+                                     {
+                                         partial[t] = top_k(begin, end, k, comp);
+                                     }
+                                     catch (...)
+                                     {
+                                         errors[t] = std::current_exception();
+                                     }
+                                 });
+        }
+    }
+    catch (...)
+    {
+        /* 创建线程失败：已启动的线程必须先 join，否则 vector 析构可结合的 std::thread 会调用 terminate */
+        for (std::thread &w : workers)
+        {
+            w.join();
+        }
+        throw;
+    }
+    for (std::thread &w : workers)
+    {
+        w.join();
+    }
+    for (const std::exception_ptr &e : errors)
+    {
+        if (e)
+        {
+            std::rethrow_exception(e);
+        }
+    }
+
+    /* 合并阶段只有 threads * k 个候选元素 */
+    std::vector<value_t> candidates;
+    candidates.reserve(threads * k);
+    for (std::vector<value_t> &p : partial)
+    {
+        std::move(p.begin(), p.end(), std::back_inserter(candidates));
+    }
+    return top_k(candidates.begin(), candidates.end(), k, comp);
+}
+
+} // namespace learning
+
+#endif // TOP_K_HPP
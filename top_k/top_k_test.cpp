@@ -0,0 +1,132 @@
+/**
+ * @file top_k_test.cpp
+ * @author Richard Wang
+ * @brief Top-K 示例
+ *  1. 沿用 lamba_test.cpp 中的比较 lambda，对 pair/tuple 记录求前K个；
+ *  2. 对“无界”数据流使用 top_k_heap 持续维护前K名；
+ *  3. 大数组上 std::sort / top_k / parallel_top_k 的耗时对比。
+ *
+ * 编译: g++ -std=c++14 -O2 -pthread top_k_test.cpp -o top_k_test
+ * @version : 1.0
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c), Richard Wang.
+ *
+ */
+
+#include <iostream>
+#include <algorithm>
+#include <chrono>
+#include <random>
+#include <string>
+#include <tuple>
+#include <vector>
+
+#include "top_k.hpp"
+
+/**
+ * @brief 对 pair / tuple 记录求 top-K
+ */
+void record_top_k_test()
+{
+    std::cout << "------------- test record top-k ------------------" << std::endl;
+    std::vector<std::pair<int, std::string>> info_list = {{12, "Mark"}, {17, "Jack"}, {11, "Jim"}, {14, "Rose"}};
+
+    /* 年龄最大的2个人 */
+    auto oldest = learning::top_k(info_list.begin(), info_list.end(), 2,
+                                  [](const std::pair<int, std::string> &a, const std::pair<int, std::string> &b) -> bool
+                                  { return a.first > b.first; });
+    for_each(oldest.begin(), oldest.end(), [](const std::pair<int, std::string> &p)
+             { std::cout << "Name: " << p.second << ", Age:" << p.first << std::endl; });
+
+    /* 身高最矮的1个人 */
+    std::vector<std::tuple<int, std::string, int>> userList = {
+        std::make_tuple(26, "Richard", 178), std::make_tuple(29, "Jack", 180), std::make_tuple(25, "Simth", 191)};
+    auto shortest = learning::top_k(userList.begin(), userList.end(), 1,
+                                    [](const std::tuple<int, std::string, int> &a, const std::tuple<int, std::string, int> &b)
+                                    { return std::get<2>(a) < std::get<2>(b); });
+    std::cout << "Shortest: " << std::get<1>(shortest[0]) << ", High: " << std::get<2>(shortest[0]) << std::endl;
+}
+
+/**
+ * @brief 数据流上持续维护 top-K
+ */
+void stream_top_k_test()
+{
+    std::cout << "------------- test stream top-k ------------------" << std::endl;
+    auto cmp = [](int a, int b) -> bool
+    { return a > b; };
+    learning::top_k_heap<int, decltype(cmp)> heap(5, cmp);
+
+    std::mt19937 rng(1);
+    for (int batch = 0; batch < 3; ++batch)
+    {
+        for (int i = 0; i < 100000; ++i)
+        {
+            heap.push(static_cast<int>(rng() % 1000000));
+        }
+        std::cout << "after batch " << batch << ", threshold: " << heap.threshold() << std::endl;
+    }
+
+    std::cout << "[Top 5]:";
+    for (int v : heap.take())
+    {
+        std::cout << v << " ";
+    }
+    std::cout << std::endl;
+}
+
+/**
+ * @brief 全排序与 top-K 的耗时对比
+ */
+void performance_test()
+{
+    std::cout << "------------- test performance ------------------" << std::endl;
+    std::mt19937 rng(2);
+    std::vector<unsigned> val_list(20000000);
+    for (auto &v : val_list)
+    {
+        v = rng();
+    }
+    auto cmp = [](unsigned a, unsigned b) -> bool
+    { return a > b; };
+
+    std::chrono::steady_clock::time_point t0 = std::chrono::steady_clock::now();
+    auto heap_result = learning::top_k(val_list.begin(), val_list.end(), 100, cmp);
+    std::chrono::steady_clock::time_point t1 = std::chrono::steady_clock::now();
+    auto buffer_result = learning::top_k(val_list.begin(), val_list.end(), 100000, cmp);
+    std::chrono::steady_clock::time_point t2 = std::chrono::steady_clock::now();
+    auto parallel_result = learning::parallel_top_k(val_list.begin(), val_list.end(), 100, cmp);
+    std::chrono::steady_clock::time_point t3 = std::chrono::steady_clock::now();
+    std::sort(val_list.begin(), val_list.end(), cmp);
+    std::chrono::steady_clock::time_point t4 = std::chrono::steady_clock::now();
+
+    auto ms = [](std::chrono::steady_clock::duration d)
+    { return std::chrono::duration_cast<std::chrono::milliseconds>(d).count(); };
+    std::cout << "top_k(k=100, heap)        : " << ms(t1 - t0) << " ms" << std::endl;
+    std::cout << "top_k(k=100000, select)   : " << ms(t2 - t1) << " ms" << std::endl;
+    std::cout << "parallel_top_k(k=100)     : " << ms(t3 - t2) << " ms" << std::endl;
+    std::cout << "std::sort                 : " << ms(t4 - t3) << " ms" << std::endl;
+    std::cout << "same result: "
+              << (std::equal(heap_result.begin(), heap_result.end(), val_list.begin()) &&
+                  std::equal(buffer_result.begin(), buffer_result.end(), val_list.begin()) &&
+                  std::equal(parallel_result.begin(), parallel_result.end(), val_list.begin()))
+              << std::endl;
+}
+
+int main()
+{
+    /*************** record_top_k_test() ************/
+    record_top_k_test();
+    /************************************************/
+
+    /*************** stream_top_k_test() ************/
+    stream_top_k_test();
+    /************************************************/
+
+    /**************** performance_test() ************/
+    performance_test();
+    /************************************************/
+
+    return 0;
+}
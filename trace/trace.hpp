@@ -0,0 +1,537 @@
+/**
+ * @file trace.hpp
+ * @author Richard Wang
+ * @brief 低开销的作用域追踪(trace span)与 Chrome trace-event 导出
+ *  1. 记录
+ *      TRACE_SPAN("parse") 在作用域开始和结束时各读一次时钟，结束时把 (开始, 结束, 名字指针) 写入本线程的环形缓冲区；
+ *      名字必须是字符串字面量等静态存储期的字符串，记录时只保存指针，不复制字符串。
+ *      写入只涉及本线程的缓冲区，没有锁也没有原子读改写，缓冲区写满后覆盖最旧的事件。
+ *  2. 时钟
+ *      x86 上使用 rdtsc(现代 CPU 的 TSC 频率恒定)，启动时用 steady_clock 校准每纳秒的 tick 数；
+ *      其他平台，或定义了 LEARNING_TRACE_STEADY_CLOCK 时使用 steady_clock。
+ *  3. 导出
+ *      trace_collector::write_binary() 把所有线程的事件写成紧凑的二进制文件(名字去重为字符串表)；
+ *      离线工具 trace_to_json 把它转换为 Chrome trace JSON，可直接用 chrome://tracing 或 ui.perfetto.dev 打开。
+ *      导出应在被追踪的线程停止写入之后进行(例如 join 之后)，否则正在写的事件可能不完整。
+ *
+ *  void parse(...)
+ *  {
+ *      TRACE_SPAN("parse");
+ *      ...
+ *  }
+ *  learning::trace_collector::instance().write_binary("run.trace");
+ * @version : 1.0
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c), Richard Wang.
+ *
+ */
+#ifndef TRACE_HPP
+#define TRACE_HPP
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+#if !defined(LEARNING_TRACE_STEADY_CLOCK) && (defined(__x86_64__) || defined(__i386__))
+#include <x86intrin.h>
+#define LEARNING_TRACE_TSC 1
+#endif
+
+namespace learning
+{
+
+/**
+ * @brief 追踪使用的时钟；now() 返回原始 tick
+ */
+struct trace_clock
+{
+    static uint64_t now()
+    {
+#if defined(LEARNING_TRACE_TSC)
+        return __rdtsc();
+#else
+        return static_cast<uint64_t>(std::chrono::steady_clock::now().time_since_epoch().count());
+#endif
+    }
+
+    /* 每纳秒的 tick 数；TSC 在第一次调用时用 steady_clock 校准约 20ms */
+    static double ticks_per_ns()
+    {
+#if defined(LEARNING_TRACE_TSC)
+        static const double ratio = calibrate();
+        return ratio;
+#else
+        return static_cast<double>(std::chrono::steady_clock::period::den) / std::chrono::steady_clock::period::num / 1e9;
+#endif
+    }
+
+private:
+#if defined(LEARNING_TRACE_TSC)
+    static double calibrate()
+    {
+        typedef std::chrono::steady_clock clock;
+        const clock::time_point t0 = clock::now();
+        const uint64_t c0 = __rdtsc();
+        clock::time_point t1 = t0;
+        while (t1 - t0 < std::chrono::milliseconds(20))
+        {
+            t1 = clock::now();
+        }
+        const uint64_t c1 = __rdtsc();
+        const double ns = static_cast<double>(std::chrono::duration_cast<std::chrono::nanoseconds>(t1 - t0).count());
+        return static_cast<double>(c1 - c0) / ns;
+    }
+#endif
+};
+
+/* 内存中的事件：24 字节 */
+struct trace_event
+{
+    uint64_t start;
+    uint64_t end;
+    const char *name;
+};
+
+/**
+ * @brief 单个线程的环形缓冲区；只有所属线程写入
+ */
+class trace_buffer
+{
+public:
+    trace_buffer(uint32_t tid, std::size_t capacity)
+        : tid_(tid), mask_(capacity - 1), events_(new trace_event[capacity]), written_(0)
+    {
+    }
+
+    void push(uint64_t start, uint64_t end, const char *name)
+    {
+        const uint64_t n = written_.load(std::memory_order_relaxed);
+        trace_event &e = events_[n & mask_];
+        e.start = start;
+        e.end = end;
+        e.name = name;
+        written_.store(n + 1, std::memory_order_release);
+    }
+
+    uint32_t tid() const { return tid_; }
+    std::size_t capacity() const { return mask_ + 1; }
+    uint64_t written() const { return written_.load(std::memory_order_acquire); }
+
+    /* 线程名(set_trace_thread_name 设置)，由所属线程在注册后写入 */
+    void set_name(const std::string &name)
+    {
+        std::lock_guard<std::mutex> lock(name_mutex_);
+        name_ = name;
+    }
+
+    std::string name() const
+    {
+        std::lock_guard<std::mutex> lock(name_mutex_);
+        return name_;
+    }
+
+    /* 按时间顺序复制仍在缓冲区中的事件 */
+    std::vector<trace_event> snapshot() const
+    {
+        const uint64_t n = written();
+        const uint64_t kept = n < capacity() ? n : capacity();
+        std::vector<trace_event> result;
+        result.reserve(static_cast<std::size_t>(kept));
+        for (uint64_t i = n - kept; i < n; ++i)
+        {
+            result.push_back(events_[i & mask_]);
+        }
+        return result;
+    }
+
+    void clear() { written_.store(0, std::memory_order_release); }
+
+private:
+    uint32_t tid_;
+    std::size_t mask_;
+    std::unique_ptr<trace_event[]> events_;
+    std::atomic<uint64_t> written_;
+    mutable std::mutex name_mutex_;
+    std::string name_;
+};
+
+/************************ 文件格式 ************************/
+/*
+ *  header   : "LTRC" uint32 版本(1) double ticks_per_ns uint64 基准 tick
+ *  strings  : uint32 个数，每项 uint32 长度 + 字节(编号即下标)
+ *  threads  : uint32 个数，每项 uint32 tid、uint32 名字长度 + 字节、uint64 事件数、
+ *             每个事件 uint64 开始 tick、uint64 结束 tick、uint32 名字编号
+ */
+
+/* 从文件读回的事件，时间已换算为相对基准的纳秒 */
+struct trace_record
+{
+    uint64_t start_ns;
+    uint64_t duration_ns;
+    uint32_t name_id;
+};
+
+struct trace_thread
+{
+    uint32_t tid;
+    std::string name;
+    std::vector<trace_record> records;
+};
+
+struct trace_file
+{
+    std::vector<std::string> names;
+    std::vector<trace_thread> threads;
+};
+
+namespace detail
+{
+
+template <class T>
+void write_pod(std::ostream &out, const T &v)
+{
+    out.write(reinterpret_cast<const char *>(&v), sizeof(v));
+}
+
+template <class T>
+T read_pod(std::istream &in)
+{
+    T v;
+    if (!in.read(reinterpret_cast<char *>(&v), sizeof(v)))
+    {
+        throw std::runtime_error("trace: truncated file");
+    }
+    return v;
+}
+
+inline void write_string(std::ostream &out, const std::string &s)
+{
+    write_pod(out, static_cast<uint32_t>(s.size()));
+    out.write(s.data(), static_cast<std::streamsize>(s.size()));
+}
+
+inline std::string read_string(std::istream &in)
+{
+    const uint32_t len = read_pod<uint32_t>(in);
+    std::string s(len, '\0');
+    if (len > 0 && !in.read(&s[0], len))
+    {
+        throw std::runtime_error("trace: truncated file");
+    }
+    return s;
+}
+
+/* JSON 字符串转义 */
+inline void write_json_string(std::ostream &out, const std::string &s)
+{
+    out << '"';
+    for (char c : s)
+    {
+        switch (c)
+        {
+        case '"':
+            out << "\\\"";
+            break;
+        case '\\':
+            out << "\\\\";
+            break;
+        case '\n':
+            out << "\\n";
+            break;
+        default:
+            if (static_cast<unsigned char>(c) < 0x20)
+            {
+                static const char hex[] = "0123456789abcdef";
+                out << "\\u00" << hex[(c >> 4) & 0xf] << hex[c & 0xf];
+            }
+            else
+            {
+                out << c;
+            }
+        }
+    }
+    out << '"';
+}
+
+/* 纳秒按微秒输出，保留 3 位小数 */
+inline void write_micros(std::ostream &out, uint64_t ns)
+{
+    const char digits[] = {'.', static_cast<char>('0' + ns / 100 % 10), static_cast<char>('0' + ns / 10 % 10),
+                           static_cast<char>('0' + ns % 10)};
+    out << ns / 1000;
+    out.write(digits, sizeof(digits));
+}
+
+} // namespace detail
+
+/**
+ * @brief 管理所有线程的缓冲区；线程退出后缓冲区仍保留，便于 join 之后导出
+ */
+class trace_collector
+{
+public:
+    static const std::size_t kDefaultCapacity = 1 << 16;
+
+    static trace_collector &instance()
+    {
+        static trace_collector collector;
+        return collector;
+    }
+
+    void enable() { enabled_.store(true, std::memory_order_relaxed); }
+    void disable() { enabled_.store(false, std::memory_order_relaxed); }
+    bool enabled() const { return enabled_.load(std::memory_order_relaxed); }
+
+    /* 之后新注册的线程使用的缓冲区大小(向上取 2 的幂) */
+    void set_capacity(std::size_t events)
+    {
+        std::size_t cap = 1;
+        while (cap < events)
+        {
+            cap <<= 1;
+        }
+        capacity_.store(cap, std::memory_order_relaxed);
+    }
+
+    /* 当前线程的缓冲区，第一次调用时注册 */
+    trace_buffer &local_buffer()
+    {
+        static thread_local trace_buffer *buffer = nullptr;
+        if (buffer == nullptr)
+        {
+            buffer = register_thread();
+        }
+        return *buffer;
+    }
+
+    /* 清空所有线程已记录的事件，并把当前时刻作为新的基准 */
+    void reset()
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (std::shared_ptr<trace_buffer> &b : buffers_)
+        {
+            b->clear();
+        }
+        base_ = trace_clock::now();
+    }
+
+    void write_binary(std::ostream &out) const
+    {
+        std::vector<std::shared_ptr<trace_buffer>> buffers;
+        uint64_t base;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            buffers = buffers_;
+            base = base_;
+        }
+
+        std::vector<std::vector<trace_event>> events;
+        std::map<const char *, uint32_t> ids;
+        std::vector<const char *> names;
+        for (const std::shared_ptr<trace_buffer> &b : buffers)
+        {
+            events.push_back(b->snapshot());
+            for (const trace_event &e : events.back())
+            {
+                if (ids.emplace(e.name, static_cast<uint32_t>(names.size())).second)
+                {
+                    names.push_back(e.name);
+                }
+            }
+        }
+
+        out.write("LTRC", 4);
+        detail::write_pod(out, static_cast<uint32_t>(1));
+        detail::write_pod(out, trace_clock::ticks_per_ns());
+        detail::write_pod(out, base);
+        detail::write_pod(out, static_cast<uint32_t>(names.size()));
+        for (const char *name : names)
+        {
+            detail::write_string(out, name);
+        }
+        detail::write_pod(out, static_cast<uint32_t>(buffers.size()));
+        for (std::size_t i = 0; i < buffers.size(); ++i)
+        {
+            detail::write_pod(out, buffers[i]->tid());
+            detail::write_string(out, buffers[i]->name());
+            detail::write_pod(out, static_cast<uint64_t>(events[i].size()));
+            for (const trace_event &e : events[i])
+            {
+                detail::write_pod(out, e.start);
+                detail::write_pod(out, e.end);
+                detail::write_pod(out, ids[e.name]);
+            }
+        }
+    }
+
+    /* 写入失败时抛出 std::runtime_error */
+    void write_binary(const std::string &path) const
+    {
+        std::ofstream out(path.c_str(), std::ios::binary);
+        write_binary(out);
+        if (!out)
+        {
+            throw std::runtime_error("trace: cannot write " + path);
+        }
+    }
+
+private:
+    trace_collector() : enabled_(true), capacity_(kDefaultCapacity), next_tid_(1), base_(trace_clock::now())
+    {
+        trace_clock::ticks_per_ns();
+    }
+
+    trace_buffer *register_thread()
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        buffers_.push_back(std::make_shared<trace_buffer>(next_tid_++, capacity_.load(std::memory_order_relaxed)));
+        return buffers_.back().get();
+    }
+
+    std::atomic<bool> enabled_;
+    std::atomic<std::size_t> capacity_;
+    mutable std::mutex mutex_;
+    std::vector<std::shared_ptr<trace_buffer>> buffers_;
+    uint32_t next_tid_;
+    uint64_t base_;
+};
+
+/**
+ * @brief 作用域追踪；追踪关闭时只有一次 relaxed 读
+ */
+class trace_span
+{
+public:
+    explicit trace_span(const char *name)
+        : name_(name), start_(trace_collector::instance().enabled() ? trace_clock::now() : 0)
+    {
+    }
+
+    ~trace_span()
+    {
+        if (start_ != 0)
+        {
+            trace_collector::instance().local_buffer().push(start_, trace_clock::now(), name_);
+        }
+    }
+
+    trace_span(const trace_span &) = delete;
+    trace_span &operator=(const trace_span &) = delete;
+
+private:
+    const char *name_;
+    uint64_t start_;
+};
+
+/* 设置当前线程在追踪视图中显示的名字 */
+inline void set_trace_thread_name(const std::string &name)
+{
+    trace_collector::instance().local_buffer().set_name(name);
+}
+
+#define LEARNING_TRACE_CONCAT_IMPL(a, b) a##b
+#define LEARNING_TRACE_CONCAT(a, b) LEARNING_TRACE_CONCAT_IMPL(a, b)
+#define TRACE_SPAN(name) ::learning::trace_span LEARNING_TRACE_CONCAT(learning_trace_span_, __LINE__)(name)
+
+/************************ 读取与转换 ************************/
+
+/**
+ * @brief 读取 write_binary 生成的文件；格式错误时抛出 std::runtime_error
+ */
+inline trace_file read_trace(std::istream &in)
+{
+    char magic[4];
+    if (!in.read(magic, 4) || std::memcmp(magic, "LTRC", 4) != 0)
+    {
+        throw std::runtime_error("trace: bad magic");
+    }
+    if (detail::read_pod<uint32_t>(in) != 1)
+    {
+        throw std::runtime_error("trace: unsupported version");
+    }
+    const double ticks_per_ns = detail::read_pod<double>(in);
+    const uint64_t base = detail::read_pod<uint64_t>(in);
+
+    trace_file file;
+    const uint32_t name_count = detail::read_pod<uint32_t>(in);
+    for (uint32_t i = 0; i < name_count; ++i)
+    {
+        file.names.push_back(detail::read_string(in));
+    }
+    const uint32_t thread_count = detail::read_pod<uint32_t>(in);
+    for (uint32_t t = 0; t < thread_count; ++t)
+    {
+        trace_thread thread;
+        thread.tid = detail::read_pod<uint32_t>(in);
+        thread.name = detail::read_string(in);
+        const uint64_t count = detail::read_pod<uint64_t>(in);
+        for (uint64_t i = 0; i < count; ++i)
+        {
+            const uint64_t start = detail::read_pod<uint64_t>(in);
+            const uint64_t end = detail::read_pod<uint64_t>(in);
+            const uint32_t name_id = detail::read_pod<uint32_t>(in);
+            if (name_id >= file.names.size())
+            {
+                throw std::runtime_error("trace: bad name id");
+            }
+            if (start < base || end < start)
+            {
+                continue; // reset() 之前的事件或时钟异常
+            }
+            trace_record r;
+            r.start_ns = static_cast<uint64_t>(static_cast<double>(start - base) / ticks_per_ns);
+            r.duration_ns = static_cast<uint64_t>(static_cast<double>(end - start) / ticks_per_ns);
+            r.name_id = name_id;
+            thread.records.push_back(r);
+        }
+        file.threads.push_back(std::move(thread));
+    }
+    return file;
+}
+
+/**
+ * @brief 输出 Chrome trace-event JSON(完整事件 "ph":"X"，时间单位微秒)
+ */
+inline void write_chrome_json(const trace_file &file, std::ostream &out)
+{
+    out << "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[\n";
+    bool first = true;
+    for (const trace_thread &thread : file.threads)
+    {
+        if (!thread.name.empty())
+        {
+            out << (first ? "" : ",\n") << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << thread.tid
+                << ",\"args\":{\"name\":";
+            detail::write_json_string(out, thread.name);
+            out << "}}";
+            first = false;
+        }
+        for (const trace_record &r : thread.records)
+        {
+            out << (first ? "" : ",\n") << "{\"name\":";
+            detail::write_json_string(out, file.names[r.name_id]);
+            out << ",\"ph\":\"X\",\"pid\":1,\"tid\":" << thread.tid << ",\"ts\":";
+            detail::write_micros(out, r.start_ns);
+            out << ",\"dur\":";
+            detail::write_micros(out, r.duration_ns);
+            out << "}";
+            first = false;
+        }
+    }
+    out << "\n]}\n";
+}
+
+} // namespace learning
+
+#endif // TRACE_HPP
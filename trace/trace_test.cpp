@@ -0,0 +1,137 @@
+/**
+ * @file trace_test.cpp
+ * @author Richard Wang
+ * @brief 追踪示例
+ *  1. 测量单个 span 的开销(开启 / 关闭追踪)；
+ *  2. 在 pipeline 的各个阶段中加入 TRACE_SPAN，sink 故意放慢，导出后可以看到上游阶段因反压而出现的空档；
+ *  3. 导出二进制文件，再读回并转换为 Chrome trace JSON(与离线工具 trace_to_json 相同)。
+ *
+ * 编译: g++ -std=c++14 -O2 -pthread trace_test.cpp -o trace_test
+ *       g++ -std=c++14 -O2 trace_to_json.cpp -o trace_to_json
+ * @version : 1.0
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c), Richard Wang.
+ *
+ */
+
+#include <iostream>
+#include <chrono>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <tuple>
+
+#include "../pipeline/pipeline.hpp"
+#include "trace.hpp"
+
+typedef std::tuple<int, std::string, std::string> info_t;
+
+/**
+ * @brief 空 span 的平均开销
+ */
+void overhead_test()
+{
+    std::cout << "------------- test overhead ------------------" << std::endl;
+    learning::trace_collector &collector = learning::trace_collector::instance();
+    const int n = 1000000;
+    for (int enabled = 1; enabled >= 0; --enabled)
+    {
+        enabled ? collector.enable() : collector.disable();
+        std::chrono::steady_clock::time_point begin = std::chrono::steady_clock::now();
+        for (int i = 0; i < n; ++i)
+        {
+            TRACE_SPAN("empty");
+        }
+        const double ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - begin).count();
+        std::cout << (enabled ? "enabled : " : "disabled: ") << ns / n << " ns/span" << std::endl;
+    }
+    collector.enable();
+    collector.reset();
+}
+
+/**
+ * @brief 带追踪的流水线
+ */
+void pipeline_test()
+{
+    std::cout << "------------- test traced pipeline ------------------" << std::endl;
+    learning::pipeline pl(64);
+    pl.source<std::string>("source", [](learning::emitter<std::string> &emit)
+                           {
+                               learning::set_trace_thread_name("source");
+                               for (int i = 0; i < 20000; ++i)
+                               {
+                                   std::ostringstream line;
+                                   {
+                                       TRACE_SPAN("format");
+                                       line << (i % 31 + 1) << ",Jun,China";
+                                   }
+                                   TRACE_SPAN("emit");
+                                   if (!emit(line.str()))
+                                   {
+                                       return;
+                                   }
+                               }
+                           })
+        .transform<info_t>("parse", 2, [](std::string &&line)
+                           {
+                               TRACE_SPAN("parse");
+                               std::istringstream in(line);
+                               std::string date, month, country;
+                               std::getline(in, date, ',');
+                               std::getline(in, month, ',');
+                               std::getline(in, country, ',');
+                               return info_t(std::stoi(date), month, country);
+                           })
+        .sink("sink", 1, [](info_t &&info)
+              {
+                  TRACE_SPAN("sink");
+                  volatile int spin = std::get<0>(info);
+                  for (int i = 0; i < 2000; ++i)
+                  {
+                      spin = spin + i;
+                  }
+              });
+    pl.run();
+    pl.report(std::cout);
+}
+
+/**
+ * @brief 导出并转换
+ */
+void export_test()
+{
+    std::cout << "------------- test export ------------------" << std::endl;
+    const std::string bin_path = "trace_test.trace";
+    const std::string json_path = "trace_test.json";
+    learning::trace_collector::instance().write_binary(bin_path);
+
+    std::ifstream in(bin_path.c_str(), std::ios::binary);
+    learning::trace_file file = learning::read_trace(in);
+    for (const learning::trace_thread &t : file.threads)
+    {
+        std::cout << "tid " << t.tid << " (" << (t.name.empty() ? "unnamed" : t.name) << "): " << t.records.size() << " events" << std::endl;
+    }
+
+    std::ofstream out(json_path.c_str());
+    learning::write_chrome_json(file, out);
+    std::cout << "wrote " << bin_path << " and " << json_path << ", open the json in chrome://tracing or ui.perfetto.dev" << std::endl;
+}
+
+int main()
+{
+    /******************* overhead_test() ************/
+    overhead_test();
+    /************************************************/
+
+    /******************* pipeline_test() ************/
+    pipeline_test();
+    /************************************************/
+
+    /******************** export_test() *************/
+    export_test();
+    /************************************************/
+
+    return 0;
+}
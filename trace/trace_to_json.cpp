@@ -0,0 +1,66 @@
+/**
+ * @file trace_to_json.cpp
+ * @author Richard Wang
+ * @brief 离线转换工具：把 trace_collector::write_binary() 生成的二进制追踪文件转换为 Chrome trace JSON
+ *  结果可以在 chrome://tracing 或 https://ui.perfetto.dev 中打开。
+ *
+ * 编译: g++ -std=c++14 -O2 trace_to_json.cpp -o trace_to_json
+ * 用法: trace_to_json input.trace [output.json]    (省略输出文件时写到标准输出)
+ * @version : 1.0
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c), Richard Wang.
+ *
+ */
+
+#include <iostream>
+#include <exception>
+#include <fstream>
+
+#include "trace.hpp"
+
+int main(int argc, char *argv[])
+{
+    if (argc < 2 || argc > 3)
+    {
+        std::cerr << "usage: " << argv[0] << " input.trace [output.json]" << std::endl;
+        return 2;
+    }
+    try
+    {
+        std::ifstream in(argv[1], std::ios::binary);
+        if (!in)
+        {
+            std::cerr << "cannot open " << argv[1] << std::endl;
+            return 1;
+        }
+        learning::trace_file file = learning::read_trace(in);
+
+        std::size_t events = 0;
+        for (const learning::trace_thread &t : file.threads)
+        {
+            events += t.records.size();
+        }
+        if (argc == 3)
+        {
+            std::ofstream out(argv[2]);
+            learning::write_chrome_json(file, out);
+            if (!out)
+            {
+                std::cerr << "cannot write " << argv[2] << std::endl;
+                return 1;
+            }
+            std::cerr << file.threads.size() << " threads, " << events << " events -> " << argv[2] << std::endl;
+        }
+        else
+        {
+            learning::write_chrome_json(file, std::cout);
+        }
+    }
+    catch (const std::exception &e)
+    {
+        std::cerr << "error: " << e.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}